@@ -2,28 +2,51 @@
 #include "bsp_audio.h"
 																										#include "stm32f4xx_ll_dma.h"
 
-const uint32_t I2SFreq[3] = {44100, 48000, 96000};
+// Sampling frequencies and PLLI2S settings, generated by tools/i2s_pll
+#include "bsp_audio_clk.h"
 
-#if defined(STM32F411xE) && defined(USE_MCLK_OUT) // Makefile compile flag
+I2S_HandleTypeDef  haudio_i2s;
+DMA_HandleTypeDef hdma_i2sTx;
 
-const I2S_CLK_CONFIG I2S_Clk_Config24[3]  = {
-{271, 2, 6, 0, 0x0B06EAB0}, // 44.1081
-{258, 3, 3, 1, 0x0BFF6DB2}, // 47.9911
-{344, 2, 3, 1, 0x17FEDB64}  // 95.9821
-};
+// DMA read position estimator, see BSP_AUDIO_OUT_GetPlayPosition.
+// The DMA and OTG interrupts have the same priority, so the SOF handler never sees a half updated event.
+static uint32_t dma_size_hw;            // circular buffer size, halfwords
+static volatile uint32_t dma_evt_cyc;   // DWT cycle count at the last half / full transfer event
+static volatile uint32_t dma_evt_hw;    // DMA position of that event, halfwords
+static volatile uint32_t dma_rate;      // halfwords Q8 per DWT cycle, Q24. 0 = not measured yet
+static void DMA_PositionEvent(uint32_t pos_hw);
+
+// Frequency PLLI2S is configured for, 0 = not configured by BSP_AUDIO_OUT_ClockConfig yet
+static uint32_t clk_freq = 0;
+
+// Sampling frequency switch, see BSP_AUDIO_OUT_Switch. Register images are computed by BSP_AUDIO_OUT_Init.
+typedef struct {
+	uint32_t pllcfgr;   // RCC PLLI2SCFGR
+	uint32_t i2spr;     // SPI I2SPR
+	} I2S_SWITCH_REGS;
+
+#define SW_IDLE     0U  // no switch, the HAL starts the transmit
+#define SW_STOP     1U  // waiting for the DMA stream and the I2S to stop
+#define SW_CLOCK    2U  // waiting for PLLI2S to stop
+#define SW_LOCK     3U  // waiting for the PLLI2S lock
+#define SW_READY    4U  // clock locked and DMA ring armed, BSP_AUDIO_OUT_Play enables the I2S
 
+#ifdef STM32F411xE
+#define SW_PLLI2SCFGR_MASK  (RCC_PLLI2SCFGR_PLLI2SM | RCC_PLLI2SCFGR_PLLI2SN | RCC_PLLI2SCFGR_PLLI2SR)
 #else
-
-const I2S_CLK_CONFIG I2S_Clk_Config24[3]  = {
-{429, 4, 19, 0, 0x0B065E56}, // 44.0995  
-{384, 5, 12, 1, 0x0C000000}, // 48.0000  
-{424, 3, 11, 1, 0x1800ED70}  // 96.0144  
-};
-
+// F401 PLLI2S uses the main PLL input divider
+#define SW_PLLI2SCFGR_MASK  (RCC_PLLI2SCFGR_PLLI2SN | RCC_PLLI2SCFGR_PLLI2SR)
 #endif
 
-I2S_HandleTypeDef  haudio_i2s;
-DMA_HandleTypeDef hdma_i2sTx;
+static I2S_SWITCH_REGS sw_regs[I2S_FREQ_NUM];
+static uint32_t sw_i2scfgr;             // SPI I2SCFGR without I2SE, the same for all frequencies
+static uint32_t sw_dma_cr;              // DMA stream CR without EN
+static volatile uint32_t sw_state = SW_IDLE;
+static uint32_t sw_index;
+static uint32_t* sw_buf;
+static uint32_t sw_size;
+static void Switch_Init(void);
+static uint32_t I2S_PrescalerReg(const I2S_CLK_CONFIG* pConfig);
 
 
 static void I2Sx_Init(uint32_t AudioFreq);
@@ -40,13 +63,18 @@ void BSP_AUDIO_OUT_ChangeAudioConfig(uint32_t AudioOutOption);
   */
 uint8_t BSP_AUDIO_OUT_Init(int16_t volume, uint32_t audioFreq, uint8_t options) {
 	I2Sx_DeInit();
-	BSP_AUDIO_OUT_ClockConfig(&haudio_i2s, audioFreq, NULL);
+	// waiting for the PLLI2S lock is most of the restart time, skip it if the frequency is unchanged
+	if (audioFreq != clk_freq) {
+		BSP_AUDIO_OUT_ClockConfig(&haudio_i2s, audioFreq, NULL);
+		clk_freq = audioFreq;
+		}
 
 	haudio_i2s.Instance = AUDIO_I2Sx;
 	if(HAL_I2S_GetState(&haudio_i2s) == HAL_I2S_STATE_RESET) {
 		BSP_AUDIO_OUT_MspInit(&haudio_i2s, NULL);
 		}
 	I2Sx_Init(audioFreq);
+	Switch_Init();
 	if (options){
 		AUDIO_MUTE_ON();
 		}
@@ -58,6 +86,110 @@ uint8_t BSP_AUDIO_OUT_Init(int16_t volume, uint32_t audioFreq, uint8_t options)
 	}
 
 
+/**
+  * @brief  Starts a sampling frequency switch of a playing stream without the HAL and without waiting.
+  *         The DMA requests and the DMA stream are stopped here. BSP_AUDIO_OUT_ClockReady disables the
+  *         I2S once its last word is sent, reconfigures PLLI2S only if the new frequency needs other
+  *         PLL settings, loads the precomputed register images, re-arms the DMA ring at the start of
+  *         pBuffer and polls the PLL lock. BSP_AUDIO_OUT_Play then enables the I2S.
+  * @param  AudioFreq: new audio frequency
+  * @param  pBuffer: Pointer to PCM samples buffer, one 32bit word per channel
+  * @param  Size: number of bytes.
+  * @retval AUDIO_OK, AUDIO_ERROR if the frequency is not supported
+  */
+uint8_t BSP_AUDIO_OUT_Switch(uint32_t AudioFreq, uint32_t* pBuffer, uint32_t Size) {
+	int freqindex = BSP_AUDIO_OUT_GetFreqIndex(AudioFreq);
+	if (freqindex < 0) {
+		return AUDIO_ERROR;
+		}
+	AUDIO_MUTE_ON();
+	CLEAR_BIT(AUDIO_I2Sx->CR2, SPI_CR2_TXDMAEN);
+	CLEAR_BIT(AUDIO_I2Sx_DMAx_STREAM->CR, DMA_SxCR_EN);
+	sw_index = (uint32_t)freqindex;
+	sw_buf = pBuffer;
+	sw_size = Size;
+	clk_freq = AudioFreq;
+	sw_state = SW_STOP;
+	// the I2S usually has sent its last word by the time the stream is stopped
+	BSP_AUDIO_OUT_ClockReady();
+	return AUDIO_OK;
+	}
+
+
+/**
+  * @brief  Advances a frequency switch started by BSP_AUDIO_OUT_Switch, never waits.
+  * @retval 1 if the I2S clock is ready for BSP_AUDIO_OUT_Play, 0 while the I2S or PLLI2S is stopping
+  *         or PLLI2S is locking
+  */
+uint8_t BSP_AUDIO_OUT_ClockReady(void) {
+	switch (sw_state) {
+		case SW_STOP:
+			// a half-word left in the data register would be sent first after the restart and swap the channels
+			if (READ_BIT(AUDIO_I2Sx_DMAx_STREAM->CR, DMA_SxCR_EN) ||
+			    !READ_BIT(AUDIO_I2Sx->SR, SPI_SR_TXE) || READ_BIT(AUDIO_I2Sx->SR, SPI_SR_BSY)) {
+				return 0;
+				}
+			AUDIO_I2Sx->I2SCFGR = sw_i2scfgr;
+			if ((RCC->PLLI2SCFGR & SW_PLLI2SCFGR_MASK) != sw_regs[sw_index].pllcfgr) {
+				__HAL_RCC_PLLI2S_DISABLE();
+				}
+			sw_state = SW_CLOCK;
+			// fall through
+		case SW_CLOCK:
+			if (!READ_BIT(RCC->CR, RCC_CR_PLLI2SON)) {
+				if (__HAL_RCC_GET_FLAG(RCC_FLAG_PLLI2SRDY) != RESET) {
+					return 0;
+					}
+				MODIFY_REG(RCC->PLLI2SCFGR, SW_PLLI2SCFGR_MASK, sw_regs[sw_index].pllcfgr);
+				__HAL_RCC_PLLI2S_ENABLE();
+				}
+			AUDIO_I2Sx->I2SPR = sw_regs[sw_index].i2spr;
+			// re-arm the circular DMA at the start of the buffer, the interrupt enables are in the CR image
+			LL_DMA_ClearFlag_HT4(DMA1);
+			LL_DMA_ClearFlag_TC4(DMA1);
+			LL_DMA_ClearFlag_TE4(DMA1);
+			LL_DMA_ClearFlag_DME4(DMA1);
+			LL_DMA_ClearFlag_FE4(DMA1);
+			LL_DMA_WriteReg(AUDIO_I2Sx_DMAx_STREAM, NDTR, sw_size/2); // halfwords
+			LL_DMA_WriteReg(AUDIO_I2Sx_DMAx_STREAM, M0AR, (uint32_t)sw_buf);
+			LL_DMA_WriteReg(AUDIO_I2Sx_DMAx_STREAM, CR, sw_dma_cr | DMA_SxCR_EN);
+			// the first word is loaded into the data register as with HAL_I2S_Transmit_DMA
+			SET_BIT(AUDIO_I2Sx->CR2, SPI_CR2_TXDMAEN);
+			sw_state = SW_LOCK;
+			// fall through
+		case SW_LOCK:
+			if (__HAL_RCC_GET_FLAG(RCC_FLAG_PLLI2SRDY) == RESET) {
+				return 0;
+				}
+			sw_state = SW_READY;
+			return 1;
+
+		default:
+			return 1;
+		}
+	}
+
+
+// Register images for BSP_AUDIO_OUT_Switch, from the clock table and the HAL I2S and DMA configuration
+static void Switch_Init(void) {
+	for (int index = 0; index < I2S_FREQ_NUM; index++) {
+		const I2S_CLK_CONFIG* pConfig = &I2S_Clk_Config24[index];
+		sw_regs[index].pllcfgr = (pConfig->N << RCC_PLLI2SCFGR_PLLI2SN_Pos) | (pConfig->R << RCC_PLLI2SCFGR_PLLI2SR_Pos);
+#ifdef STM32F411xE
+		sw_regs[index].pllcfgr |= pConfig->M << RCC_PLLI2SCFGR_PLLI2SM_Pos;
+#endif
+		sw_regs[index].i2spr = I2S_PrescalerReg(pConfig);
+		}
+	sw_i2scfgr = SPI_I2SCFGR_I2SMOD | haudio_i2s.Init.Mode | haudio_i2s.Init.Standard |
+	             haudio_i2s.Init.DataFormat | haudio_i2s.Init.CPOL;
+	sw_dma_cr = hdma_i2sTx.Init.Channel | hdma_i2sTx.Init.Direction | hdma_i2sTx.Init.PeriphInc |
+	            hdma_i2sTx.Init.MemInc | hdma_i2sTx.Init.PeriphDataAlignment | hdma_i2sTx.Init.MemDataAlignment |
+	            hdma_i2sTx.Init.Mode | hdma_i2sTx.Init.Priority | hdma_i2sTx.Init.MemBurst | hdma_i2sTx.Init.PeriphBurst |
+	            DMA_IT_TC | DMA_IT_HT | DMA_IT_TE | DMA_IT_DME;
+	sw_state = SW_IDLE;
+	}
+
+
 
 /**
   * @brief  De-initialize the audio peripherals.
@@ -71,17 +203,30 @@ void BSP_AUDIO_OUT_DeInit(void) {
 
 /**
   * @brief  Starts playing audio stream from a data buffer for a determined size.
-  * @param  pBuffer: Pointer to PCM samples buffer
+  * @param  pBuffer: Pointer to PCM samples buffer, one 32bit word per channel
   * @param  Size: number of bytes.
   * @retval AUDIO_OK if correct communication, else wrong communication
   */
-uint8_t BSP_AUDIO_OUT_Play(uint16_t* pBuffer, uint32_t Size) {
+uint8_t BSP_AUDIO_OUT_Play(uint32_t* pBuffer, uint32_t Size) {
 	uint8_t ret = AUDIO_OK;
 	AUDIO_MUTE_OFF();
-	// I2s transmit of 24bit data requires number of words
-	if (HAL_I2S_Transmit_DMA(&haudio_i2s, pBuffer, Size/4) != HAL_OK)    {
-		ret = AUDIO_ERROR;
-    	}
+	CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+	DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+	dma_size_hw = Size/2;
+	dma_rate = 0;
+	dma_evt_hw = 0xFFFFFFFFU; // the first event only gives the start time
+	dma_evt_cyc = DWT->CYCCNT;
+	if (sw_state == SW_READY) {
+		// after BSP_AUDIO_OUT_Switch the DMA ring is armed at pBuffer, the I2S requests the first word
+		sw_state = SW_IDLE;
+		AUDIO_I2Sx->I2SCFGR = sw_i2scfgr | SPI_I2SCFGR_I2SE;
+		}
+	else {
+		// I2s transmit of 24bit data requires number of words
+		if (HAL_I2S_Transmit_DMA(&haudio_i2s, (uint16_t*)pBuffer, Size/4) != HAL_OK) {
+			ret = AUDIO_ERROR;
+			}
+		}
 	return ret;
 	}
 
@@ -91,9 +236,9 @@ uint8_t BSP_AUDIO_OUT_Play(uint16_t* pBuffer, uint32_t Size) {
   * @param  pData: pointer to PCM samples buffer 
   * @param  Size: number of bytes to be written
   */
-void BSP_AUDIO_OUT_ChangeBuffer(uint16_t *pData, uint16_t Size){
+void BSP_AUDIO_OUT_ChangeBuffer(uint32_t *pData, uint16_t Size){
 	// I2s transmit of 24bit data requires number of words
-	HAL_I2S_Transmit_DMA(&haudio_i2s, pData, Size/4 );
+	HAL_I2S_Transmit_DMA(&haudio_i2s, (uint16_t*)pData, Size/4 );
 	}
 
 
@@ -139,6 +284,11 @@ uint8_t BSP_AUDIO_OUT_Resume(void) {
   */
 uint8_t BSP_AUDIO_OUT_Stop(void) {
 	uint8_t ret = AUDIO_OK;
+	if (sw_state != SW_IDLE) {
+		// switch abandoned, PLLI2S may be stopped : the next BSP_AUDIO_OUT_Init configures it
+		sw_state = SW_IDLE;
+		clk_freq = 0;
+		}
 	if (HAL_I2S_DMAStop(&haudio_i2s) != HAL_OK)    {
 		ret = AUDIO_ERROR;
     	}
@@ -183,10 +333,73 @@ uint8_t BSP_AUDIO_OUT_SetMute(uint8_t mute) {
   */
 void BSP_AUDIO_OUT_SetFrequency(uint32_t AudioFreq){ 
   BSP_AUDIO_OUT_ClockConfig(&haudio_i2s, AudioFreq, NULL);
+  clk_freq = AudioFreq;
   I2Sx_Init(AudioFreq);
 }
 
 
+/**
+  * @brief  Finds the I2S clock configuration of a sampling frequency.
+  * @param  AudioFreq: Audio frequency in Hz
+  * @retval Index in I2SFreq and I2S_Clk_Config24, -1 if the frequency is not supported
+  */
+int BSP_AUDIO_OUT_GetFreqIndex(uint32_t AudioFreq) {
+	for (int index = 0; index < I2S_FREQ_NUM; index++) {
+		if (I2SFreq[index] == AudioFreq) {
+			return index;
+			}
+		}
+	return -1;
+	}
+
+
+/**
+  * @brief  Starts the SOF timer. It counts the timer clock and captures the count on every
+  *         USB OTG FS SOF. The timer clock and PLLI2S are both derived from HSE, so the timer
+  *         ticks per USB frame measure the crystal error relative to the host clock.
+  * @retval Timer clock in kHz
+  */
+uint32_t BSP_AUDIO_OUT_SofTimerInit(void) {
+	AUDIO_SOF_TIMx_CLK_ENABLE();
+	AUDIO_SOF_TIMx->CR1 = 0;
+	AUDIO_SOF_TIMx->PSC = 0;
+	AUDIO_SOF_TIMx->ARR = 0xFFFFFFFFU;
+	AUDIO_SOF_TIMx->OR = TIM_OR_ITR1_RMP_1; // ITR1 = OTG FS SOF
+	AUDIO_SOF_TIMx->SMCR = TIM_SMCR_TS_0; // trigger input ITR1, slave mode disabled so the counter runs on the internal clock
+	AUDIO_SOF_TIMx->CCMR1 = TIM_CCMR1_CC1S_0 | TIM_CCMR1_CC1S_1; // IC1 mapped on TRC
+	AUDIO_SOF_TIMx->CCER = TIM_CCER_CC1E; // capture on the rising edge
+	AUDIO_SOF_TIMx->EGR = TIM_EGR_UG;
+	AUDIO_SOF_TIMx->CR1 = TIM_CR1_CEN;
+	// SOF pulse output, PA8 is not configured as OTG_FS_SOF so this only feeds the timer
+	USB_OTG_FS->GCCFG |= USB_OTG_GCCFG_SOFOUTEN;
+
+	// APB1 timer clock is twice PCLK1 when the APB1 prescaler is not 1
+	uint32_t clk = HAL_RCC_GetPCLK1Freq();
+	if ((RCC->CFGR & RCC_CFGR_PPRE1) != RCC_CFGR_PPRE1_DIV1) {
+		clk *= 2U;
+		}
+	return clk / 1000U;
+	}
+
+
+/**
+  * @brief  Stops the SOF timer.
+  */
+void BSP_AUDIO_OUT_SofTimerDeInit(void) {
+	AUDIO_SOF_TIMx->CR1 = 0;
+	USB_OTG_FS->GCCFG &= ~USB_OTG_GCCFG_SOFOUTEN;
+	AUDIO_SOF_TIMx_CLK_DISABLE();
+	}
+
+
+/**
+  * @brief  Timer count captured at the last SOF.
+  */
+uint32_t BSP_AUDIO_OUT_SofTimerCapture(void) {
+	return AUDIO_SOF_TIMx->CCR1;
+	}
+
+
 /**
   * @brief  Changes the Audio Out Configuration.
   * @param  AudioOutOption: specifies the audio out new configuration
@@ -210,18 +423,56 @@ void BSP_AUDIO_OUT_ChangeAudioConfig(uint32_t AudioOutOption) {
 
 /**
  * @brief  Get size of remaining audio data to be transmitted.
- * @see
+ * @retval number of 32bit buffer words. NDTR counts in peripheral (halfword) units.
  */
 uint32_t BSP_AUDIO_OUT_GetRemainingDataSize(void){
-  return LL_DMA_ReadReg(AUDIO_I2Sx_DMAx_STREAM, NDTR) & 0xFFFF;
+  return (LL_DMA_ReadReg(AUDIO_I2Sx_DMAx_STREAM, NDTR) & 0xFFFF) >> 1;
 }
 
 
+/**
+ * @brief  DMA read position with a fraction of a halfword, interpolated at the time of the call from the
+ *         last half / full transfer event with the DWT cycle counter. The estimate is kept within the
+ *         halfword NDTR reports, so it is never worse than GetRemainingDataSize. Until the DMA rate has
+ *         been measured over one half buffer, or if the estimate is off by more than a halfword (missed
+ *         event), the NDTR position is returned.
+ * @retval read position in 32bit buffer words, Q8
+ */
+uint32_t BSP_AUDIO_OUT_GetPlayPosition(void) {
+	uint32_t cyc = DWT->CYCCNT;
+	uint32_t ndtr = LL_DMA_ReadReg(AUDIO_I2Sx_DMAx_STREAM, NDTR) & 0xFFFF;
+	uint32_t size_q8 = dma_size_hw << 8;
+	uint32_t pos_q8 = (dma_size_hw - ndtr) << 8;
+	if (dma_rate != 0U) {
+		uint32_t est_q8 = (dma_evt_hw << 8) + (uint32_t)(((uint64_t)(cyc - dma_evt_cyc) * dma_rate) >> 24);
+		int32_t d = (int32_t)((est_q8 + size_q8 - pos_q8) % size_q8);
+		if (d > (int32_t)(size_q8/2)) d -= (int32_t)size_q8;
+		if (d > -256 && d < 512) {
+			pos_q8 += (d < 0) ? 0 : ((d > 255) ? 255 : (uint32_t)d);
+			}
+		}
+	return (pos_q8 % size_q8) >> 1;
+	}
+
+
+static void DMA_PositionEvent(uint32_t pos_hw) {
+	uint32_t cyc = DWT->CYCCNT;
+	uint32_t half_cyc = cyc - dma_evt_cyc;
+	// rate over the last half buffer, skipped if an event was missed
+	if (dma_evt_hw != 0xFFFFFFFFU && dma_evt_hw != pos_hw && half_cyc != 0U) {
+		dma_rate = (uint32_t)(((uint64_t)(dma_size_hw/2) << 32) / half_cyc);
+		}
+	dma_evt_cyc = cyc;
+	dma_evt_hw = pos_hw;
+	}
+
+
 /**
   * @brief Tx Transfer completed callbacks
   * @param hi2s: I2S handle
   */
 void HAL_I2S_TxCpltCallback(I2S_HandleTypeDef *hi2s){
+  DMA_PositionEvent(0U);
   /* Manage the remaining file size and new address offset: This function 
      should be coded by user (its prototype is already declared in stm324xg_eval_audio.h) */  
   BSP_AUDIO_OUT_TransferComplete_CallBack();       
@@ -233,6 +484,7 @@ void HAL_I2S_TxCpltCallback(I2S_HandleTypeDef *hi2s){
   * @param hi2s: I2S handle
   */
 void HAL_I2S_TxHalfCpltCallback(I2S_HandleTypeDef *hi2s){
+  DMA_PositionEvent(dma_size_hw/2);
   /* Manage the remaining file size and new address offset: This function 
      should be coded by user (its prototype is already declared in stm324xg_eval_audio.h) */  
   BSP_AUDIO_OUT_HalfTransfer_CallBack();   
@@ -318,8 +570,8 @@ __weak void BSP_AUDIO_OUT_MspInit(I2S_HandleTypeDef *hi2s, void *Params)
     hdma_i2sTx.Init.Direction           = DMA_MEMORY_TO_PERIPH;
     hdma_i2sTx.Init.PeriphInc           = DMA_PINC_DISABLE;
     hdma_i2sTx.Init.MemInc              = DMA_MINC_ENABLE;
-    hdma_i2sTx.Init.PeriphDataAlignment = DMA_PDATAALIGN_HALFWORD; // I2S peripheral data register is 16bits
-    hdma_i2sTx.Init.MemDataAlignment    = DMA_MDATAALIGN_HALFWORD;
+    hdma_i2sTx.Init.PeriphDataAlignment = AUDIO_I2Sx_DMAx_PERIPH_DATA_SIZE; // I2S peripheral data register is 16bits
+    hdma_i2sTx.Init.MemDataAlignment    = AUDIO_I2Sx_DMAx_MEM_DATA_SIZE;    // 32bit buffer words, unpacked by the FIFO
     hdma_i2sTx.Init.Mode                = DMA_CIRCULAR;
     hdma_i2sTx.Init.Priority            = DMA_PRIORITY_HIGH;
     hdma_i2sTx.Init.FIFOMode            = DMA_FIFOMODE_ENABLE;         
@@ -376,14 +628,7 @@ __weak void BSP_AUDIO_OUT_MspDeInit(I2S_HandleTypeDef *hi2s, void *Params)
   */
 __weak void BSP_AUDIO_OUT_ClockConfig(I2S_HandleTypeDef *hi2s, uint32_t AudioFreq, void *Params) {
   RCC_PeriphCLKInitTypeDef RCC_ExCLKInitStruct;
-  int index = 0, freqindex = -1;
-  
-  for(index = 0; index < 3; index++)  {
-	  if (I2SFreq[index] == AudioFreq) {
-		  freqindex = index;
-		  break;
-	  	  }
-  	  }
+  int freqindex = BSP_AUDIO_OUT_GetFreqIndex(AudioFreq);
   uint32_t N, R, I2SDIV, ODD, I2S_PR;
 #ifdef STM32F411xE
   uint32_t MCKOE;
@@ -397,47 +642,39 @@ __weak void BSP_AUDIO_OUT_ClockConfig(I2S_HandleTypeDef *hi2s, uint32_t AudioFre
     // I2SCLK = f(PLLI2S clock output) = f(VCO clock) / PLLI2SR
 
   HAL_RCCEx_GetPeriphCLKConfig(&RCC_ExCLKInitStruct); 
-  if (freqindex != -1)  {
-    N = I2S_Clk_Config24[freqindex].N;
-    R = I2S_Clk_Config24[freqindex].R;
-    I2SDIV = I2S_Clk_Config24[freqindex].I2SDIV;
-    ODD = I2S_Clk_Config24[freqindex].ODD;
-
-    RCC_ExCLKInitStruct.PeriphClockSelection = RCC_PERIPHCLK_I2S;
+  if (freqindex == -1)  { // Default PLL I2S configuration for 96000 Hz 24bit
+    freqindex = I2S_FREQ_INDEX_DEFAULT;
+    }
+  N = I2S_Clk_Config24[freqindex].N;
+  R = I2S_Clk_Config24[freqindex].R;
+  I2SDIV = I2S_Clk_Config24[freqindex].I2SDIV;
+  ODD = I2S_Clk_Config24[freqindex].ODD;
+
+  RCC_ExCLKInitStruct.PeriphClockSelection = RCC_PERIPHCLK_I2S;
 #ifdef STM32F411xE
-    RCC_ExCLKInitStruct.PLLI2S.PLLI2SM = 25;
+  // F411 PLLI2S has its own input divider, F401 uses the main PLL divider (25)
+  RCC_ExCLKInitStruct.PLLI2S.PLLI2SM = I2S_Clk_Config24[freqindex].M;
 #endif
-    RCC_ExCLKInitStruct.PLLI2S.PLLI2SN = N;  
-    RCC_ExCLKInitStruct.PLLI2S.PLLI2SR = R;  
-    HAL_RCCEx_PeriphCLKConfig(&RCC_ExCLKInitStruct);     
+  RCC_ExCLKInitStruct.PLLI2S.PLLI2SN = N;
+  RCC_ExCLKInitStruct.PLLI2S.PLLI2SR = R;
+  HAL_RCCEx_PeriphCLKConfig(&RCC_ExCLKInitStruct);
 #ifdef STM32F411xE
-    I2S_PR = (MCKOE<<9) | (ODD<<8) | I2SDIV;
+  I2S_PR = (MCKOE<<9) | (ODD<<8) | I2SDIV;
 #else
-    I2S_PR = (ODD<<8) | I2SDIV;
+  I2S_PR = (ODD<<8) | I2SDIV;
 #endif
-    I2S_Config_I2SPR(I2S_PR);
-    } 
-  else { // Default PLL I2S configuration for 96000 Hz 24bit
-    N = I2S_Clk_Config24[2].N;
-    R = I2S_Clk_Config24[2].R;
-    I2SDIV = I2S_Clk_Config24[2].I2SDIV;
-    ODD = I2S_Clk_Config24[2].ODD;
-
-    RCC_ExCLKInitStruct.PeriphClockSelection = RCC_PERIPHCLK_I2S;
-#ifdef STM32F411xE
-    RCC_ExCLKInitStruct.PLLI2S.PLLI2SM = 25;
-#endif
-    RCC_ExCLKInitStruct.PLLI2S.PLLI2SN = N;
-    RCC_ExCLKInitStruct.PLLI2S.PLLI2SR = R;
-    HAL_RCCEx_PeriphCLKConfig(&RCC_ExCLKInitStruct); 
-#ifdef STM32F411xE
-    I2S_PR = (MCKOE<<9) | (ODD<<8) | I2SDIV;
+  I2S_Config_I2SPR(I2S_PR);
+}
+
+
+// I2SPR value of a clock table entry, as BSP_AUDIO_OUT_ClockConfig
+static uint32_t I2S_PrescalerReg(const I2S_CLK_CONFIG* pConfig) {
+#if defined(STM32F411xE) && defined(USE_MCLK_OUT)
+	return SPI_I2SPR_MCKOE | (pConfig->ODD << 8) | pConfig->I2SDIV;
 #else
-    I2S_PR = (ODD<<8) | I2SDIV;
+	return (pConfig->ODD << 8) | pConfig->I2SDIV;
 #endif
-    I2S_Config_I2SPR(I2S_PR);
-  }
-}
+	}
 
 
 static HAL_StatusTypeDef I2S_Config_I2SPR(uint32_t regVal) {
@@ -12,6 +12,7 @@
 
 
 typedef struct I2S_CLK_CONFIG_ {
+	uint32_t M;
 	uint32_t N;
 	uint32_t R;
 	uint32_t I2SDIV;
@@ -19,6 +20,11 @@ typedef struct I2S_CLK_CONFIG_ {
 	uint32_t nominal_fdbk;
 } I2S_CLK_CONFIG;
 
+// Supported sampling frequencies, index of each one in I2SFreq and I2S_Clk_Config24
+#define I2S_FREQ_NUM                    7
+#define I2S_FREQ_INDEX_DEFAULT          4 // 96000Hz
+
+extern const uint32_t I2SFreq[];
 extern const I2S_CLK_CONFIG I2S_Clk_Config24[];
 
 #define BSP_AUDIO_OUT_CIRCULARMODE      ((uint32_t)0x00000001) /* BUFFER CIRCULAR MODE */
@@ -59,13 +65,18 @@ extern const I2S_CLK_CONFIG I2S_Clk_Config24[];
 #define AUDIO_I2Sx_DMAx_CHANNEL             DMA_CHANNEL_0
 #define AUDIO_I2Sx_DMAx_IRQ                 DMA1_Stream4_IRQn
 #define AUDIO_I2Sx_DMAx_PERIPH_DATA_SIZE    DMA_PDATAALIGN_HALFWORD
-#define AUDIO_I2Sx_DMAx_MEM_DATA_SIZE       DMA_MDATAALIGN_HALFWORD
+#define AUDIO_I2Sx_DMAx_MEM_DATA_SIZE       DMA_MDATAALIGN_WORD
 #define DMA_MAX_SZE                         0xFFFF
    
 #define AUDIO_I2Sx_DMAx_IRQHandler          DMA1_Stream4_IRQHandler
 
 #define AUDIO_IRQ_PREPRIO           	5   // DMA int preemption priority level(0 is the highest)
 
+/* SOF timer : counts the timer clock, captures the count on every USB OTG FS SOF (ITR1 remap) */
+#define AUDIO_SOF_TIMx                      TIM2
+#define AUDIO_SOF_TIMx_CLK_ENABLE()         __HAL_RCC_TIM2_CLK_ENABLE()
+#define AUDIO_SOF_TIMx_CLK_DISABLE()        __HAL_RCC_TIM2_CLK_DISABLE()
+
 #define AUDIODATA_SIZE                      4   // 24-bit audio sample in 32-bit frame
 
 // Audio status definition
@@ -75,8 +86,10 @@ extern const I2S_CLK_CONFIG I2S_Clk_Config24[];
 
 
 uint8_t BSP_AUDIO_OUT_Init(int16_t volume, uint32_t audioFreq, uint8_t options);
-uint8_t BSP_AUDIO_OUT_Play(uint16_t* pBuffer, uint32_t size);
-void    BSP_AUDIO_OUT_ChangeBuffer(uint16_t *pData, uint16_t size);
+uint8_t BSP_AUDIO_OUT_Play(uint32_t* pBuffer, uint32_t size);
+uint8_t BSP_AUDIO_OUT_Switch(uint32_t audioFreq, uint32_t* pBuffer, uint32_t size);
+uint8_t BSP_AUDIO_OUT_ClockReady(void);
+void    BSP_AUDIO_OUT_ChangeBuffer(uint32_t *pData, uint16_t size);
 uint8_t BSP_AUDIO_OUT_Pause(void);
 uint8_t BSP_AUDIO_OUT_Resume(void);
 uint8_t BSP_AUDIO_OUT_Stop(void);
@@ -85,6 +98,11 @@ void    BSP_AUDIO_OUT_SetFrequency(uint32_t audioFreq);
 uint8_t BSP_AUDIO_OUT_SetMute(uint8_t mute);
 void    BSP_AUDIO_OUT_DeInit(void);
 uint32_t BSP_AUDIO_OUT_GetRemainingDataSize(void);
+uint32_t BSP_AUDIO_OUT_GetPlayPosition(void);
+int     BSP_AUDIO_OUT_GetFreqIndex(uint32_t audioFreq);
+uint32_t BSP_AUDIO_OUT_SofTimerInit(void);
+void    BSP_AUDIO_OUT_SofTimerDeInit(void);
+uint32_t BSP_AUDIO_OUT_SofTimerCapture(void);
 
 /* User Callbacks: user has to implement these functions in his code if they are needed. */
 /* This function is called when the requested data has been completely transferred.*/
@@ -0,0 +1,52 @@
+// Generated by tools/i2s_pll, do not edit. Included by bsp_audio.c only.
+// PLLI2S and I2S prescaler settings with the smallest sampling frequency error,
+// nominal_fdbk is the actual Fs in kHz, 10.14 format shifted left by 8 bits.
+
+#ifndef __BSP_AUDIO_CLK_H
+#define __BSP_AUDIO_CLK_H
+
+#if (I2S_FREQ_NUM != 7) || (I2S_FREQ_INDEX_DEFAULT != 4)
+#error "I2S frequency table does not match bsp_audio.h"
+#endif
+
+const uint32_t I2SFreq[I2S_FREQ_NUM] = {32000, 44100, 48000, 88200, 96000, 176400, 192000};
+
+#if defined(STM32F411xE) && defined(USE_MCLK_OUT) // STM32F411 with MCLK output
+
+const I2S_CLK_CONFIG I2S_Clk_Config24[I2S_FREQ_NUM]  = {
+{13, 213, 2, 12, 1, 0x080013B1},     //   32.0012    +37.56ppm
+{25, 429, 2, 9, 1, 0x0B065E51},      //   44.0995    -11.19ppm
+{21, 289, 2, 7, 0, 0x0BFFDA8F},      //   47.9977    -47.61ppm
+{20, 289, 2, 4, 0, 0x160C8800},      //   88.1958    -47.61ppm
+{21, 289, 2, 3, 1, 0x17FFB51E},      //   95.9954    -47.61ppm
+{20, 289, 2, 2, 0, 0x2C191000},      //  176.3916    -47.61ppm
+{22, 346, 2, 2, 0, 0x2FFEEE8C}       //  191.9833    -86.93ppm
+};
+
+#elif defined(STM32F411xE) // STM32F411
+
+const I2S_CLK_CONFIG I2S_Clk_Config24[I2S_FREQ_NUM]  = {
+{25, 256, 5, 12, 1, 0x08000000},     //   32.0000     +0.00ppm
+{25, 429, 2, 38, 0, 0x0B065E51},     //   44.0995    -11.19ppm
+{25, 384, 5, 12, 1, 0x0C000000},     //   48.0000     +0.00ppm
+{25, 429, 2, 19, 0, 0x160CBCA2},     //   88.1990    -11.19ppm
+{15, 188, 3, 8, 1, 0x17FFCA75},      //   95.9967    -34.04ppm
+{25, 429, 2, 9, 1, 0x2C197943},      //  176.3980    -11.19ppm
+{21, 289, 2, 7, 0, 0x2FFF6A3B}       //  191.9909    -47.61ppm
+};
+
+#else // STM32F401
+
+const I2S_CLK_CONFIG I2S_Clk_Config24[I2S_FREQ_NUM]  = {
+{25, 256, 5, 12, 1, 0x08000000},     //   32.0000     +0.00ppm
+{25, 429, 2, 38, 0, 0x0B065E51},     //   44.0995    -11.19ppm
+{25, 384, 5, 12, 1, 0x0C000000},     //   48.0000     +0.00ppm
+{25, 429, 2, 19, 0, 0x160CBCA2},     //   88.1990    -11.19ppm
+{25, 424, 3, 11, 1, 0x1800ED73},     //   96.0145   +150.97ppm
+{25, 429, 2, 9, 1, 0x2C197943},      //  176.3980    -11.19ppm
+{25, 172, 2, 3, 1, 0x2FFDB6DB}       //  191.9643   -186.01ppm
+};
+
+#endif
+
+#endif /* __BSP_AUDIO_CLK_H */
@@ -25,34 +25,70 @@
 #endif
 
 #include  "usbd_ioreq.h"
+#include  "usbd_audio_conv.h"
+#include  "usbd_audio_fb.h"
+#include  "usbd_audio_asrc.h"
+#include  "usbd_audio_telem.h"
+#include  "usbd_audio_trace.h"
 
 
 #ifndef USBD_AUDIO_FREQ_DEFAULT
 #define USBD_AUDIO_FREQ_DEFAULT                       96000U
 #endif
 
+// Highest sampling frequency of all alternate settings
 #ifndef USBD_AUDIO_FREQ_MAX
-#define USBD_AUDIO_FREQ_MAX                           96000U
+#define USBD_AUDIO_FREQ_MAX                           192000U
 #endif
 
+// USE_FIXED_CLOCK : the I2S clock is configured once for AUDIO_FIXED_FREQ and the stream is
+// resampled to it (usbd_audio_asrc.h), a sampling frequency change does not touch PLLI2S.
+// The resampler only upsamples, so the stream frequency is limited to AUDIO_FIXED_FREQ.
+#ifdef USE_FIXED_CLOCK
+#ifndef AUDIO_FIXED_FREQ
+#define AUDIO_FIXED_FREQ                              96000U
+#endif
+#if (AUDIO_FIXED_FREQ != 96000U) && (AUDIO_FIXED_FREQ != 192000U)
+#error "AUDIO_FIXED_FREQ must be 96000 or 192000"
+#endif
+#endif
+
+// Packets are resampled into the ring buffer instead of converted in place
+#if defined(USE_ADAPTIVE_EP) || defined(USE_FIXED_CLOCK)
+#define AUDIO_OUT_RESAMPLE
+#endif
+
+// Highest sampling frequency of each alternate setting. The packet size
+// (Fs / 1000 + 1) * channels * subframe_bytes must fit the 1023 byte isochronous
+// full speed limit, so only the 16bit format goes beyond 96kHz.
+#define AUDIO_OUT_FREQ_MAX_24B                        96000U
+#if defined(USE_FIXED_CLOCK) && (AUDIO_FIXED_FREQ < 176400U)
+#define AUDIO_OUT_FREQ_MAX_16B                        96000U
+#define AUDIO_FORMAT_16B_FREQ_NUM                     5U
+#else
+#define AUDIO_OUT_FREQ_MAX_16B                        192000U
+#define AUDIO_FORMAT_16B_FREQ_NUM                     7U
+#endif
+#define AUDIO_OUT_FREQ_MAX_32B                        96000U
+
 // See USB Device Class Definition for Audio Devices v1.0 p.77
  // max volume is 0dB, this is to avoid clipping
  #ifndef USBD_AUDIO_VOL_MAX
  #define USBD_AUDIO_VOL_MAX                            0x0000U
  #endif
 
- // 1dB <=> 0x100, -96dB = 0xA000
+ // 1dB <=> 0x100, -127dB = 0x8100
  #ifndef USBD_AUDIO_VOL_MIN
- #define USBD_AUDIO_VOL_MIN                            0xA000U
+ #define USBD_AUDIO_VOL_MIN                            0x8100U
  #endif
 
  #ifndef USBD_AUDIO_VOL_DEFAULT
  #define USBD_AUDIO_VOL_DEFAULT                        0xA000U
  #endif
 
- // 3dB step resolution
+ // 1/256dB step resolution
  #ifndef USBD_AUDIO_VOL_STEP
- #define USBD_AUDIO_VOL_STEP                           0x0300U
+ #define USBD_AUDIO_VOL_STEP                           0x0001U
  #endif
 
  // default mute state is on (muted)
@@ -69,9 +105,46 @@
 #define AUDIO_OUT_EP                                  0x01U
 #define AUDIO_IN_EP                                   0x81U
 
+/* USE_ADAPTIVE_EP : adaptive OUT endpoint without the feedback endpoint, the host sends at its own
+   rate and the stream is resampled to the I2S clock, see usbd_audio_asrc.h.
+   Otherwise asynchronous OUT endpoint with the explicit feedback endpoint AUDIO_IN_EP. */
+#ifdef USE_ADAPTIVE_EP
+#define AUDIO_OUT_EP_ATTRIBUTES                       0x09U /* isochronous, adaptive */
+#define AUDIO_OUT_EP_SYNCH                            0x00U
+#define AUDIO_AS_NUM_EP                               0x01U
+#else
+#define AUDIO_OUT_EP_ATTRIBUTES                       USBD_EP_TYPE_ISOC_ASYNC
+#define AUDIO_OUT_EP_SYNCH                            AUDIO_IN_EP
+#define AUDIO_AS_NUM_EP                               0x02U
+#endif
+
+/* Feedback endpoint bRefresh, the host reads the feedback every 2^SOF_RATE ms (UAC 1.0 p.63, 1..9).
+   The feedback is computed once per period from the buffer fill level averaged over the period. */
+#ifndef SOF_RATE
 #define SOF_RATE                                      0x02U
+#endif
+#if (SOF_RATE < 1) || (SOF_RATE > 9)
+#error "SOF_RATE must be 1 to 9"
+#endif
+#define AUDIO_FB_PERIOD_MASK                          ((1U << SOF_RATE) - 1U)
+
+// 16bit format type descriptor, 7 frequencies or 5 with USE_FIXED_CLOCK at 96kHz
+#define AUDIO_FORMAT_16B_DESC_SIZE                    (8U + 3U * AUDIO_FORMAT_16B_FREQ_NUM)
+
+// USE_TELEMETRY : vendor specific interface with a bulk IN endpoint, see usbd_audio_telem.h
+#ifdef USE_TELEMETRY
+#define AUDIO_TELEM_DESC_SIZE                         16U
+#define AUDIO_NUM_INTERFACES                          0x03U
+#else
+#define AUDIO_TELEM_DESC_SIZE                         0U
+#define AUDIO_NUM_INTERFACES                          0x02U
+#endif
 
-#define USB_AUDIO_CONFIG_DESC_SIZ                     124
+#ifdef USE_ADAPTIVE_EP
+#define USB_AUDIO_CONFIG_DESC_SIZ                     (208U + AUDIO_FORMAT_16B_DESC_SIZE + AUDIO_TELEM_DESC_SIZE) /* no feedback endpoint descriptors */
+#else
+#define USB_AUDIO_CONFIG_DESC_SIZ                     (235U + AUDIO_FORMAT_16B_DESC_SIZE + AUDIO_TELEM_DESC_SIZE)
+#endif
 
 #define AUDIO_INTERFACE_DESC_SIZE                     0x09U
 #define USB_AUDIO_DESC_SIZ                            0x09U
@@ -135,23 +208,96 @@
 // Max packet size: (freq / 1000 + extra_samples) * channels * bytes_per_sample
 // e.g. 96kHz, 24bit : (96000 / 1000 + 1) * 2(stereo) * 3(24bit) = 582 bytes
 
-#define AUDIO_OUT_PACKET_24B                          ((uint16_t)((USBD_AUDIO_FREQ_MAX / 1000U + 1) * 2U * 3U))
+#define AUDIO_OUT_FRAMES(frq)                         ((frq) / 1000U + 1U)
+#define AUDIO_OUT_PACKET_24B                          ((uint16_t)(AUDIO_OUT_FRAMES(AUDIO_OUT_FREQ_MAX_24B) * 2U * 3U))
+// 772 bytes at 192kHz
+#define AUDIO_OUT_PACKET_16B                          ((uint16_t)(AUDIO_OUT_FRAMES(AUDIO_OUT_FREQ_MAX_16B) * 2U * 2U))
+// 24bit samples in 4 byte subframes, 776 bytes at 96kHz
+#define AUDIO_OUT_PACKET_32B                          ((uint16_t)(AUDIO_OUT_FRAMES(AUDIO_OUT_FREQ_MAX_32B) * 2U * 4U))
+#define AUDIO_OUT_PACKET_MAX                          ((AUDIO_OUT_PACKET_32B > AUDIO_OUT_PACKET_16B) ? \
+                                                       ((AUDIO_OUT_PACKET_32B > AUDIO_OUT_PACKET_24B) ? AUDIO_OUT_PACKET_32B : AUDIO_OUT_PACKET_24B) : \
+                                                       ((AUDIO_OUT_PACKET_16B > AUDIO_OUT_PACKET_24B) ? AUDIO_OUT_PACKET_16B : AUDIO_OUT_PACKET_24B))
+
+// Audio streaming interface number, the vendor requests are addressed to it
+#define AUDIO_AS_ITF                                  0x01U
+// Audio streaming interface alternate settings, 0 is zero bandwidth
+#define AUDIO_ALT_SETTING_24B                         0x01U
+#define AUDIO_ALT_SETTING_16B                         0x02U
+#define AUDIO_ALT_SETTING_32B                         0x03U
+#define AUDIO_ALT_SETTING_NUM                         4U
 
 /* Input endpoint is for feedback. See USB 1.1 Spec, 5.10.4.2 Feedback. */
 #define AUDIO_IN_PACKET                               3U
 
-// Number of sub-packets in the audio transfer buffer.
-// You can modify this value but always make sure that it is an even number higher than 3.
-// Larger values will increase latency since we start playing only when the buffer is half-full
-#define AUDIO_OUT_PACKET_NUM                          8U
+// Latency profiles, in packets (ms) of the current sampling frequency. The feedback setpoint is this
+// many packets in the buffer, and the ring buffer is sized for twice as many. The stream starts with
+// a lower fill level, see AUDIO_OUT_START_PACKETS. Selected at run time with the vendor request
+// AUDIO_VENDOR_REQ_SET_LATENCY, or at boot with USBD_AUDIO_SetLatencyProfile.
+#define AUDIO_LATENCY_PACKETS                         {2U, 4U, 8U, 16U}
+#define AUDIO_LATENCY_PROFILE_NUM                     4U
+#define AUDIO_LATENCY_PROFILE_DEFAULT                 2U
+
+// Start delay in packets (ms). The DMA plays the silent ring buffer from the stream (re)start, and the
+// first packet is placed this many packets ahead of the DMA, so it is heard after the start delay instead
+// of the latency profile. The feedback then raises the fill level to the profile setpoint. 0 = the latency
+// profile, as the adaptive endpoint mode needs : without feedback the fill level can only be raised by
+// resampling, i.e. a pitch change.
+#ifndef AUDIO_OUT_START_PACKETS
+#ifdef USE_ADAPTIVE_EP
+#define AUDIO_OUT_START_PACKETS                       0U
+#else
+#define AUDIO_OUT_START_PACKETS                       1U
+#endif
+#endif
 
-// Total size of the audio transfer buffer
-#define AUDIO_TOTAL_BUF_SIZE                          ((uint16_t)((USBD_AUDIO_FREQ_MAX / 1000U + 1) * 2U * 3U * AUDIO_OUT_PACKET_NUM))
+// Largest ring buffer in packets of the highest sampling frequency. Profiles needing more
+// are limited to this size, the 16ms profile is reduced to ~8ms at 176.4kHz and 192kHz.
+#define AUDIO_OUT_PACKET_NUM_MAX                      16U
+
+// Allocated size of the audio transfer buffer in 32bit words, one word per channel.
+// The ring buffer in use is buf_size words of it, see AUDIO_OUT_SetBuffer.
+#define AUDIO_TOTAL_BUF_FRAMES_MAX                    (AUDIO_OUT_PACKET_FRAMES_MAX * AUDIO_OUT_PACKET_NUM_MAX)
+#define AUDIO_TOTAL_BUF_SIZE_MAX                      ((uint16_t)(AUDIO_TOTAL_BUF_FRAMES_MAX * 2U))
+
+
+// Packets are received directly into the audio buffer ahead of wr_ptr and converted in place.
+// The raw packet is placed AUDIO_OUT_RX_OFFSET bytes after wr_ptr, so that the converted output
+// (8 bytes per frame) never overtakes the raw input (8, 6 or 4 bytes per frame) still to be read.
+// The offset is (8 - input bytes per frame) * frames for the largest packet of each format,
+// the 16bit format at 192kHz needs the largest one. The buffer uses rx_offset, the offset for the
+// current format and frequency, so the packet does not overwrite unplayed frames in a small ring.
+// A packet received near the end of the buffer extends into the guard area, the part
+// converted past the end is moved to the start of the buffer.
+#define AUDIO_OUT_PACKET_FRAMES_MAX                   AUDIO_OUT_FRAMES(USBD_AUDIO_FREQ_MAX)
+#define AUDIO_OUT_RX_OFFSET_16B                       (AUDIO_OUT_FRAMES(AUDIO_OUT_FREQ_MAX_16B) * 2U * 4U - AUDIO_OUT_PACKET_16B)
+#define AUDIO_OUT_RX_OFFSET_24B                       (AUDIO_OUT_FRAMES(AUDIO_OUT_FREQ_MAX_24B) * 2U * 4U - AUDIO_OUT_PACKET_24B)
+#define AUDIO_OUT_RX_OFFSET                           ((((AUDIO_OUT_RX_OFFSET_16B > AUDIO_OUT_RX_OFFSET_24B) ? \
+                                                         AUDIO_OUT_RX_OFFSET_16B : AUDIO_OUT_RX_OFFSET_24B) + 3U) & ~3U)
+// Guard area size in words, the USB FIFO is read in words
+#ifdef AUDIO_OUT_RESAMPLE
+// packets are received in rx_slot and resampled into the ring buffer with wrap around
+#define AUDIO_OUT_RX_GUARD                            0U
+#else
+#define AUDIO_OUT_RX_GUARD                            ((AUDIO_OUT_RX_OFFSET + ((AUDIO_OUT_PACKET_MAX + 3U) & ~3U)) / 4U)
+#endif
 
+// Received packets waiting for conversion by USBD_AUDIO_ProcessPackets, power of 2.
+// The OTG ISR only queues the packet position and reserves its space in the buffer.
+#define AUDIO_OUT_QUEUE_SIZE                          8U
 
-// The minimum distance between rd_ptr and wr_ptr to prevent overwriting unplayed buffer
+// Underrun concealment states, see USBD_AUDIO_SOF : playing, underrun detected and fade out pending
+// in USBD_AUDIO_ProcessPackets, ring buffer silent until the host sends the next packet
+#define AUDIO_OUT_XRUN_NONE                           0U
+#define AUDIO_OUT_XRUN_FADE                           1U
+#define AUDIO_OUT_XRUN_SILENT                         2U
+// Words after the read position the DMA may already have fetched, left as they are by the concealment
+#define AUDIO_OUT_XRUN_MARGIN                         8U
 
-#define AUDIO_BUF_SAFEZONE_SAMPLES                    ((USBD_AUDIO_FREQ_MAX / 1000U) + 1)
+// Vendor requests, recipient the audio streaming interface (wIndex AUDIO_AS_ITF) : latency profile index in wValue / 1 byte data stage
+#define AUDIO_VENDOR_REQ_SET_LATENCY                  0x01U
+#define AUDIO_VENDOR_REQ_GET_LATENCY                  0x02U
+// Underrun and overrun counters, wLength 8, USBD_AUDIO_XrunTypeDef
+#define AUDIO_VENDOR_REQ_GET_XRUN                     0x03U
 
     /* Audio Commands enumeration */
 typedef enum
@@ -185,44 +331,101 @@ typedef enum
 USBD_AUDIO_ControlTypeDef;
 
 
+typedef struct
+{
+  uint16_t pos;     // buffer word offset of the converted packet, the raw packet is rx_offset bytes further
+  uint8_t  frames;  // stereo frames in the packet
+  uint8_t  gen;     // stream generation, packets queued before a restart are discarded
+#ifdef AUDIO_OUT_RESAMPLE
+  uint8_t  out_frames; // resampled frames reserved at pos, the raw packet is in rx_slot
+  uint64_t t;       // ASRC output position and step for the packet, see AUDIO_ASRC_Reserve
+  uint64_t step;
+#endif
+} AUDIO_OUT_PacketTypeDef;
+
+
+// Single producer (OTG ISR) / single consumer (PendSV) queue, head and tail are free running
+typedef struct
+{
+  AUDIO_OUT_PacketTypeDef   pkt[AUDIO_OUT_QUEUE_SIZE];
+  volatile uint32_t         head; // written by the producer only
+  volatile uint32_t         tail; // written by the consumer only
+  volatile uint8_t          gen;  // written by the producer only
+} AUDIO_OUT_QueueTypeDef;
+
+
 
 typedef struct
 {
   uint32_t                  alt_setting;
-  uint16_t                  buffer[AUDIO_TOTAL_BUF_SIZE];
+  uint32_t                  buffer[AUDIO_TOTAL_BUF_SIZE_MAX + AUDIO_OUT_RX_GUARD]; // I2S words, see usbd_audio_conv.h
+  uint16_t                  buf_size; // ring buffer size in words for the latency profile and frequency
+  uint16_t                  rx_offset; // bytes from wr_ptr to the received packet, see AUDIO_OUT_RX_OFFSET
+  uint16_t                  safezone; // minimum writable frames, one packet
+  uint16_t                  xrun_margin_words; // half a packet in words, the underrun / overrun margin
+  uint8_t*                  rx_buf; // where the OUT endpoint was armed to receive the next packet
   AUDIO_OffsetTypeDef       offset;
   uint8_t                   rd_enable;
-  uint16_t                  rd_ptr;
-  uint16_t                  wr_ptr;
+  uint16_t                  rd_ptr; // in words
+  uint16_t                  wr_ptr; // in words, end of the last received packet
+  volatile uint8_t          xrun; // underrun concealment state, AUDIO_OUT_XRUN_xxx
   uint32_t                  freq;
-  uint32_t                  bit_depth;
+  uint32_t                  bit_depth; // of the current alternate setting
   int16_t                   volume;
-  int32_t                   vol_3dB_shift; // 3dB attenuation steps equivalent to volume setting
+  int32_t                   gain; // Q1.30 linear gain equivalent to volume setting
   uint8_t                   mute; // 0 = unmuted, 1 = muted
+  AUDIO_ConvTypeDef         conv; // packet conversion kernel for the current format, volume and mute setting
+  volatile uint8_t          conv_update; // volume or mute changed, applied by USBD_AUDIO_ProcessPackets
+  AUDIO_OUT_QueueTypeDef    queue; // received packets to convert
+  AUDIO_FB_TypeDef          fb; // feedback endpoint controller
+#ifdef AUDIO_OUT_RESAMPLE
+  AUDIO_ASRC_TypeDef        asrc; // resampler, stream to I2S frequency, with USE_ADAPTIVE_EP trimmed by the feedback controller
+  uint8_t                   asrc_gen; // stream generation of the resampler history, written by PendSV only
+  uint32_t                  rx_slot[AUDIO_OUT_QUEUE_SIZE][(AUDIO_OUT_PACKET_MAX + 3U) / 4U]; // one raw packet per queue entry
+#endif
   USBD_AUDIO_ControlTypeDef control;
 } USBD_AUDIO_HandleTypeDef;
 
 
+// Underrun and overrun events since power up
+typedef struct
+{
+  uint32_t underruns; // the ring buffer ran empty, faded out to silence
+  uint32_t overruns;  // packets dropped, the ring buffer was full
+} USBD_AUDIO_XrunTypeDef;
+
+
 typedef struct
 {
     int8_t  (*Init)         (uint32_t  audioFreq, int16_t volume, uint8_t options);
     int8_t  (*DeInit)       (uint8_t options);
-    int8_t  (*AudioCmd)     (uint16_t* pbuf, uint32_t size, uint8_t cmd);
+    int8_t  (*AudioCmd)     (uint32_t* pbuf, uint32_t size, uint8_t cmd);
     int8_t  (*VolumeCtl)    (int16_t vol);
     int8_t  (*MuteCtl)      (uint8_t cmd);
     int8_t  (*PeriodicTC)   (uint8_t cmd);
     int8_t  (*GetState)     (void);
+    int8_t  (*SwitchFreq)   (uint32_t  audioFreq, uint32_t* pbuf, uint32_t size);
 } USBD_AUDIO_ItfTypeDef;
 
 #ifdef DEBUG_FEEDBACK_ENDPOINT
+extern volatile uint32_t  DbgOptimalWritableSamples;
+extern volatile uint32_t  DbgSafeZoneWritableSamples;
 extern volatile uint32_t  DbgMinWritableSamples;
 extern volatile uint32_t  DbgMaxWritableSamples;
-extern volatile uint32_t  DbgSofHistory[];
-extern volatile uint32_t  DbgWritableSampleHistory[];
-extern volatile float     DbgFeedbackHistory[];
-extern volatile uint8_t   DbgIndex;
+extern volatile uint32_t  DbgDataOutCycles;
+extern volatile uint32_t  DbgDataOutCyclesMax;
+extern volatile uint32_t  DbgConvCycles;
+extern volatile uint32_t  DbgConvCyclesMax;
+extern volatile uint32_t  DbgOtgIsrCyclesMax;
+extern volatile uint32_t  DbgQueueOverflows;
+extern volatile uint32_t  DbgRestartCycles;
+extern volatile uint32_t  DbgSwitchCycles;
+extern volatile uint8_t   DbgSwitchFast;
+extern volatile uint32_t  DbgStartCycles;
 #endif
 
+extern volatile USBD_AUDIO_XrunTypeDef USBD_AUDIO_Xrun;
+
 extern USBD_ClassTypeDef  USBD_AUDIO;
 #define USBD_AUDIO_CLASS    &USBD_AUDIO
 
@@ -230,6 +433,8 @@ extern USBD_ClassTypeDef  USBD_AUDIO;
 uint8_t  USBD_AUDIO_RegisterInterface  (USBD_HandleTypeDef   *pdev,
                                         USBD_AUDIO_ItfTypeDef *fops);
 void  USBD_AUDIO_Sync (USBD_HandleTypeDef *pdev, AUDIO_OffsetTypeDef offset);
+void  USBD_AUDIO_ProcessPackets (USBD_HandleTypeDef *pdev);
+void  USBD_AUDIO_SetLatencyProfile (uint8_t profile);
 
 #ifdef __cplusplus
 }
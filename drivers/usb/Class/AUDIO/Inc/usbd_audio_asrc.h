@@ -0,0 +1,77 @@
+/**
+  ******************************************************************************
+  * @file    usbd_audio_asrc.h
+  * @brief   Asynchronous sample rate converter for the adaptive endpoint mode
+  ******************************************************************************
+  */
+
+#ifndef __USBD_AUDIO_ASRC_H
+#define __USBD_AUDIO_ASRC_H
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+#include <stdint.h>
+
+// With USE_ADAPTIVE_EP there is no feedback endpoint, the host sends packets at its own clock.
+// The converter resamples the USB stream to the free-running I2S clock, so the ring buffer fill
+// level is kept at the setpoint by the output to input frame ratio instead of the host rate.
+// With USE_FIXED_CLOCK the I2S clock stays at AUDIO_FIXED_FREQ and lower stream rates are
+// upsampled, the nominal ratio (AUDIO_ASRC_SetRatio) is the stream rate / AUDIO_FIXED_FREQ.
+// The filter cutoff is the input Nyquist frequency, so the ratio is limited to upsampling.
+//
+// Polyphase windowed sinc interpolator, AUDIO_ASRC_TAPS input frames per output frame.
+// The output position t is in input frames Q32. Its fraction selects two adjacent phases of the
+// coefficient table (2^AUDIO_ASRC_PHASE_BITS phases) and the coefficients are linearly
+// interpolated between them. The interpolated coefficient is shared by both channels.
+// The coefficient table is generated by tools/asrc, which also checks THD+N and rate drift.
+//
+// Reservation and processing are split like the packet queue : AUDIO_ASRC_Reserve runs in the
+// OTG ISR, gives the number of output frames of the packet and advances t, so the ring buffer
+// space is reserved when the packet is queued. AUDIO_ASRC_Process runs later in PendSV with
+// the t and step of the packet, and keeps the last AUDIO_ASRC_TAPS input frames as history.
+// The delay is AUDIO_ASRC_TAPS/2 input frames. A stream restart in the OTG ISR only resets the
+// position (AUDIO_ASRC_Reset), PendSV clears the history it owns (AUDIO_ASRC_ClearHistory).
+//
+// No HAL dependency, tools/asrc runs this code on the host.
+
+#define AUDIO_ASRC_TAPS         32U
+#define AUDIO_ASRC_PHASE_BITS   8U
+#define AUDIO_ASRC_PHASES       (1U << AUDIO_ASRC_PHASE_BITS)
+
+// Largest packet, 192kHz
+#ifndef AUDIO_ASRC_IN_FRAMES_MAX
+#define AUDIO_ASRC_IN_FRAMES_MAX  193U
+#endif
+
+// Step limit around the nominal ratio, as the feedback controller : +/- 1/32
+#define AUDIO_ASRC_STEP_ONE     ((uint64_t)1 << 32)
+#define AUDIO_ASRC_STEP_SHIFT   5U
+
+typedef struct {
+  int32_t  x[(AUDIO_ASRC_TAPS + AUDIO_ASRC_IN_FRAMES_MAX) * 2U]; // history + packet, left-aligned L/R samples
+  uint64_t t;     // next output position in x, input frames Q32, reserved up to the last queued packet
+  uint64_t step;  // input frames per output frame, Q32
+  uint64_t step_nom; // nominal step, input / output sampling frequency
+} AUDIO_ASRC_TypeDef;
+
+void     AUDIO_ASRC_Init(AUDIO_ASRC_TypeDef* pAsrc);
+void     AUDIO_ASRC_Reset(AUDIO_ASRC_TypeDef* pAsrc);
+void     AUDIO_ASRC_ClearHistory(AUDIO_ASRC_TypeDef* pAsrc);
+void     AUDIO_ASRC_SetRatio(AUDIO_ASRC_TypeDef* pAsrc, uint32_t in_freq, uint32_t out_freq);
+void     AUDIO_ASRC_SetStep(AUDIO_ASRC_TypeDef* pAsrc, uint64_t step);
+uint32_t AUDIO_ASRC_Reserve(AUDIO_ASRC_TypeDef* pAsrc, uint32_t in_frames, uint64_t* pT);
+void     AUDIO_ASRC_Process(AUDIO_ASRC_TypeDef* pAsrc, uint32_t* pRing, uint32_t pos, uint32_t size,
+                            uint32_t in_frames, uint32_t out_frames, uint64_t t, uint64_t step);
+
+// Where the packet is converted to I2S words (usbd_audio_conv.h) before AUDIO_ASRC_Process
+static inline uint32_t* AUDIO_ASRC_Input(AUDIO_ASRC_TypeDef* pAsrc) {
+  return (uint32_t*)&pAsrc->x[AUDIO_ASRC_TAPS * 2U];
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __USBD_AUDIO_ASRC_H */
@@ -0,0 +1,1043 @@
+// Generated by tools/asrc, do not edit. Included by usbd_audio_asrc.c only.
+// Windowed sinc interpolator, Kaiser beta 12.0, cutoff 1.00 x Fs/2, Q30.
+// Row p : output position fraction p/256, the last row is row 0 shifted by one frame.
+
+#ifndef __USBD_AUDIO_ASRC_COEF_H
+#define __USBD_AUDIO_ASRC_COEF_H
+
+#if (AUDIO_ASRC_TAPS != 32) || (AUDIO_ASRC_PHASES != 256)
+#error "ASRC coefficient table does not match usbd_audio_asrc.h"
+#endif
+
+static const int32_t AUDIO_ASRC_Coef[AUDIO_ASRC_PHASES + 1][AUDIO_ASRC_TAPS] = {
+{0,0,0,0,0,0,0,0,
+ 0,0,0,0,0,0,0,1073741824,
+ 0,0,0,0,0,0,0,0,
+ 0,0,0,0,0,0,0,0},
+{-193,889,-2847,7412,-16763,34153,-64135,112835,
+ -188416,302174,-471361,726998,-1138353,1912017,-4084373,1073714520,
+ 4117853,-1920857,1142543,-729473,472968,-303253,189140,-113309,
+ 64434,-34332,16863,-7463,2870,-898,196,-14},
+{-383,1769,-5670,14771,-33424,68123,-127963,225180,
+ -376083,603227,-941048,1451418,-2272360,3814955,-8135034,1073632581,
+ 8268951,-3850313,2289119,-1461319,947476,-607541,378976,-227076,
+ 129158,-68837,33823,-14976,5764,-1805,394,-29},
+{-570,2640,-8470,22078,-49982,101905,-191474,337020,
+ -562973,903116,-1408995,2173158,-3401865,5708577,-12151756,1073496016,
+ 12453055,-5788124,3439569,-2195433,1423455,-912822,569482,-341286,
+ 194163,-103512,50879,-22538,8680,-2722,595,-44},
+{-755,3501,-11245,29332,-66433,135495,-254661,448339,
+ -749061,1201798,-1875135,2892117,-4526715,7592650,-16134316,1073304838,
+ 16669921,-7734044,4593733,-2931711,1900838,-1219050,760630,-455921,
+ 259439,-138351,68027,-30148,11618,-3647,799,-59},
+{-936,4353,-13996,36530,-82776,168889,-317514,559122,
+ -934321,1499232,-2339403,3608194,-5646757,9466940,-20082495,1073059064,
+ 20919302,-9687826,5751450,-3670047,2379555,-1526182,952392,-570966,
+ 324979,-173350,85267,-37805,14579,-4580,1006,-75},
+{-1115,5195,-16722,43674,-99009,202082,-380025,669354,
+ -1118727,1795376,-2801734,4321291,-6761840,11331219,-23996078,1072758717,
+ 25200946,-11649220,6912559,-4410335,2859536,-1834173,1144742,-686404,
+ 390772,-208505,102595,-45509,17561,-5523,1215,-92},
+{-1291,6028,-19423,50761,-115130,235070,-442186,779019,
+ -1302253,2090189,-3262063,5031309,-7871813,13185259,-27874854,1072403825,
+ 29514597,-13617972,8076895,-5152468,3340713,-2142978,1337651,-802219,
+ 456809,-243809,120009,-53258,20564,-6474,1427,-109},
+{-1465,6852,-22098,57791,-131137,267848,-503989,888103,
+ -1484874,2383630,-3720326,5738148,-8976529,15028835,-31718618,1071994421,
+ 33859996,-15593829,9244296,-5896340,3823015,-2452554,1531092,-918394,
+ 523082,-279258,137506,-61052,23589,-7433,1642,-127},
+{-1635,7665,-24748,64763,-147027,300413,-565425,996592,
+ -1666566,2675658,-4176460,6441714,-10075839,16861726,-35527167,1071530544,
+ 38236880,-17576533,10414596,-6641842,4306372,-2762853,1725036,-1034913,
+ 589579,-314848,155086,-68889,26634,-8401,1859,-145},
+{-1803,8469,-27372,71677,-162800,332760,-626487,1104470,
+ -1847303,2966233,-4630402,7141908,-11169598,18683711,-39300302,1071012236,
+ 42644981,-19565827,11587628,-7388866,4790712,-3073831,1919454,-1151757,
+ 656293,-350573,172744,-76768,29699,-9378,2079,-164},
+{-1968,9263,-29970,78532,-178453,364886,-687166,1211723,
+ -2027061,3255316,-5082089,7838636,-12257660,20494572,-43037830,1070439546,
+ 47084027,-21561449,12763225,-8137302,5275964,-3385441,2114318,-1268911,
+ 723212,-386428,190479,-84688,32784,-10362,2302,-183},
+{-2130,10048,-32541,85326,-193984,396786,-747455,1318337,
+ -2205816,3542866,-5531460,8531802,-13339883,22294096,-46739562,1069812528,
+ 51553744,-23563136,13941220,-8887041,5762056,-3697638,2309600,-1386357,
+ 790329,-422408,208288,-92649,35888,-11355,2528,-203},
+{-2289,10822,-35086,92060,-209391,428456,-807346,1424298,
+ -2383544,3828846,-5978453,9221314,-14416124,24082069,-50405311,1069131239,
+ 56053852,-25570624,15121442,-9637972,6248917,-4010375,2505270,-1504078,
+ 857632,-458508,226168,-100649,39012,-12355,2756,-223},
+{-2446,11587,-37604,98732,-224673,459893,-866831,1529592,
+ -2560221,4113215,-6423008,9907078,-15486242,25858281,-54034897,1068395743,
+ 60584069,-27583646,16303721,-10389985,6736474,-4323605,2701300,-1622056,
+ 925111,-494723,244118,-108686,42154,-13363,2986,-244},
+{-2600,12342,-40095,105342,-239828,491092,-925902,1634206,
+ -2735823,4395937,-6865065,10589002,-16550099,27622526,-57628143,1067606110,
+ 65144108,-29601932,17487887,-11142968,7224654,-4637283,2897660,-1740275,
+ 992758,-531047,262134,-116761,45315,-14379,3220,-265},
+{-2751,13086,-42558,111889,-254855,522050,-984553,1738125,
+ -2910327,4676972,-7304564,11266996,-17607557,29374599,-61184877,1066762411,
+ 69733677,-31625213,18673767,-11896810,7713383,-4951359,3094320,-1858715,
+ 1060562,-567475,280214,-124872,48493,-15403,3455,-287},
+{-2899,13821,-44995,118372,-269750,552763,-1042776,1841336,
+ -3083710,4956284,-7741446,11940968,-18658479,31114297,-64704929,1065864726,
+ 74352484,-33653216,19861189,-12651397,8202589,-5265788,3291251,-1977360,
+ 1128513,-604003,298356,-133017,51689,-16434,3694,-310},
+{-3044,14545,-47403,124791,-284514,583228,-1100564,1943827,
+ -3255950,5233835,-8175653,12610830,-19702731,32841421,-68188137,1064913139,
+ 79000229,-35685665,21049979,-13406617,8692197,-5580522,3488424,-2096192,
+ 1196601,-640623,316557,-141196,54902,-17473,3935,-333},
+{-3187,15259,-49784,131146,-299143,613440,-1157908,2045583,
+ -3427024,5509589,-8607127,13276493,-20740178,34555774,-71634340,1063907738,
+ 83676612,-37722286,22239962,-14162357,9182134,-5895512,3685808,-2215192,
+ 1264815,-677332,334813,-149407,58132,-18519,4178,-356},
+{-3326,15964,-52136,137435,-313638,643397,-1214804,2146593,
+ -3596910,5783509,-9035811,13937870,-21770690,36257161,-75043383,1062848617,
+ 88381326,-39762798,23430963,-14918502,9672325,-6210712,3883374,-2334343,
+ 1333146,-714123,353123,-157650,61378,-19572,4424,-381},
+{-3463,16658,-54460,143657,-327995,673094,-1271243,2246842,
+ -3765586,6055560,-9461649,14594874,-22794136,37945392,-78415115,1061735874,
+ 93114063,-41806923,24622805,-15674938,10162695,-6526072,4081090,-2453627,
+ 1401582,-750992,371484,-165923,64639,-20632,4673,-405},
+{-3597,17341,-56756,149813,-342214,702529,-1327218,2346320,
+ -3933029,6325706,-9884585,15247419,-23810386,39620276,-81749389,1060569613,
+ 97874510,-43854379,25815312,-16431551,10653169,-6841544,4278928,-2573025,
+ 1470115,-787932,389893,-174224,67916,-21699,4924,-431},
+{-3729,18015,-59023,155902,-356292,731698,-1382724,2445013,
+ -4099220,6593912,-10304563,15895422,-24819314,41281629,-85046064,1059349943,
+ 102662349,-45904883,27008306,-17188226,11143673,-7157081,4476856,-2692519,
+ 1538732,-824937,408348,-182554,71208,-22773,5177,-456},
+{-3858,18678,-61261,161923,-370229,760598,-1437753,2542909,
+ -4264137,6860143,-10721529,16538798,-25820794,42929266,-88305000,1058076977,
+ 107477263,-47958148,28201608,-17944846,11634130,-7472632,4674843,-2812091,
+ 1607424,-862004,426845,-190909,74514,-23853,5433,-483},
+{-3984,19331,-63470,167875,-384023,789225,-1492298,2639996,
+ -4427758,7124365,-11135429,17177465,-26814701,44563006,-91526064,1056750833,
+ 112318926,-50013888,29395040,-18701296,12124464,-7788149,4872860,-2931722,
+ 1676180,-899124,445381,-199290,77833,-24940,5691,-510},
+{-4107,19974,-65650,173759,-397673,817577,-1546354,2736263,
+ -4590064,7386545,-11546210,17811341,-27800913,46182671,-94709127,1055371635,
+ 117187012,-52071815,30588422,-19457460,12614600,-8103584,5070875,-3051393,
+ 1744990,-936294,463955,-207695,81167,-26033,5951,-537},
+{-4227,20606,-67801,179573,-411177,845650,-1599915,2831697,
+ -4751034,7646649,-11953819,18440345,-28779309,47788087,-97854064,1053939511,
+ 122081190,-54131639,31781573,-20213221,13104462,-8418886,5268858,-3171086,
+ 1813842,-973507,482563,-216123,84513,-27132,6214,-566},
+{-4345,21228,-69923,185317,-424534,873441,-1652973,2926287,
+ -4910648,7904644,-12358205,19064399,-29749769,49379079,-100960755,1052454595,
+ 127001126,-56193068,32974312,-20968462,13593972,-8734007,5466777,-3290783,
+ 1882726,-1010758,501202,-224573,87872,-28238,6479,-594},
+{-4460,21839,-72015,190991,-437743,900947,-1705523,3020022,
+ -5068887,8160499,-12759315,19683422,-30712175,50955479,-104029082,1050917024,
+ 131946483,-58255808,34166457,-21723065,14083055,-9048896,5664601,-3410463,
+ 1951631,-1048040,519870,-233042,91243,-29349,6747,-624},
+{-4573,22440,-74077,196594,-450802,928165,-1757559,3112891,
+ -5225730,8414180,-13157100,20297339,-31666411,52517120,-107058934,1049326942,
+ 136916920,-60319565,35357827,-22476914,14571634,-9363505,5862299,-3530109,
+ 2020547,-1085348,538563,-241531,94625,-30466,7016,-653},
+{-4682,23031,-76110,202125,-463710,955092,-1809075,3204882,
+ -5381160,8665656,-13551509,20906072,-32612363,54063836,-110050204,1047684496,
+ 141912093,-62384043,36548238,-23229890,15059631,-9677783,6059839,-3649701,
+ 2089462,-1122676,557279,-250037,98018,-31589,7288,-684},
+{-4789,23612,-78113,207585,-476465,981727,-1860065,3295985,
+ -5535158,8914897,-13942494,21509545,-33549917,55595466,-113002789,1045989839,
+ 146931654,-64448943,37737507,-23981875,15546969,-9991681,6257190,-3769220,
+ 2158365,-1160018,576015,-258559,101422,-32717,7562,-715},
+{-4894,24182,-80085,212972,-489068,1008064,-1910524,3386190,
+ -5687703,9161871,-14330005,22107685,-34478962,57111853,-115916589,1044243128,
+ 151975252,-66513967,38925451,-24732750,16033572,-10305148,6454321,-3888648,
+ 2227246,-1197368,594767,-267097,104836,-33850,7838,-746},
+{-4995,24741,-82028,218287,-501516,1034103,-1960446,3475486,
+ -5838780,9406549,-14713996,22700418,-35399388,58612839,-118791510,1042444526,
+ 157042533,-68578815,40111884,-25482398,16519360,-10618135,6651200,-4007964,
+ 2296093,-1234720,613533,-275648,108259,-34988,8117,-778},
+{-5094,25290,-83940,223529,-513808,1059841,-2009826,3563862,
+ -5988369,9648900,-15094418,23287671,-36311088,60098272,-121627462,1040594200,
+ 162133139,-70643184,41296623,-26230699,17004258,-10930590,6847796,-4127150,
+ 2364896,-1272068,632310,-284211,111691,-36132,8397,-811},
+{-5191,25829,-85822,228697,-525944,1085274,-2058658,3651309,
+ -6136453,9888896,-15471226,23869373,-37213954,61568001,-124424360,1038692321,
+ 167246711,-72706771,42479482,-26977534,17488187,-11242464,7044075,-4246187,
+ 2433642,-1309406,651094,-292786,115132,-37280,8680,-844},
+{-5285,26357,-87674,233792,-537922,1110401,-2106937,3737817,
+ -6283015,10126508,-15844373,24445455,-38107883,63021880,-127182123,1036739066,
+ 172382883,-74769272,43660275,-27722784,17971069,-11553707,7240007,-4365055,
+ 2502322,-1346729,669884,-301370,118581,-38433,8964,-878},
+{-5376,26875,-89495,238812,-549741,1135219,-2154659,3823377,
+ -6428038,10361708,-16213815,25015847,-38992772,64459764,-129900673,1034734616,
+ 177541290,-76830380,44838817,-28466330,18452826,-11864267,7435560,-4483735,
+ 2570923,-1384029,688675,-309962,122036,-39590,9250,-913},
+{-5464,27383,-91286,243759,-561400,1159726,-2201817,3907978,
+ -6571505,10594467,-16579508,25580481,-39868518,65881511,-132579937,1032679158,
+ 182721560,-78889790,46014921,-29208052,18933380,-12174094,7630702,-4602207,
+ 2639435,-1421301,707465,-318561,125499,-40752,9539,-948},
+{-5551,27880,-93046,248630,-572899,1183919,-2248408,3991612,
+ -6713399,10824759,-16941407,26139291,-40735023,67286983,-135219849,1030572882,
+ 187923321,-80947193,47188401,-29947830,19412654,-12483138,7825400,-4720451,
+ 2707846,-1458539,726250,-327166,128968,-41917,9829,-983},
+{-5634,28367,-94776,253426,-584236,1207795,-2294427,4074270,
+ -6853705,11052557,-17299471,26692210,-41592189,68676043,-137820343,1028415984,
+ 193146197,-83002279,48359069,-30685545,19890568,-12791348,8019623,-4838449,
+ 2776145,-1495737,745027,-335774,132442,-43087,10121,-1019},
+{-5715,28843,-96475,258147,-595411,1231354,-2339868,4155942,
+ -6992407,11277833,-17653657,27239174,-42439921,70048559,-140381361,1026208663,
+ 198389808,-85054739,49526739,-31421077,20367045,-13098672,8213338,-4956180,
+ 2844320,-1532887,763794,-344386,135922,-44260,10415,-1056},
+{-5794,29309,-98143,262792,-606422,1254593,-2384728,4236620,
+ -7129490,11500563,-18003924,27780119,-43278122,71404400,-142902847,1023951123,
+ 203653772,-87104260,50691223,-32154306,20842006,-13405061,8406513,-5073626,
+ 2912361,-1569985,782548,-352998,139406,-45437,10711,-1093},
+{-5869,29765,-99780,267362,-617269,1277509,-2429002,4316296,
+ -7264938,11720721,-18350231,28314984,-44106702,72743440,-145384752,1021643575,
+ 208937703,-89150530,51852333,-32885112,21315374,-13710464,8599117,-5190766,
+ 2980255,-1607024,801284,-361610,142895,-46617,11008,-1131},
+{-5943,30211,-101387,271855,-627951,1300101,-2472686,4394961,
+ -7398736,11938282,-18692538,28843706,-44925569,74065554,-147827027,1019286232,
+ 214241215,-91193236,53009882,-33613376,21787069,-14014829,8791117,-5307580,
+ 3047991,-1643997,820000,-370221,146386,-47801,11308,-1169},
+{-6014,30646,-102962,276272,-638467,1322367,-2515775,4472607,
+ -7530871,12153222,-19030807,29366227,-45734635,75370621,-150229632,1016879312,
+ 219563916,-93232064,54163681,-34338976,22257013,-14318106,8982480,-5424049,
+ 3115558,-1680899,838693,-378828,149881,-48987,11608,-1208},
+{-6083,31071,-104507,280612,-648816,1344305,-2558266,4549226,
+ -7661327,12365516,-19364999,29882486,-46533812,76658523,-152592528,1014423038,
+ 224905412,-95266697,55313542,-35061793,22725129,-14620244,9173174,-5540154,
+ 3182945,-1717723,857359,-387431,153377,-50176,11911,-1248},
+{-6149,31485,-106021,284875,-658999,1365913,-2600155,4624811,
+ -7790091,12575142,-19695077,30392426,-47323014,77929143,-154915683,1011917638,
+ 230265307,-97296819,56459277,-35781707,23191337,-14921192,9363168,-5655874,
+ 3250139,-1754462,875996,-396028,156876,-51368,12215,-1288},
+{-6212,31890,-107504,289062,-669013,1387189,-2641437,4699354,
+ -7917150,12782077,-20021003,30895990,-48102159,79182370,-157199067,1009363343,
+ 235643201,-99322114,57600698,-36498598,23655560,-15220899,9552428,-5771189,
+ 3317129,-1791111,894599,-404617,160375,-52562,12521,-1328},
+{-6274,32284,-108956,293171,-678859,1408132,-2682110,4772848,
+ -8042490,12986297,-20342741,31393124,-48871164,80418094,-159442655,1006760389,
+ 241038692,-101342262,58737616,-37212347,24117719,-15519314,9740923,-5886081,
+ 3383904,-1827663,913167,-413197,163875,-53759,12828,-1369},
+{-6333,32668,-110377,297203,-688536,1428741,-2722169,4845286,
+ -8166098,13187782,-20660257,31883771,-49629949,81636209,-161646428,1004109018,
+ 246451376,-103356946,59869843,-37922832,24577735,-15816387,9928620,-6000528,
+ 3450452,-1864111,931695,-421766,167375,-54957,13136,-1411},
+{-6389,33042,-111767,301158,-698043,1449012,-2761610,4916660,
+ -8287962,13386509,-20973516,32367881,-50378436,82836609,-163810369,1001409474,
+ 251880846,-105365846,60997190,-38629935,25035532,-16112067,10115487,-6114512,
+ 3516761,-1900450,950181,-430324,170874,-56157,13446,-1453},
+{-6443,33406,-113127,305035,-707380,1468946,-2800432,4986964,
+ -8408069,13582458,-21282485,32845400,-51116549,84019196,-165934466,998662006,
+ 257326691,-107368642,62119469,-39333536,25491031,-16406303,10301492,-6228012,
+ 3582820,-1936673,968620,-438868,174371,-57359,13757,-1496},
+{-6495,33760,-114455,308834,-716547,1488541,-2838630,5056192,
+ -8526408,13775609,-21587129,33316277,-51844213,85183871,-168018713,995866869,
+ 262788500,-109365011,63236491,-40033515,25944154,-16699044,10486601,-6341008,
+ 3648618,-1972773,987011,-447397,177867,-58562,14069,-1539},
+{-6545,34103,-115753,312556,-725542,1507795,-2876201,5124337,
+ -8642967,13965941,-21887417,33780464,-52561355,86330539,-170063104,993024321,
+ 268265857,-111354634,64348069,-40729754,26394822,-16990240,10670784,-6453482,
+ 3714142,-2008744,1005349,-455909,181360,-59767,14383,-1583},
+{-6592,34437,-117019,316200,-734365,1526707,-2913143,5191392,
+ -8757734,14153436,-22183319,34237911,-53267904,87459108,-172067643,990134623,
+ 273758344,-113337187,65454014,-41422132,26842959,-17279840,10854008,-6565412,
+ 3779380,-2044580,1023631,-464403,184849,-60972,14698,-1627},
+{-6638,34761,-118255,319765,-743017,1545275,-2949452,5257354,
+ -8870699,14338073,-22474802,34688572,-53963792,88569489,-174032333,987198043,
+ 279265543,-115312348,66554137,-42110530,27288487,-17567793,11036240,-6676779,
+ 3844323,-2080274,1041854,-472877,188335,-62178,15014,-1672},
+{-6680,35075,-119461,323253,-751496,1563499,-2985125,5322214,
+ -8981851,14519836,-22761837,35132400,-54648951,89661596,-175957185,984214851,
+ 284787030,-117279794,67648252,-42794831,27731328,-17854050,11217448,-6787563,
+ 3908956,-2115820,1060015,-481331,191817,-63385,15331,-1717},
+{-6721,35379,-120635,326663,-759802,1581378,-3020161,5385969,
+ -9091180,14698706,-23044396,35569350,-55323315,90735347,-177842212,981185323,
+ 290322381,-119239201,68736169,-43474915,28171405,-18138560,11397601,-6897745,
+ 3973270,-2151211,1078110,-489761,195293,-64592,15649,-1763},
+{-6760,35673,-121779,329994,-767935,1598910,-3054556,5448612,
+ -9198675,14874666,-23322450,35999380,-55986821,91790661,-179687433,978109737,
+ 295871169,-121190244,69817703,-44150664,28608642,-18421272,11576666,-7007304,
+ 4037252,-2186441,1096136,-498167,198763,-65799,15968,-1809},
+{-6796,35957,-122892,333248,-775894,1616095,-3088307,5510138,
+ -9304328,15047699,-23595972,36422445,-56639408,92827461,-181492868,974988377,
+ 301432966,-123132599,70892665,-44821960,29042960,-18702136,11754611,-7116222,
+ 4100891,-2221503,1114089,-506547,202227,-67006,16288,-1856},
+{-6830,36232,-123975,336423,-783680,1632931,-3121414,5570543,
+ -9408128,15217788,-23864934,36838506,-57281015,93845673,-183258546,971821531,
+ 307007339,-125065940,71960868,-45488685,29474283,-18981103,11931405,-7224477,
+ 4164175,-2256391,1131967,-514900,205684,-68212,16609,-1903},
+{-6862,36497,-125027,339521,-791292,1649418,-3153873,5629822,
+ -9510068,15384919,-24129311,37247523,-57911584,94845225,-184984496,968609489,
+ 312593856,-126989944,73022127,-46150722,29902535,-19258123,12107015,-7332051,
+ 4227092,-2291098,1149766,-523223,209133,-69418,16930,-1951},
+{-6892,36752,-126048,342540,-798730,1665554,-3185682,5687970,
+ -9610137,15549075,-24389079,37649455,-58531059,95826050,-186670753,965352547,
+ 318192079,-128904283,74076254,-46807953,30327639,-19533145,12281409,-7438923,
+ 4289630,-2325618,1167482,-531516,212574,-70623,17253,-1999},
+{-6920,36998,-127040,345481,-805994,1681340,-3216839,5744983,
+ -9708328,15710242,-24644212,38044266,-59139386,96788082,-188317357,962051005,
+ 323801573,-130808632,75123063,-47460261,30749520,-19806120,12454556,-7545074,
+ 4351779,-2359945,1185113,-539777,216005,-71827,17576,-2048},
+{-6946,37234,-128001,348345,-813083,1696774,-3247343,5800857,
+ -9804632,15868406,-24894687,38431920,-59736513,97731258,-189924349,958705166,
+ 329421896,-132702665,76162369,-48107530,31168100,-20076999,12626424,-7650485,
+ 4413527,-2394071,1202654,-548004,219427,-73030,17899,-2097},
+{-6969,37461,-128932,351130,-819998,1711857,-3277191,5855588,
+ -9899043,16023553,-25140482,38812381,-60322388,98655520,-191491778,955315338,
+ 335052608,-134586055,77193987,-48749644,31583306,-20345733,12796982,-7755136,
+ 4474861,-2427991,1220103,-556195,222839,-74232,18224,-2147},
+{-6991,37678,-129832,353837,-826738,1726586,-3306383,5909172,
+ -9991552,16175670,-25381575,39185615,-60896964,99560811,-193019694,951881832,
+ 340693264,-136458477,78217732,-49386487,31995061,-20612271,12966197,-7859006,
+ 4535770,-2461698,1237456,-564350,226239,-75431,18548,-2197},
+{-7011,37886,-130703,356467,-833303,1740962,-3334916,5961606,
+ -10082152,16324745,-25617944,39551589,-61460193,100447077,-194508153,948404963,
+ 346343418,-138319603,79233420,-50017943,32403290,-20876566,13134039,-7962078,
+ 4596244,-2495185,1254709,-572466,229628,-76629,18873,-2247},
+{-7029,38085,-131544,359019,-839694,1754984,-3362789,6012886,
+ -10170838,16470764,-25849570,39910272,-62012030,101314268,-195957214,944885050,
+ 352002623,-140169107,80240866,-50643898,32807919,-21138568,13300476,-8064330,
+ 4656269,-2528446,1271860,-580541,233004,-77825,19199,-2298},
+{-7045,38274,-132355,361494,-845910,1768653,-3390001,6063009,
+ -10257602,16613716,-26076432,40261634,-62552432,102162335,-197366941,941322415,
+ 357670430,-142006662,81239889,-51264237,33208873,-21398228,13465477,-8165745,
+ 4715835,-2561475,1288905,-588575,236368,-79018,19524,-2350},
+{-7059,38454,-133136,363891,-851952,1781967,-3416550,6111972,
+ -10342439,16753592,-26298513,40605645,-63081357,102991235,-198737402,937717386,
+ 363346388,-143831942,82230303,-51878846,33606078,-21655499,13629011,-8266302,
+ 4774930,-2594265,1305840,-596565,239717,-80208,19850,-2401},
+{-7071,38625,-133888,366211,-857819,1794926,-3442436,6159773,
+ -10425342,16890378,-26515794,40942278,-63598768,103800926,-200068667,934070293,
+ 369030043,-145644621,83211929,-52487612,33999460,-21910332,13791046,-8365982,
+ 4833543,-2626809,1322662,-604511,243052,-81395,20177,-2454},
+{-7081,38787,-134610,368454,-863511,1807531,-3467658,6206408,
+ -10506306,17024067,-26728259,41271506,-64104625,104591368,-201360812,930381469,
+ 374720941,-147444371,84184584,-53090421,34388946,-22162679,13951553,-8464766,
+ 4891661,-2659101,1339369,-612409,246372,-82579,20503,-2506},
+{-7089,38940,-135303,370620,-869029,1819781,-3492214,6251876,
+ -10585327,17154648,-26935890,41593303,-64598893,105362526,-202613917,926651252,
+ 380418626,-149230868,85148088,-53687162,34774462,-22412492,14110500,-8562635,
+ 4949275,-2691135,1355955,-620259,249675,-83760,20829,-2559},
+{-7096,39084,-135966,372709,-874374,1831676,-3516105,6296175,
+ -10662399,17282111,-27138673,41907646,-65081538,106114366,-203828066,922879983,
+ 386122641,-151003783,86102259,-54277721,35155936,-22659723,14267856,-8659570,
+ 5006372,-2722904,1372419,-628059,252963,-84937,21155,-2612},
+{-7101,39219,-136601,374721,-879544,1843215,-3539328,6339302,
+ -10737518,17406450,-27336593,42214511,-65552529,106846859,-205003345,919068008,
+ 391832524,-152762793,87046920,-54861988,35533295,-22904326,14423591,-8755551,
+ 5062940,-2754402,1388756,-635808,256233,-86110,21482,-2666},
+{-7104,39346,-137206,376658,-884540,1854400,-3561885,6381255,
+ -10810680,17527655,-27529636,42513876,-66011835,107559977,-206139846,915215673,
+ 397547817,-154507570,87981890,-55439851,35906468,-23146253,14577676,-8850561,
+ 5118969,-2785622,1404964,-643504,259485,-87279,21808,-2720},
+{-7105,39463,-137783,378517,-889363,1865230,-3583774,6422034,
+ -10881881,17645719,-27717790,42805721,-66459427,108253695,-207237665,911323332,
+ 403268057,-156237791,88906992,-56011201,36275382,-23385458,14730078,-8944578,
+ 5174448,-2816558,1421038,-651144,262719,-88444,22133,-2774},
+{-7105,39572,-138330,380301,-894012,1875705,-3604995,6461636,
+ -10951118,17760636,-27901040,43090027,-66895281,108927993,-208296900,907391339,
+ 408992779,-157953129,89822049,-56575928,36639967,-23621893,14880770,-9037586,
+ 5229364,-2847204,1436976,-658728,265933,-89603,22459,-2829},
+{-7103,39672,-138850,382010,-898488,1885825,-3625548,6500061,
+ -11018388,17872398,-28079378,43366775,-67319370,109582851,-209317654,903420053,
+ 414721519,-159653261,90726884,-57133922,37000152,-23855513,15029719,-9129565,
+ 5283708,-2877552,1452774,-666254,269127,-90758,22784,-2884},
+{-7099,39764,-139341,383643,-902792,1895591,-3645432,6537307,
+ -11083687,17981000,-28252790,43635948,-67731673,110218254,-210300035,899409836,
+ 420453811,-161337862,91621322,-57685076,37355867,-24086271,15176898,-9220497,
+ 5337466,-2907598,1468429,-673721,272301,-91908,23109,-2939},
+{-7093,39848,-139803,385200,-906924,1905004,-3664649,6573374,
+ -11147013,18086436,-28421269,43897532,-68132168,110834189,-211244152,895361053,
+ 426189186,-163006609,92505188,-58229282,37707041,-24314121,15322277,-9310363,
+ 5390630,-2937334,1483937,-681126,275453,-93052,23433,-2995},
+{-7086,39922,-140238,386683,-910883,1914062,-3683198,6608261,
+ -11208364,18188702,-28584804,44151510,-68520837,111430646,-212150121,891274072,
+ 431927177,-164659179,93378307,-58766432,38053605,-24539019,15465825,-9399145,
+ 5443186,-2966755,1499295,-688468,278583,-94190,23756,-3051},
+{-7078,39989,-140644,388091,-914671,1922768,-3701078,6641968,
+ -11267739,18287794,-28743388,44397871,-68897661,112007617,-213018059,887149267,
+ 437667313,-166295249,94240508,-59296421,38395491,-24760919,15607514,-9486824,
+ 5495125,-2995853,1514500,-695745,281690,-95323,24079,-3107},
+{-7068,40048,-141023,389424,-918288,1931121,-3718292,6674494,
+ -11325135,18383706,-28897013,44636602,-69262627,112565098,-213848089,882987011,
+ 443409123,-167914496,95091619,-59819142,38732630,-24979776,15747314,-9573382,
+ 5546435,-3024623,1529548,-702956,284773,-96449,24401,-3163},
+{-7056,40098,-141374,390684,-921734,1939121,-3734838,6705840,
+ -11380552,18476436,-29045672,44867692,-69615720,113103088,-214640335,878787684,
+ 449152135,-169516601,95931467,-60334492,39064954,-25195546,15885198,-9658802,
+ 5597106,-3053058,1544436,-710099,287832,-97569,24722,-3220},
+{-7043,40140,-141698,391870,-925010,1946771,-3750718,6736005,
+ -11433988,18565981,-29189359,45091131,-69956929,113621587,-215394928,874551665,
+ 454895875,-171101242,96759884,-60842365,39392396,-25408185,16021136,-9743064,
+ 5647126,-3081153,1559161,-717173,290866,-98681,25043,-3277},
+{-7028,40174,-141995,392982,-928116,1954069,-3765932,6764990,
+ -11485443,18652339,-29328069,45306911,-70286244,114120600,-216112001,870279341,
+ 460639870,-172668098,97576700,-61342660,39714889,-25617648,16155100,-9826151,
+ 5696485,-3108900,1573720,-724176,293875,-99787,25362,-3334},
+{-7012,40200,-142264,394021,-931053,1961017,-3780481,6792795,
+ -11534917,18735508,-29461799,45515025,-70603657,114600134,-216791689,865971098,
+ 466383645,-174216852,98381747,-61835272,40032366,-25823892,16287061,-9908045,
+ 5745171,-3136294,1588108,-731105,296857,-100886,25680,-3392},
+{-6994,40219,-142506,394988,-933822,1967616,-3794366,6819421,
+ -11582410,18815486,-29590544,45715466,-70909162,115060198,-217434134,861627327,
+ 472126723,-175747185,99174860,-62320100,40344762,-26026874,16416993,-9988729,
+ 5793175,-3163329,1602323,-737961,299812,-101976,25997,-3449},
+{-6976,40229,-142722,395882,-936422,1973866,-3807588,6844869,
+ -11627921,18892273,-29714301,45908231,-71202753,115500804,-218039479,857248421,
+ 477868629,-177258779,99955871,-62797045,40652011,-26226551,16544866,-10068185,
+ 5840485,-3189998,1616362,-744740,302739,-103059,26313,-3507},
+{-6955,40232,-142911,396704,-938855,1979769,-3820148,6869140,
+ -11671452,18965868,-29833069,46093314,-71484430,115921967,-218607872,852834777,
+ 483608883,-178751317,100724617,-63266004,40954049,-26422881,16670653,-10146396,
+ 5887091,-3216295,1630220,-751442,305637,-104134,26628,-3565},
+{-6933,40228,-143074,397454,-941121,1985325,-3832047,6892236,
+ -11713004,19036272,-29946847,46270714,-71754190,116323706,-219139463,848386794,
+ 489347009,-180224484,101480934,-63726881,41250812,-26615822,16794327,-10223343,
+ 5932983,-3242215,1643896,-758064,308506,-105201,26941,-3623},
+{-6910,40216,-143211,398133,-943221,1990535,-3843286,6914157,
+ -11752578,19103485,-30055634,46440429,-72012035,116706040,-219634407,843904874,
+ 495082528,-181677966,102224660,-64179575,41542236,-26805331,16915861,-10299011,
+ 5978150,-3267751,1657385,-764606,311346,-106259,27253,-3681},
+{-6886,40196,-143322,398742,-945156,1995400,-3853867,6934905,
+ -11790176,19167508,-30159430,46602459,-72257968,117068994,-220092863,839389422,
+ 500814959,-183111447,102955635,-64623991,41828259,-26991368,17035227,-10373382,
+ 6022581,-3292898,1670685,-771065,314154,-107308,27563,-3739},
+{-6861,40169,-143407,399279,-946926,1999922,-3863791,6954482,
+ -11825799,19228343,-30258236,46756806,-72491993,117412592,-220514991,834840845,
+ 506543823,-184524617,103673698,-65060030,42108818,-27173892,17152400,-10446439,
+ 6066266,-3317648,1683792,-777440,316931,-108347,27872,-3798},
+{-6834,40135,-143466,399747,-948531,2004101,-3873059,6972891,
+ -11859449,19285992,-30352055,46903470,-72714116,117736864,-220900956,830259554,
+ 512268639,-185917162,104378691,-65487599,42383851,-27352862,17267353,-10518165,
+ 6109195,-3341997,1696703,-783729,319676,-109377,28179,-3856},
+{-6806,40093,-143501,400145,-949974,2007938,-3881674,6990132,
+ -11891130,19340457,-30440889,47042457,-72924346,118041841,-221250927,825645961,
+ 517988926,-187288773,105070458,-65906603,42653298,-27528238,17380059,-10588544,
+ 6151358,-3365939,1709414,-789931,322388,-110398,28484,-3915},
+{-6776,40045,-143510,400474,-951254,2011436,-3889638,7006210,
+ -11920843,19391743,-30524742,47173770,-73122692,118327556,-221565075,821000482,
+ 523704203,-188639140,105748842,-66316947,42917098,-27699981,17490493,-10657559,
+ 6192745,-3389467,1721924,-796045,325067,-111408,28787,-3974},
+{-6746,39989,-143494,400734,-952372,2014594,-3896951,7021125,
+ -11948593,19439852,-30603617,47297414,-73309167,118594047,-221843575,816323536,
+ 529413989,-189967956,106413689,-66718539,43175192,-27868050,17598629,-10725193,
+ 6233346,-3412576,1734227,-802067,327711,-112408,29089,-4033},
+{-6714,39927,-143453,400926,-953329,2017415,-3903616,7034881,
+ -11974382,19484788,-30677520,47413398,-73483783,118841352,-222086606,811615542,
+ 535117799,-191274913,107064847,-67111289,43427521,-28032409,17704442,-10791432,
+ 6273150,-3435260,1746322,-807998,330320,-113398,29388,-4091},
+{-6682,39858,-143388,401049,-954126,2019900,-3909636,7047480,
+ -11998214,19526556,-30746455,47521728,-73646555,119069514,-222294350,806876923,
+ 540815154,-192559706,107702163,-67495105,43674026,-28193017,17807907,-10856258,
+ 6312148,-3457514,1758205,-813835,332894,-114376,29685,-4150},
+{-6648,39782,-143299,401106,-954764,2022049,-3915012,7058926,
+ -12020093,19565161,-30810431,47622415,-73797501,119278577,-222466989,802108106,
+ 546505569,-193822031,108325488,-67869897,43914650,-28349837,17908998,-10919656,
+ 6350331,-3479331,1769873,-819577,335431,-115344,29980,-4209},
+{-6613,39699,-143186,401095,-955243,2023866,-3919746,7069221,
+ -12040023,19600609,-30869453,47715468,-73936638,119468588,-222604714,797309517,
+ 552188563,-195061584,108934673,-68235578,44149336,-28502832,18007692,-10981610,
+ 6387688,-3500705,1781323,-825222,337931,-116300,30273,-4268},
+{-6577,39610,-143049,401018,-955565,2025351,-3923841,7078370,
+ -12058010,19632906,-30923531,47800898,-74063988,119639596,-222707716,792481587,
+ 557863652,-196278065,109529571,-68592061,44378027,-28651965,18103964,-11042105,
+ 6424210,-3521633,1792552,-830769,340393,-117244,30563,-4326},
+{-6540,39514,-142888,400875,-955731,2026505,-3927299,7086375,
+ -12074057,19662057,-30972671,47878719,-74179571,119791653,-222776187,787624748,
+ 563530353,-197471174,110110036,-68939258,44600670,-28797199,18197789,-11101125,
+ 6459888,-3542107,1803557,-836216,342816,-118177,30851,-4385},
+{-6502,39412,-142704,400667,-955740,2027331,-3930122,7093241,
+ -12088170,19688071,-31016885,47948943,-74283412,119924815,-222810327,782739435,
+ 569188183,-198640612,110675925,-69277085,44817208,-28938498,18289146,-11158655,
+ 6494712,-3562122,1814334,-841561,345201,-119097,31136,-4444},
+{-6463,39304,-142497,400393,-955595,2027829,-3932315,7098971,
+ -12100354,19710954,-31056181,48011586,-74375536,120039138,-222810336,777826085,
+ 574836661,-199786082,111227095,-69605457,45027588,-29075826,18378009,-11214680,
+ 6528673,-3581673,1824881,-846804,347545,-120004,31419,-4502},
+{-6423,39189,-142267,400056,-955297,2028003,-3933878,7103569,
+ -12110615,19730714,-31090571,48066664,-74455970,120134682,-222776417,772885136,
+ 580475302,-200907289,111763405,-69924293,45231756,-29209149,18464356,-11269185,
+ 6561761,-3600754,1835195,-851942,349849,-120899,31699,-4561},
+{-6383,39068,-142015,399654,-954846,2027853,-3934815,7107039,
+ -12118959,19747359,-31120066,48114193,-74524742,120211509,-222708777,767917029,
+ 586103624,-202003940,112284716,-70233510,45429662,-29338432,18548164,-11322156,
+ 6593968,-3619361,1845273,-856974,352112,-121781,31976,-4619},
+{-6341,38941,-141740,399189,-954243,2027381,-3935129,7109386,
+ -12125393,19760899,-31144679,48154192,-74581884,120269684,-222607626,762922208,
+ 591721146,-203075742,112790891,-70533027,45621252,-29463641,18629412,-11373577,
+ 6625284,-3637487,1855111,-861899,354332,-122649,32250,-4677},
+{-6298,38809,-141443,398661,-953490,2026589,-3934822,7110614,
+ -12129922,19771342,-31164423,48186680,-74627426,120309274,-222473176,757901118,
+ 597327384,-204122404,113281793,-70822766,45806476,-29584743,18708076,-11423436,
+ 6655701,-3655127,1864707,-866715,356510,-123504,32521,-4735},
+{-6255,38670,-141124,398070,-952587,2025479,-3933898,7110728,
+ -12132554,19778698,-31179311,48211677,-74661402,120330347,-222305643,752854204,
+ 602921856,-205143639,113757289,-71102648,45985284,-29701704,18784134,-11471717,
+ 6685209,-3672276,1874058,-871420,358644,-124345,32789,-4793},
+{-6211,38526,-140783,397418,-951535,2024052,-3932360,7109733,
+ -12133295,19782978,-31189357,48229204,-74683849,120332977,-222105246,747781917,
+ 608504083,-206139160,114217246,-71372596,46157627,-29814491,18857566,-11518407,
+ 6713801,-3688930,1883162,-876013,360734,-125171,33054,-4851},
+{-6166,38376,-140421,396705,-950336,2022312,-3930211,7107633,
+ -12132153,19784191,-31194578,48239284,-74694801,120317238,-221872206,742684706,
+ 614073581,-207108681,114661533,-71632535,46323457,-29923074,18928351,-11563491,
+ 6741468,-3705082,1892014,-880493,362779,-125983,33316,-4908},
+{-6120,38220,-140038,395931,-948991,2020259,-3927454,7104435,
+ -12129137,19782349,-31194988,48241941,-74694299,120283205,-221606747,737563025,
+ 619629872,-208051919,115090023,-71882391,46482726,-30027421,18996467,-11606958,
+ 6768200,-3720729,1900613,-884858,364779,-126781,33574,-4965},
+{-6074,38059,-139634,395097,-947501,2017896,-3924093,7100142,
+ -12124252,19777464,-31190604,48237198,-74682382,120230958,-221309097,732417327,
+ 625172473,-208968594,115502586,-72122089,46635388,-30127500,19061894,-11648793,
+ 6793991,-3735864,1908955,-889106,366733,-127563,33829,-5022},
+{-6026,37893,-139209,394204,-945867,2015225,-3920131,7094761,
+ -12117509,19769546,-31181443,48225082,-74659091,120160578,-220979484,727248068,
+ 630700907,-209858426,115899100,-72351559,46781396,-30223281,19124611,-11688983,
+ 6818831,-3750483,1917039,-893237,368640,-128330,34080,-5079},
+{-5978,37721,-138764,393251,-944090,2012248,-3915572,7088297,
+ -12108914,19758609,-31167524,48205620,-74624470,120072149,-220618141,722055705,
+ 636214695,-210721137,116279439,-72570730,46920707,-30314736,19184600,-11727515,
+ 6842712,-3764581,1924860,-897248,370499,-129081,34328,-5135},
+{-5930,37544,-138298,392241,-942171,2008967,-3910419,7080756,
+ -12098477,19744665,-31148864,48178838,-74578563,119965757,-220225304,716840698,
+ 641713357,-211556453,116643483,-72779532,47053275,-30401834,19241841,-11764376,
+ 6865627,-3778154,1932416,-901139,372310,-129817,34572,-5191},
+{-5881,37362,-137813,391172,-940112,2005384,-3904677,7072143,
+ -12086207,19727728,-31125483,48144765,-74521417,119841489,-219801211,711603508,
+ 647196416,-212364099,116991112,-72977898,47179058,-30484546,19296315,-11799555,
+ 6887567,-3791195,1939706,-904907,374072,-130537,34812,-5247},
+{-5831,37175,-137308,390047,-937914,2001502,-3898348,7062465,
+ -12072113,19707810,-31097401,48103432,-74453079,119699437,-219346101,706344596,
+ 652663396,-213143806,117322208,-73165761,47298014,-30562846,19348002,-11833039,
+ 6908525,-3803702,1946725,-908552,375785,-131240,35048,-5302},
+{-5780,36983,-136784,388865,-935578,1997323,-3891436,7051729,
+ -12056204,19684926,-31064638,48054869,-74373600,119539693,-218860218,701064425,
+ 658113820,-213895304,117636657,-73343056,47410101,-30636706,19396885,-11864816,
+ 6928493,-3815669,1953471,-912073,377448,-131926,35280,-5357},
+{-5729,36786,-136241,387627,-933105,1992848,-3883947,7039939,
+ -12038490,19659090,-31027216,47999108,-74283029,119362352,-218343807,695763461,
+ 663547215,-214618326,117934343,-73509718,47515278,-30706098,19442946,-11894873,
+ 6947464,-3827091,1959943,-915467,379060,-132595,35508,-5412},
+{-5677,36584,-135679,386333,-930496,1988081,-3875883,7027103,
+ -12018981,19630317,-30985155,47936181,-74181419,119167510,-217797117,690442170,
+ 668963104,-215312608,118215156,-73665687,47613507,-30770997,19486168,-11923201,
+ 6965430,-3837965,1966136,-918733,380620,-133248,35732,-5466},
+{-5625,36378,-135098,384985,-927753,1983024,-3867248,7013227,
+ -11997687,19598623,-30938480,47866122,-74068824,118955267,-217220397,685101020,
+ 674361016,-215977886,118478986,-73810900,47704749,-30831377,19526532,-11949786,
+ 6982384,-3848285,1972049,-921871,382128,-133882,35952,-5519},
+{-5573,36167,-134499,383583,-924878,1977679,-3858048,6998319,
+ -11974618,19564023,-30887213,47788967,-73945299,118725725,-216613902,679740479,
+ 679740479,-216613902,118725725,-73945299,47788967,-30887213,19564023,-11974618,
+ 6998319,-3858048,1977679,-924878,383583,-134499,36167,-5573},
+{-5519,35952,-133882,382128,-921871,1972049,-3848285,6982384,
+ -11949786,19526532,-30831377,47704749,-73810900,118478986,-215977886,674361016,
+ 685101020,-217220397,118955267,-74068824,47866122,-30938480,19598623,-11997687,
+ 7013227,-3867248,1983024,-927753,384985,-135098,36378,-5625},
+{-5466,35732,-133248,380620,-918733,1966136,-3837965,6965430,
+ -11923201,19486168,-30770997,47613507,-73665687,118215156,-215312608,668963104,
+ 690442170,-217797117,119167510,-74181419,47936181,-30985155,19630317,-12018981,
+ 7027103,-3875883,1988081,-930496,386333,-135679,36584,-5677},
+{-5412,35508,-132595,379060,-915467,1959943,-3827091,6947464,
+ -11894873,19442946,-30706098,47515278,-73509718,117934343,-214618326,663547215,
+ 695763461,-218343807,119362352,-74283029,47999108,-31027216,19659090,-12038490,
+ 7039939,-3883947,1992848,-933105,387627,-136241,36786,-5729},
+{-5357,35280,-131926,377448,-912073,1953471,-3815669,6928493,
+ -11864816,19396885,-30636706,47410101,-73343056,117636657,-213895304,658113820,
+ 701064425,-218860218,119539693,-74373600,48054869,-31064638,19684926,-12056204,
+ 7051729,-3891436,1997323,-935578,388865,-136784,36983,-5780},
+{-5302,35048,-131240,375785,-908552,1946725,-3803702,6908525,
+ -11833039,19348002,-30562846,47298014,-73165761,117322208,-213143806,652663396,
+ 706344596,-219346101,119699437,-74453079,48103432,-31097401,19707810,-12072113,
+ 7062465,-3898348,2001502,-937914,390047,-137308,37175,-5831},
+{-5247,34812,-130537,374072,-904907,1939706,-3791195,6887567,
+ -11799555,19296315,-30484546,47179058,-72977898,116991112,-212364099,647196416,
+ 711603508,-219801211,119841489,-74521417,48144765,-31125483,19727728,-12086207,
+ 7072143,-3904677,2005384,-940112,391172,-137813,37362,-5881},
+{-5191,34572,-129817,372310,-901139,1932416,-3778154,6865627,
+ -11764376,19241841,-30401834,47053275,-72779532,116643483,-211556453,641713357,
+ 716840698,-220225304,119965757,-74578563,48178838,-31148864,19744665,-12098477,
+ 7080756,-3910419,2008967,-942171,392241,-138298,37544,-5930},
+{-5135,34328,-129081,370499,-897248,1924860,-3764581,6842712,
+ -11727515,19184600,-30314736,46920707,-72570730,116279439,-210721137,636214695,
+ 722055705,-220618141,120072149,-74624470,48205620,-31167524,19758609,-12108914,
+ 7088297,-3915572,2012248,-944090,393251,-138764,37721,-5978},
+{-5079,34080,-128330,368640,-893237,1917039,-3750483,6818831,
+ -11688983,19124611,-30223281,46781396,-72351559,115899100,-209858426,630700907,
+ 727248068,-220979484,120160578,-74659091,48225082,-31181443,19769546,-12117509,
+ 7094761,-3920131,2015225,-945867,394204,-139209,37893,-6026},
+{-5022,33829,-127563,366733,-889106,1908955,-3735864,6793991,
+ -11648793,19061894,-30127500,46635388,-72122089,115502586,-208968594,625172473,
+ 732417327,-221309097,120230958,-74682382,48237198,-31190604,19777464,-12124252,
+ 7100142,-3924093,2017896,-947501,395097,-139634,38059,-6074},
+{-4965,33574,-126781,364779,-884858,1900613,-3720729,6768200,
+ -11606958,18996467,-30027421,46482726,-71882391,115090023,-208051919,619629872,
+ 737563025,-221606747,120283205,-74694299,48241941,-31194988,19782349,-12129137,
+ 7104435,-3927454,2020259,-948991,395931,-140038,38220,-6120},
+{-4908,33316,-125983,362779,-880493,1892014,-3705082,6741468,
+ -11563491,18928351,-29923074,46323457,-71632535,114661533,-207108681,614073581,
+ 742684706,-221872206,120317238,-74694801,48239284,-31194578,19784191,-12132153,
+ 7107633,-3930211,2022312,-950336,396705,-140421,38376,-6166},
+{-4851,33054,-125171,360734,-876013,1883162,-3688930,6713801,
+ -11518407,18857566,-29814491,46157627,-71372596,114217246,-206139160,608504083,
+ 747781917,-222105246,120332977,-74683849,48229204,-31189357,19782978,-12133295,
+ 7109733,-3932360,2024052,-951535,397418,-140783,38526,-6211},
+{-4793,32789,-124345,358644,-871420,1874058,-3672276,6685209,
+ -11471717,18784134,-29701704,45985284,-71102648,113757289,-205143639,602921856,
+ 752854204,-222305643,120330347,-74661402,48211677,-31179311,19778698,-12132554,
+ 7110728,-3933898,2025479,-952587,398070,-141124,38670,-6255},
+{-4735,32521,-123504,356510,-866715,1864707,-3655127,6655701,
+ -11423436,18708076,-29584743,45806476,-70822766,113281793,-204122404,597327384,
+ 757901118,-222473176,120309274,-74627426,48186680,-31164423,19771342,-12129922,
+ 7110614,-3934822,2026589,-953490,398661,-141443,38809,-6298},
+{-4677,32250,-122649,354332,-861899,1855111,-3637487,6625284,
+ -11373577,18629412,-29463641,45621252,-70533027,112790891,-203075742,591721146,
+ 762922208,-222607626,120269684,-74581884,48154192,-31144679,19760899,-12125393,
+ 7109386,-3935129,2027381,-954243,399189,-141740,38941,-6341},
+{-4619,31976,-121781,352112,-856974,1845273,-3619361,6593968,
+ -11322156,18548164,-29338432,45429662,-70233510,112284716,-202003940,586103624,
+ 767917029,-222708777,120211509,-74524742,48114193,-31120066,19747359,-12118959,
+ 7107039,-3934815,2027853,-954846,399654,-142015,39068,-6383},
+{-4561,31699,-120899,349849,-851942,1835195,-3600754,6561761,
+ -11269185,18464356,-29209149,45231756,-69924293,111763405,-200907289,580475302,
+ 772885136,-222776417,120134682,-74455970,48066664,-31090571,19730714,-12110615,
+ 7103569,-3933878,2028003,-955297,400056,-142267,39189,-6423},
+{-4502,31419,-120004,347545,-846804,1824881,-3581673,6528673,
+ -11214680,18378009,-29075826,45027588,-69605457,111227095,-199786082,574836661,
+ 777826085,-222810336,120039138,-74375536,48011586,-31056181,19710954,-12100354,
+ 7098971,-3932315,2027829,-955595,400393,-142497,39304,-6463},
+{-4444,31136,-119097,345201,-841561,1814334,-3562122,6494712,
+ -11158655,18289146,-28938498,44817208,-69277085,110675925,-198640612,569188183,
+ 782739435,-222810327,119924815,-74283412,47948943,-31016885,19688071,-12088170,
+ 7093241,-3930122,2027331,-955740,400667,-142704,39412,-6502},
+{-4385,30851,-118177,342816,-836216,1803557,-3542107,6459888,
+ -11101125,18197789,-28797199,44600670,-68939258,110110036,-197471174,563530353,
+ 787624748,-222776187,119791653,-74179571,47878719,-30972671,19662057,-12074057,
+ 7086375,-3927299,2026505,-955731,400875,-142888,39514,-6540},
+{-4326,30563,-117244,340393,-830769,1792552,-3521633,6424210,
+ -11042105,18103964,-28651965,44378027,-68592061,109529571,-196278065,557863652,
+ 792481587,-222707716,119639596,-74063988,47800898,-30923531,19632906,-12058010,
+ 7078370,-3923841,2025351,-955565,401018,-143049,39610,-6577},
+{-4268,30273,-116300,337931,-825222,1781323,-3500705,6387688,
+ -10981610,18007692,-28502832,44149336,-68235578,108934673,-195061584,552188563,
+ 797309517,-222604714,119468588,-73936638,47715468,-30869453,19600609,-12040023,
+ 7069221,-3919746,2023866,-955243,401095,-143186,39699,-6613},
+{-4209,29980,-115344,335431,-819577,1769873,-3479331,6350331,
+ -10919656,17908998,-28349837,43914650,-67869897,108325488,-193822031,546505569,
+ 802108106,-222466989,119278577,-73797501,47622415,-30810431,19565161,-12020093,
+ 7058926,-3915012,2022049,-954764,401106,-143299,39782,-6648},
+{-4150,29685,-114376,332894,-813835,1758205,-3457514,6312148,
+ -10856258,17807907,-28193017,43674026,-67495105,107702163,-192559706,540815154,
+ 806876923,-222294350,119069514,-73646555,47521728,-30746455,19526556,-11998214,
+ 7047480,-3909636,2019900,-954126,401049,-143388,39858,-6682},
+{-4091,29388,-113398,330320,-807998,1746322,-3435260,6273150,
+ -10791432,17704442,-28032409,43427521,-67111289,107064847,-191274913,535117799,
+ 811615542,-222086606,118841352,-73483783,47413398,-30677520,19484788,-11974382,
+ 7034881,-3903616,2017415,-953329,400926,-143453,39927,-6714},
+{-4033,29089,-112408,327711,-802067,1734227,-3412576,6233346,
+ -10725193,17598629,-27868050,43175192,-66718539,106413689,-189967956,529413989,
+ 816323536,-221843575,118594047,-73309167,47297414,-30603617,19439852,-11948593,
+ 7021125,-3896951,2014594,-952372,400734,-143494,39989,-6746},
+{-3974,28787,-111408,325067,-796045,1721924,-3389467,6192745,
+ -10657559,17490493,-27699981,42917098,-66316947,105748842,-188639140,523704203,
+ 821000482,-221565075,118327556,-73122692,47173770,-30524742,19391743,-11920843,
+ 7006210,-3889638,2011436,-951254,400474,-143510,40045,-6776},
+{-3915,28484,-110398,322388,-789931,1709414,-3365939,6151358,
+ -10588544,17380059,-27528238,42653298,-65906603,105070458,-187288773,517988926,
+ 825645961,-221250927,118041841,-72924346,47042457,-30440889,19340457,-11891130,
+ 6990132,-3881674,2007938,-949974,400145,-143501,40093,-6806},
+{-3856,28179,-109377,319676,-783729,1696703,-3341997,6109195,
+ -10518165,17267353,-27352862,42383851,-65487599,104378691,-185917162,512268639,
+ 830259554,-220900956,117736864,-72714116,46903470,-30352055,19285992,-11859449,
+ 6972891,-3873059,2004101,-948531,399747,-143466,40135,-6834},
+{-3798,27872,-108347,316931,-777440,1683792,-3317648,6066266,
+ -10446439,17152400,-27173892,42108818,-65060030,103673698,-184524617,506543823,
+ 834840845,-220514991,117412592,-72491993,46756806,-30258236,19228343,-11825799,
+ 6954482,-3863791,1999922,-946926,399279,-143407,40169,-6861},
+{-3739,27563,-107308,314154,-771065,1670685,-3292898,6022581,
+ -10373382,17035227,-26991368,41828259,-64623991,102955635,-183111447,500814959,
+ 839389422,-220092863,117068994,-72257968,46602459,-30159430,19167508,-11790176,
+ 6934905,-3853867,1995400,-945156,398742,-143322,40196,-6886},
+{-3681,27253,-106259,311346,-764606,1657385,-3267751,5978150,
+ -10299011,16915861,-26805331,41542236,-64179575,102224660,-181677966,495082528,
+ 843904874,-219634407,116706040,-72012035,46440429,-30055634,19103485,-11752578,
+ 6914157,-3843286,1990535,-943221,398133,-143211,40216,-6910},
+{-3623,26941,-105201,308506,-758064,1643896,-3242215,5932983,
+ -10223343,16794327,-26615822,41250812,-63726881,101480934,-180224484,489347009,
+ 848386794,-219139463,116323706,-71754190,46270714,-29946847,19036272,-11713004,
+ 6892236,-3832047,1985325,-941121,397454,-143074,40228,-6933},
+{-3565,26628,-104134,305637,-751442,1630220,-3216295,5887091,
+ -10146396,16670653,-26422881,40954049,-63266004,100724617,-178751317,483608883,
+ 852834777,-218607872,115921967,-71484430,46093314,-29833069,18965868,-11671452,
+ 6869140,-3820148,1979769,-938855,396704,-142911,40232,-6955},
+{-3507,26313,-103059,302739,-744740,1616362,-3189998,5840485,
+ -10068185,16544866,-26226551,40652011,-62797045,99955871,-177258779,477868629,
+ 857248421,-218039479,115500804,-71202753,45908231,-29714301,18892273,-11627921,
+ 6844869,-3807588,1973866,-936422,395882,-142722,40229,-6976},
+{-3449,25997,-101976,299812,-737961,1602323,-3163329,5793175,
+ -9988729,16416993,-26026874,40344762,-62320100,99174860,-175747185,472126723,
+ 861627327,-217434134,115060198,-70909162,45715466,-29590544,18815486,-11582410,
+ 6819421,-3794366,1967616,-933822,394988,-142506,40219,-6994},
+{-3392,25680,-100886,296857,-731105,1588108,-3136294,5745171,
+ -9908045,16287061,-25823892,40032366,-61835272,98381747,-174216852,466383645,
+ 865971098,-216791689,114600134,-70603657,45515025,-29461799,18735508,-11534917,
+ 6792795,-3780481,1961017,-931053,394021,-142264,40200,-7012},
+{-3334,25362,-99787,293875,-724176,1573720,-3108900,5696485,
+ -9826151,16155100,-25617648,39714889,-61342660,97576700,-172668098,460639870,
+ 870279341,-216112001,114120600,-70286244,45306911,-29328069,18652339,-11485443,
+ 6764990,-3765932,1954069,-928116,392982,-141995,40174,-7028},
+{-3277,25043,-98681,290866,-717173,1559161,-3081153,5647126,
+ -9743064,16021136,-25408185,39392396,-60842365,96759884,-171101242,454895875,
+ 874551665,-215394928,113621587,-69956929,45091131,-29189359,18565981,-11433988,
+ 6736005,-3750718,1946771,-925010,391870,-141698,40140,-7043},
+{-3220,24722,-97569,287832,-710099,1544436,-3053058,5597106,
+ -9658802,15885198,-25195546,39064954,-60334492,95931467,-169516601,449152135,
+ 878787684,-214640335,113103088,-69615720,44867692,-29045672,18476436,-11380552,
+ 6705840,-3734838,1939121,-921734,390684,-141374,40098,-7056},
+{-3163,24401,-96449,284773,-702956,1529548,-3024623,5546435,
+ -9573382,15747314,-24979776,38732630,-59819142,95091619,-167914496,443409123,
+ 882987011,-213848089,112565098,-69262627,44636602,-28897013,18383706,-11325135,
+ 6674494,-3718292,1931121,-918288,389424,-141023,40048,-7068},
+{-3107,24079,-95323,281690,-695745,1514500,-2995853,5495125,
+ -9486824,15607514,-24760919,38395491,-59296421,94240508,-166295249,437667313,
+ 887149267,-213018059,112007617,-68897661,44397871,-28743388,18287794,-11267739,
+ 6641968,-3701078,1922768,-914671,388091,-140644,39989,-7078},
+{-3051,23756,-94190,278583,-688468,1499295,-2966755,5443186,
+ -9399145,15465825,-24539019,38053605,-58766432,93378307,-164659179,431927177,
+ 891274072,-212150121,111430646,-68520837,44151510,-28584804,18188702,-11208364,
+ 6608261,-3683198,1914062,-910883,386683,-140238,39922,-7086},
+{-2995,23433,-93052,275453,-681126,1483937,-2937334,5390630,
+ -9310363,15322277,-24314121,37707041,-58229282,92505188,-163006609,426189186,
+ 895361053,-211244152,110834189,-68132168,43897532,-28421269,18086436,-11147013,
+ 6573374,-3664649,1905004,-906924,385200,-139803,39848,-7093},
+{-2939,23109,-91908,272301,-673721,1468429,-2907598,5337466,
+ -9220497,15176898,-24086271,37355867,-57685076,91621322,-161337862,420453811,
+ 899409836,-210300035,110218254,-67731673,43635948,-28252790,17981000,-11083687,
+ 6537307,-3645432,1895591,-902792,383643,-139341,39764,-7099},
+{-2884,22784,-90758,269127,-666254,1452774,-2877552,5283708,
+ -9129565,15029719,-23855513,37000152,-57133922,90726884,-159653261,414721519,
+ 903420053,-209317654,109582851,-67319370,43366775,-28079378,17872398,-11018388,
+ 6500061,-3625548,1885825,-898488,382010,-138850,39672,-7103},
+{-2829,22459,-89603,265933,-658728,1436976,-2847204,5229364,
+ -9037586,14880770,-23621893,36639967,-56575928,89822049,-157953129,408992779,
+ 907391339,-208296900,108927993,-66895281,43090027,-27901040,17760636,-10951118,
+ 6461636,-3604995,1875705,-894012,380301,-138330,39572,-7105},
+{-2774,22133,-88444,262719,-651144,1421038,-2816558,5174448,
+ -8944578,14730078,-23385458,36275382,-56011201,88906992,-156237791,403268057,
+ 911323332,-207237665,108253695,-66459427,42805721,-27717790,17645719,-10881881,
+ 6422034,-3583774,1865230,-889363,378517,-137783,39463,-7105},
+{-2720,21808,-87279,259485,-643504,1404964,-2785622,5118969,
+ -8850561,14577676,-23146253,35906468,-55439851,87981890,-154507570,397547817,
+ 915215673,-206139846,107559977,-66011835,42513876,-27529636,17527655,-10810680,
+ 6381255,-3561885,1854400,-884540,376658,-137206,39346,-7104},
+{-2666,21482,-86110,256233,-635808,1388756,-2754402,5062940,
+ -8755551,14423591,-22904326,35533295,-54861988,87046920,-152762793,391832524,
+ 919068008,-205003345,106846859,-65552529,42214511,-27336593,17406450,-10737518,
+ 6339302,-3539328,1843215,-879544,374721,-136601,39219,-7101},
+{-2612,21155,-84937,252963,-628059,1372419,-2722904,5006372,
+ -8659570,14267856,-22659723,35155936,-54277721,86102259,-151003783,386122641,
+ 922879983,-203828066,106114366,-65081538,41907646,-27138673,17282111,-10662399,
+ 6296175,-3516105,1831676,-874374,372709,-135966,39084,-7096},
+{-2559,20829,-83760,249675,-620259,1355955,-2691135,4949275,
+ -8562635,14110500,-22412492,34774462,-53687162,85148088,-149230868,380418626,
+ 926651252,-202613917,105362526,-64598893,41593303,-26935890,17154648,-10585327,
+ 6251876,-3492214,1819781,-869029,370620,-135303,38940,-7089},
+{-2506,20503,-82579,246372,-612409,1339369,-2659101,4891661,
+ -8464766,13951553,-22162679,34388946,-53090421,84184584,-147444371,374720941,
+ 930381469,-201360812,104591368,-64104625,41271506,-26728259,17024067,-10506306,
+ 6206408,-3467658,1807531,-863511,368454,-134610,38787,-7081},
+{-2454,20177,-81395,243052,-604511,1322662,-2626809,4833543,
+ -8365982,13791046,-21910332,33999460,-52487612,83211929,-145644621,369030043,
+ 934070293,-200068667,103800926,-63598768,40942278,-26515794,16890378,-10425342,
+ 6159773,-3442436,1794926,-857819,366211,-133888,38625,-7071},
+{-2401,19850,-80208,239717,-596565,1305840,-2594265,4774930,
+ -8266302,13629011,-21655499,33606078,-51878846,82230303,-143831942,363346388,
+ 937717386,-198737402,102991235,-63081357,40605645,-26298513,16753592,-10342439,
+ 6111972,-3416550,1781967,-851952,363891,-133136,38454,-7059},
+{-2350,19524,-79018,236368,-588575,1288905,-2561475,4715835,
+ -8165745,13465477,-21398228,33208873,-51264237,81239889,-142006662,357670430,
+ 941322415,-197366941,102162335,-62552432,40261634,-26076432,16613716,-10257602,
+ 6063009,-3390001,1768653,-845910,361494,-132355,38274,-7045},
+{-2298,19199,-77825,233004,-580541,1271860,-2528446,4656269,
+ -8064330,13300476,-21138568,32807919,-50643898,80240866,-140169107,352002623,
+ 944885050,-195957214,101314268,-62012030,39910272,-25849570,16470764,-10170838,
+ 6012886,-3362789,1754984,-839694,359019,-131544,38085,-7029},
+{-2247,18873,-76629,229628,-572466,1254709,-2495185,4596244,
+ -7962078,13134039,-20876566,32403290,-50017943,79233420,-138319603,346343418,
+ 948404963,-194508153,100447077,-61460193,39551589,-25617944,16324745,-10082152,
+ 5961606,-3334916,1740962,-833303,356467,-130703,37886,-7011},
+{-2197,18548,-75431,226239,-564350,1237456,-2461698,4535770,
+ -7859006,12966197,-20612271,31995061,-49386487,78217732,-136458477,340693264,
+ 951881832,-193019694,99560811,-60896964,39185615,-25381575,16175670,-9991552,
+ 5909172,-3306383,1726586,-826738,353837,-129832,37678,-6991},
+{-2147,18224,-74232,222839,-556195,1220103,-2427991,4474861,
+ -7755136,12796982,-20345733,31583306,-48749644,77193987,-134586055,335052608,
+ 955315338,-191491778,98655520,-60322388,38812381,-25140482,16023553,-9899043,
+ 5855588,-3277191,1711857,-819998,351130,-128932,37461,-6969},
+{-2097,17899,-73030,219427,-548004,1202654,-2394071,4413527,
+ -7650485,12626424,-20076999,31168100,-48107530,76162369,-132702665,329421896,
+ 958705166,-189924349,97731258,-59736513,38431920,-24894687,15868406,-9804632,
+ 5800857,-3247343,1696774,-813083,348345,-128001,37234,-6946},
+{-2048,17576,-71827,216005,-539777,1185113,-2359945,4351779,
+ -7545074,12454556,-19806120,30749520,-47460261,75123063,-130808632,323801573,
+ 962051005,-188317357,96788082,-59139386,38044266,-24644212,15710242,-9708328,
+ 5744983,-3216839,1681340,-805994,345481,-127040,36998,-6920},
+{-1999,17253,-70623,212574,-531516,1167482,-2325618,4289630,
+ -7438923,12281409,-19533145,30327639,-46807953,74076254,-128904283,318192079,
+ 965352547,-186670753,95826050,-58531059,37649455,-24389079,15549075,-9610137,
+ 5687970,-3185682,1665554,-798730,342540,-126048,36752,-6892},
+{-1951,16930,-69418,209133,-523223,1149766,-2291098,4227092,
+ -7332051,12107015,-19258123,29902535,-46150722,73022127,-126989944,312593856,
+ 968609489,-184984496,94845225,-57911584,37247523,-24129311,15384919,-9510068,
+ 5629822,-3153873,1649418,-791292,339521,-125027,36497,-6862},
+{-1903,16609,-68212,205684,-514900,1131967,-2256391,4164175,
+ -7224477,11931405,-18981103,29474283,-45488685,71960868,-125065940,307007339,
+ 971821531,-183258546,93845673,-57281015,36838506,-23864934,15217788,-9408128,
+ 5570543,-3121414,1632931,-783680,336423,-123975,36232,-6830},
+{-1856,16288,-67006,202227,-506547,1114089,-2221503,4100891,
+ -7116222,11754611,-18702136,29042960,-44821960,70892665,-123132599,301432966,
+ 974988377,-181492868,92827461,-56639408,36422445,-23595972,15047699,-9304328,
+ 5510138,-3088307,1616095,-775894,333248,-122892,35957,-6796},
+{-1809,15968,-65799,198763,-498167,1096136,-2186441,4037252,
+ -7007304,11576666,-18421272,28608642,-44150664,69817703,-121190244,295871169,
+ 978109737,-179687433,91790661,-55986821,35999380,-23322450,14874666,-9198675,
+ 5448612,-3054556,1598910,-767935,329994,-121779,35673,-6760},
+{-1763,15649,-64592,195293,-489761,1078110,-2151211,3973270,
+ -6897745,11397601,-18138560,28171405,-43474915,68736169,-119239201,290322381,
+ 981185323,-177842212,90735347,-55323315,35569350,-23044396,14698706,-9091180,
+ 5385969,-3020161,1581378,-759802,326663,-120635,35379,-6721},
+{-1717,15331,-63385,191817,-481331,1060015,-2115820,3908956,
+ -6787563,11217448,-17854050,27731328,-42794831,67648252,-117279794,284787030,
+ 984214851,-175957185,89661596,-54648951,35132400,-22761837,14519836,-8981851,
+ 5322214,-2985125,1563499,-751496,323253,-119461,35075,-6680},
+{-1672,15014,-62178,188335,-472877,1041854,-2080274,3844323,
+ -6676779,11036240,-17567793,27288487,-42110530,66554137,-115312348,279265543,
+ 987198043,-174032333,88569489,-53963792,34688572,-22474802,14338073,-8870699,
+ 5257354,-2949452,1545275,-743017,319765,-118255,34761,-6638},
+{-1627,14698,-60972,184849,-464403,1023631,-2044580,3779380,
+ -6565412,10854008,-17279840,26842959,-41422132,65454014,-113337187,273758344,
+ 990134623,-172067643,87459108,-53267904,34237911,-22183319,14153436,-8757734,
+ 5191392,-2913143,1526707,-734365,316200,-117019,34437,-6592},
+{-1583,14383,-59767,181360,-455909,1005349,-2008744,3714142,
+ -6453482,10670784,-16990240,26394822,-40729754,64348069,-111354634,268265857,
+ 993024321,-170063104,86330539,-52561355,33780464,-21887417,13965941,-8642967,
+ 5124337,-2876201,1507795,-725542,312556,-115753,34103,-6545},
+{-1539,14069,-58562,177867,-447397,987011,-1972773,3648618,
+ -6341008,10486601,-16699044,25944154,-40033515,63236491,-109365011,262788500,
+ 995866869,-168018713,85183871,-51844213,33316277,-21587129,13775609,-8526408,
+ 5056192,-2838630,1488541,-716547,308834,-114455,33760,-6495},
+{-1496,13757,-57359,174371,-438868,968620,-1936673,3582820,
+ -6228012,10301492,-16406303,25491031,-39333536,62119469,-107368642,257326691,
+ 998662006,-165934466,84019196,-51116549,32845400,-21282485,13582458,-8408069,
+ 4986964,-2800432,1468946,-707380,305035,-113127,33406,-6443},
+{-1453,13446,-56157,170874,-430324,950181,-1900450,3516761,
+ -6114512,10115487,-16112067,25035532,-38629935,60997190,-105365846,251880846,
+ 1001409474,-163810369,82836609,-50378436,32367881,-20973516,13386509,-8287962,
+ 4916660,-2761610,1449012,-698043,301158,-111767,33042,-6389},
+{-1411,13136,-54957,167375,-421766,931695,-1864111,3450452,
+ -6000528,9928620,-15816387,24577735,-37922832,59869843,-103356946,246451376,
+ 1004109018,-161646428,81636209,-49629949,31883771,-20660257,13187782,-8166098,
+ 4845286,-2722169,1428741,-688536,297203,-110377,32668,-6333},
+{-1369,12828,-53759,163875,-413197,913167,-1827663,3383904,
+ -5886081,9740923,-15519314,24117719,-37212347,58737616,-101342262,241038692,
+ 1006760389,-159442655,80418094,-48871164,31393124,-20342741,12986297,-8042490,
+ 4772848,-2682110,1408132,-678859,293171,-108956,32284,-6274},
+{-1328,12521,-52562,160375,-404617,894599,-1791111,3317129,
+ -5771189,9552428,-15220899,23655560,-36498598,57600698,-99322114,235643201,
+ 1009363343,-157199067,79182370,-48102159,30895990,-20021003,12782077,-7917150,
+ 4699354,-2641437,1387189,-669013,289062,-107504,31890,-6212},
+{-1288,12215,-51368,156876,-396028,875996,-1754462,3250139,
+ -5655874,9363168,-14921192,23191337,-35781707,56459277,-97296819,230265307,
+ 1011917638,-154915683,77929143,-47323014,30392426,-19695077,12575142,-7790091,
+ 4624811,-2600155,1365913,-658999,284875,-106021,31485,-6149},
+{-1248,11911,-50176,153377,-387431,857359,-1717723,3182945,
+ -5540154,9173174,-14620244,22725129,-35061793,55313542,-95266697,224905412,
+ 1014423038,-152592528,76658523,-46533812,29882486,-19364999,12365516,-7661327,
+ 4549226,-2558266,1344305,-648816,280612,-104507,31071,-6083},
+{-1208,11608,-48987,149881,-378828,838693,-1680899,3115558,
+ -5424049,8982480,-14318106,22257013,-34338976,54163681,-93232064,219563916,
+ 1016879312,-150229632,75370621,-45734635,29366227,-19030807,12153222,-7530871,
+ 4472607,-2515775,1322367,-638467,276272,-102962,30646,-6014},
+{-1169,11308,-47801,146386,-370221,820000,-1643997,3047991,
+ -5307580,8791117,-14014829,21787069,-33613376,53009882,-91193236,214241215,
+ 1019286232,-147827027,74065554,-44925569,28843706,-18692538,11938282,-7398736,
+ 4394961,-2472686,1300101,-627951,271855,-101387,30211,-5943},
+{-1131,11008,-46617,142895,-361610,801284,-1607024,2980255,
+ -5190766,8599117,-13710464,21315374,-32885112,51852333,-89150530,208937703,
+ 1021643575,-145384752,72743440,-44106702,28314984,-18350231,11720721,-7264938,
+ 4316296,-2429002,1277509,-617269,267362,-99780,29765,-5869},
+{-1093,10711,-45437,139406,-352998,782548,-1569985,2912361,
+ -5073626,8406513,-13405061,20842006,-32154306,50691223,-87104260,203653772,
+ 1023951123,-142902847,71404400,-43278122,27780119,-18003924,11500563,-7129490,
+ 4236620,-2384728,1254593,-606422,262792,-98143,29309,-5794},
+{-1056,10415,-44260,135922,-344386,763794,-1532887,2844320,
+ -4956180,8213338,-13098672,20367045,-31421077,49526739,-85054739,198389808,
+ 1026208663,-140381361,70048559,-42439921,27239174,-17653657,11277833,-6992407,
+ 4155942,-2339868,1231354,-595411,258147,-96475,28843,-5715},
+{-1019,10121,-43087,132442,-335774,745027,-1495737,2776145,
+ -4838449,8019623,-12791348,19890568,-30685545,48359069,-83002279,193146197,
+ 1028415984,-137820343,68676043,-41592189,26692210,-17299471,11052557,-6853705,
+ 4074270,-2294427,1207795,-584236,253426,-94776,28367,-5634},
+{-983,9829,-41917,128968,-327166,726250,-1458539,2707846,
+ -4720451,7825400,-12483138,19412654,-29947830,47188401,-80947193,187923321,
+ 1030572882,-135219849,67286983,-40735023,26139291,-16941407,10824759,-6713399,
+ 3991612,-2248408,1183919,-572899,248630,-93046,27880,-5551},
+{-948,9539,-40752,125499,-318561,707465,-1421301,2639435,
+ -4602207,7630702,-12174094,18933380,-29208052,46014921,-78889790,182721560,
+ 1032679158,-132579937,65881511,-39868518,25580481,-16579508,10594467,-6571505,
+ 3907978,-2201817,1159726,-561400,243759,-91286,27383,-5464},
+{-913,9250,-39590,122036,-309962,688675,-1384029,2570923,
+ -4483735,7435560,-11864267,18452826,-28466330,44838817,-76830380,177541290,
+ 1034734616,-129900673,64459764,-38992772,25015847,-16213815,10361708,-6428038,
+ 3823377,-2154659,1135219,-549741,238812,-89495,26875,-5376},
+{-878,8964,-38433,118581,-301370,669884,-1346729,2502322,
+ -4365055,7240007,-11553707,17971069,-27722784,43660275,-74769272,172382883,
+ 1036739066,-127182123,63021880,-38107883,24445455,-15844373,10126508,-6283015,
+ 3737817,-2106937,1110401,-537922,233792,-87674,26357,-5285},
+{-844,8680,-37280,115132,-292786,651094,-1309406,2433642,
+ -4246187,7044075,-11242464,17488187,-26977534,42479482,-72706771,167246711,
+ 1038692321,-124424360,61568001,-37213954,23869373,-15471226,9888896,-6136453,
+ 3651309,-2058658,1085274,-525944,228697,-85822,25829,-5191},
+{-811,8397,-36132,111691,-284211,632310,-1272068,2364896,
+ -4127150,6847796,-10930590,17004258,-26230699,41296623,-70643184,162133139,
+ 1040594200,-121627462,60098272,-36311088,23287671,-15094418,9648900,-5988369,
+ 3563862,-2009826,1059841,-513808,223529,-83940,25290,-5094},
+{-778,8117,-34988,108259,-275648,613533,-1234720,2296093,
+ -4007964,6651200,-10618135,16519360,-25482398,40111884,-68578815,157042533,
+ 1042444526,-118791510,58612839,-35399388,22700418,-14713996,9406549,-5838780,
+ 3475486,-1960446,1034103,-501516,218287,-82028,24741,-4995},
+{-746,7838,-33850,104836,-267097,594767,-1197368,2227246,
+ -3888648,6454321,-10305148,16033572,-24732750,38925451,-66513967,151975252,
+ 1044243128,-115916589,57111853,-34478962,22107685,-14330005,9161871,-5687703,
+ 3386190,-1910524,1008064,-489068,212972,-80085,24182,-4894},
+{-715,7562,-32717,101422,-258559,576015,-1160018,2158365,
+ -3769220,6257190,-9991681,15546969,-23981875,37737507,-64448943,146931654,
+ 1045989839,-113002789,55595466,-33549917,21509545,-13942494,8914897,-5535158,
+ 3295985,-1860065,981727,-476465,207585,-78113,23612,-4789},
+{-684,7288,-31589,98018,-250037,557279,-1122676,2089462,
+ -3649701,6059839,-9677783,15059631,-23229890,36548238,-62384043,141912093,
+ 1047684496,-110050204,54063836,-32612363,20906072,-13551509,8665656,-5381160,
+ 3204882,-1809075,955092,-463710,202125,-76110,23031,-4682},
+{-653,7016,-30466,94625,-241531,538563,-1085348,2020547,
+ -3530109,5862299,-9363505,14571634,-22476914,35357827,-60319565,136916920,
+ 1049326942,-107058934,52517120,-31666411,20297339,-13157100,8414180,-5225730,
+ 3112891,-1757559,928165,-450802,196594,-74077,22440,-4573},
+{-624,6747,-29349,91243,-233042,519870,-1048040,1951631,
+ -3410463,5664601,-9048896,14083055,-21723065,34166457,-58255808,131946483,
+ 1050917024,-104029082,50955479,-30712175,19683422,-12759315,8160499,-5068887,
+ 3020022,-1705523,900947,-437743,190991,-72015,21839,-4460},
+{-594,6479,-28238,87872,-224573,501202,-1010758,1882726,
+ -3290783,5466777,-8734007,13593972,-20968462,32974312,-56193068,127001126,
+ 1052454595,-100960755,49379079,-29749769,19064399,-12358205,7904644,-4910648,
+ 2926287,-1652973,873441,-424534,185317,-69923,21228,-4345},
+{-566,6214,-27132,84513,-216123,482563,-973507,1813842,
+ -3171086,5268858,-8418886,13104462,-20213221,31781573,-54131639,122081190,
+ 1053939511,-97854064,47788087,-28779309,18440345,-11953819,7646649,-4751034,
+ 2831697,-1599915,845650,-411177,179573,-67801,20606,-4227},
+{-537,5951,-26033,81167,-207695,463955,-936294,1744990,
+ -3051393,5070875,-8103584,12614600,-19457460,30588422,-52071815,117187012,
+ 1055371635,-94709127,46182671,-27800913,17811341,-11546210,7386545,-4590064,
+ 2736263,-1546354,817577,-397673,173759,-65650,19974,-4107},
+{-510,5691,-24940,77833,-199290,445381,-899124,1676180,
+ -2931722,4872860,-7788149,12124464,-18701296,29395040,-50013888,112318926,
+ 1056750833,-91526064,44563006,-26814701,17177465,-11135429,7124365,-4427758,
+ 2639996,-1492298,789225,-384023,167875,-63470,19331,-3984},
+{-483,5433,-23853,74514,-190909,426845,-862004,1607424,
+ -2812091,4674843,-7472632,11634130,-17944846,28201608,-47958148,107477263,
+ 1058076977,-88305000,42929266,-25820794,16538798,-10721529,6860143,-4264137,
+ 2542909,-1437753,760598,-370229,161923,-61261,18678,-3858},
+{-456,5177,-22773,71208,-182554,408348,-824937,1538732,
+ -2692519,4476856,-7157081,11143673,-17188226,27008306,-45904883,102662349,
+ 1059349943,-85046064,41281629,-24819314,15895422,-10304563,6593912,-4099220,
+ 2445013,-1382724,731698,-356292,155902,-59023,18015,-3729},
+{-431,4924,-21699,67916,-174224,389893,-787932,1470115,
+ -2573025,4278928,-6841544,10653169,-16431551,25815312,-43854379,97874510,
+ 1060569613,-81749389,39620276,-23810386,15247419,-9884585,6325706,-3933029,
+ 2346320,-1327218,702529,-342214,149813,-56756,17341,-3597},
+{-405,4673,-20632,64639,-165923,371484,-750992,1401582,
+ -2453627,4081090,-6526072,10162695,-15674938,24622805,-41806923,93114063,
+ 1061735874,-78415115,37945392,-22794136,14594874,-9461649,6055560,-3765586,
+ 2246842,-1271243,673094,-327995,143657,-54460,16658,-3463},
+{-381,4424,-19572,61378,-157650,353123,-714123,1333146,
+ -2334343,3883374,-6210712,9672325,-14918502,23430963,-39762798,88381326,
+ 1062848617,-75043383,36257161,-21770690,13937870,-9035811,5783509,-3596910,
+ 2146593,-1214804,643397,-313638,137435,-52136,15964,-3326},
+{-356,4178,-18519,58132,-149407,334813,-677332,1264815,
+ -2215192,3685808,-5895512,9182134,-14162357,22239962,-37722286,83676612,
+ 1063907738,-71634340,34555774,-20740178,13276493,-8607127,5509589,-3427024,
+ 2045583,-1157908,613440,-299143,131146,-49784,15259,-3187},
+{-333,3935,-17473,54902,-141196,316557,-640623,1196601,
+ -2096192,3488424,-5580522,8692197,-13406617,21049979,-35685665,79000229,
+ 1064913139,-68188137,32841421,-19702731,12610830,-8175653,5233835,-3255950,
+ 1943827,-1100564,583228,-284514,124791,-47403,14545,-3044},
+{-310,3694,-16434,51689,-133017,298356,-604003,1128513,
+ -1977360,3291251,-5265788,8202589,-12651397,19861189,-33653216,74352484,
+ 1065864726,-64704929,31114297,-18658479,11940968,-7741446,4956284,-3083710,
+ 1841336,-1042776,552763,-269750,118372,-44995,13821,-2899},
+{-287,3455,-15403,48493,-124872,280214,-567475,1060562,
+ -1858715,3094320,-4951359,7713383,-11896810,18673767,-31625213,69733677,
+ 1066762411,-61184877,29374599,-17607557,11266996,-7304564,4676972,-2910327,
+ 1738125,-984553,522050,-254855,111889,-42558,13086,-2751},
+{-265,3220,-14379,45315,-116761,262134,-531047,992758,
+ -1740275,2897660,-4637283,7224654,-11142968,17487887,-29601932,65144108,
+ 1067606110,-57628143,27622526,-16550099,10589002,-6865065,4395937,-2735823,
+ 1634206,-925902,491092,-239828,105342,-40095,12342,-2600},
+{-244,2986,-13363,42154,-108686,244118,-494723,925111,
+ -1622056,2701300,-4323605,6736474,-10389985,16303721,-27583646,60584069,
+ 1068395743,-54034897,25858281,-15486242,9907078,-6423008,4113215,-2560221,
+ 1529592,-866831,459893,-224673,98732,-37604,11587,-2446},
+{-223,2756,-12355,39012,-100649,226168,-458508,857632,
+ -1504078,2505270,-4010375,6248917,-9637972,15121442,-25570624,56053852,
+ 1069131239,-50405311,24082069,-14416124,9221314,-5978453,3828846,-2383544,
+ 1424298,-807346,428456,-209391,92060,-35086,10822,-2289},
+{-203,2528,-11355,35888,-92649,208288,-422408,790329,
+ -1386357,2309600,-3697638,5762056,-8887041,13941220,-23563136,51553744,
+ 1069812528,-46739562,22294096,-13339883,8531802,-5531460,3542866,-2205816,
+ 1318337,-747455,396786,-193984,85326,-32541,10048,-2130},
+{-183,2302,-10362,32784,-84688,190479,-386428,723212,
+ -1268911,2114318,-3385441,5275964,-8137302,12763225,-21561449,47084027,
+ 1070439546,-43037830,20494572,-12257660,7838636,-5082089,3255316,-2027061,
+ 1211723,-687166,364886,-178453,78532,-29970,9263,-1968},
+{-164,2079,-9378,29699,-76768,172744,-350573,656293,
+ -1151757,1919454,-3073831,4790712,-7388866,11587628,-19565827,42644981,
+ 1071012236,-39300302,18683711,-11169598,7141908,-4630402,2966233,-1847303,
+ 1104470,-626487,332760,-162800,71677,-27372,8469,-1803},
+{-145,1859,-8401,26634,-68889,155086,-314848,589579,
+ -1034913,1725036,-2762853,4306372,-6641842,10414596,-17576533,38236880,
+ 1071530544,-35527167,16861726,-10075839,6441714,-4176460,2675658,-1666566,
+ 996592,-565425,300413,-147027,64763,-24748,7665,-1635},
+{-127,1642,-7433,23589,-61052,137506,-279258,523082,
+ -918394,1531092,-2452554,3823015,-5896340,9244296,-15593829,33859996,
+ 1071994421,-31718618,15028835,-8976529,5738148,-3720326,2383630,-1484874,
+ 888103,-503989,267848,-131137,57791,-22098,6852,-1465},
+{-109,1427,-6474,20564,-53258,120009,-243809,456809,
+ -802219,1337651,-2142978,3340713,-5152468,8076895,-13617972,29514597,
+ 1072403825,-27874854,13185259,-7871813,5031309,-3262063,2090189,-1302253,
+ 779019,-442186,235070,-115130,50761,-19423,6028,-1291},
+{-92,1215,-5523,17561,-45509,102595,-208505,390772,
+ -686404,1144742,-1834173,2859536,-4410335,6912559,-11649220,25200946,
+ 1072758717,-23996078,11331219,-6761840,4321291,-2801734,1795376,-1118727,
+ 669354,-380025,202082,-99009,43674,-16722,5195,-1115},
+{-75,1006,-4580,14579,-37805,85267,-173350,324979,
+ -570966,952392,-1526182,2379555,-3670047,5751450,-9687826,20919302,
+ 1073059064,-20082495,9466940,-5646757,3608194,-2339403,1499232,-934321,
+ 559122,-317514,168889,-82776,36530,-13996,4353,-936},
+{-59,799,-3647,11618,-30148,68027,-138351,259439,
+ -455921,760630,-1219050,1900838,-2931711,4593733,-7734044,16669921,
+ 1073304838,-16134316,7592650,-4526715,2892117,-1875135,1201798,-749061,
+ 448339,-254661,135495,-66433,29332,-11245,3501,-755},
+{-44,595,-2722,8680,-22538,50879,-103512,194163,
+ -341286,569482,-912822,1423455,-2195433,3439569,-5788124,12453055,
+ 1073496016,-12151756,5708577,-3401865,2173158,-1408995,903116,-562973,
+ 337020,-191474,101905,-49982,22078,-8470,2640,-570},
+{-29,394,-1805,5764,-14976,33823,-68837,129158,
+ -227076,378976,-607541,947476,-1461319,2289119,-3850313,8268951,
+ 1073632581,-8135034,3814955,-2272360,1451418,-941048,603227,-376083,
+ 225180,-127963,68123,-33424,14771,-5670,1769,-383},
+{-14,196,-898,2870,-7463,16863,-34332,64434,
+ -113309,189140,-303253,472968,-729473,1142543,-1920857,4117853,
+ 1073714520,-4084373,1912017,-1138353,726998,-471361,302174,-188416,
+ 112835,-64135,34153,-16763,7412,-2847,889,-193},
+{0,0,0,0,0,0,0,0,
+ 0,0,0,0,0,0,0,0,
+ 1073741824,0,0,0,0,0,0,0,
+ 0,0,0,0,0,0,0,0}
+};
+
+#endif /* __USBD_AUDIO_ASRC_COEF_H */
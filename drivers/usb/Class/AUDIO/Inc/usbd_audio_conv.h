@@ -0,0 +1,115 @@
+/**
+  ******************************************************************************
+  * @file    usbd_audio_conv.h
+  * @brief   USB audio packet to I2S buffer sample conversion kernels
+  ******************************************************************************
+  */
+
+#ifndef __USBD_AUDIO_CONV_H
+#define __USBD_AUDIO_CONV_H
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+#include <stdint.h>
+
+// Incoming USB audio packet : 24bit stereo frames, L channel 3bytes + R channel 3bytes, LSbyte first
+// b0:lo_L, b1:mid_L, b2:hi_L, b3:lo_R, b4:mid_R, b5:hi_R
+// or 16bit stereo frames : b0:lo_L, b1:hi_L, b2:lo_R, b3:hi_R
+// or 24bit in 32bit stereo frames, left-aligned : b0:pad_L, b1:lo_L, b2:mid_L, b3:hi_L, b4:pad_R ... b7:hi_R
+//
+// Outgoing I2S Philips data : left-aligned 24bits in 32bit frame, MSbyte first.
+// The I2S transmit buffer holds one 32bit word per channel. The DMA reads words from
+// memory and writes halfwords to the 16bit I2S data register. The DMA FIFO unpacks each
+// word low halfword first, so the word holds the left-aligned sample with its halfwords
+// swapped : {lo:0x00} in the high halfword, {hi:mid} in the low halfword.
+// Processing stages work on plain left-aligned int32 samples and convert with
+// AUDIO_I2S_Word / AUDIO_I2S_Sample.
+//
+// Volume : linear gain in Q1.30, AUDIO_CONV_GAIN_UNITY (1 << 30) is exactly 0dB so the
+// unity kernel and the gain kernel give identical results. The gain is computed from the
+// UAC volume setting (1/256dB units) by AUDIO_Conv_VolumeToGain. Gain changes are ramped
+// linearly over one packet.
+//
+// The kernels work on samples (frames * channels) as the packing does not depend
+// on the channel a sample belongs to. During a ramp the gain changes once per stereo frame.
+
+#define AUDIO_CONV_GAIN_UNITY   ((int32_t)1 << 30)
+
+// Gain modes, each one has its own specialised kernel
+// X(name, mode)
+#define AUDIO_CONV_VOL_MODES(X) \
+  X(Unity, AUDIO_CONV_VOL_UNITY) \
+  X(Gain,  AUDIO_CONV_VOL_GAIN)  \
+  X(Ramp,  AUDIO_CONV_VOL_RAMP)  \
+  X(Mute,  AUDIO_CONV_VOL_MUTE)
+
+// USB subframe formats
+typedef enum {
+  AUDIO_CONV_FMT_16 = 0,    // 2 byte subframes
+  AUDIO_CONV_FMT_24,        // 3 byte subframes
+  AUDIO_CONV_FMT_32,        // 4 byte subframes, low byte ignored
+  AUDIO_CONV_FMT_NUM
+} AUDIO_ConvFormatTypeDef;
+
+typedef enum {
+  AUDIO_CONV_VOL_UNITY = 0, // 0dB, no scaling
+  AUDIO_CONV_VOL_GAIN,      // constant gain, one multiply per sample
+  AUDIO_CONV_VOL_RAMP,      // gain change, interpolated over the packet
+  AUDIO_CONV_VOL_MUTE,      // muted, write silence
+  AUDIO_CONV_VOL_NUM
+} AUDIO_ConvVolModeTypeDef;
+
+static inline uint32_t AUDIO_I2S_Word(int32_t sample) {
+  return ((uint32_t)sample >> 16) | ((uint32_t)sample << 16);
+}
+
+static inline int32_t AUDIO_I2S_Sample(uint32_t word) {
+  return (int32_t)((word >> 16) | (word << 16));
+}
+
+typedef void (*AUDIO_ConvFunc)(uint32_t* pDst, const uint8_t* pSrc, uint32_t samples, int32_t gain, int32_t gain_step);
+
+typedef struct {
+  AUDIO_ConvFunc  func;         // kernel for the current gain mode
+  int32_t         gain;         // current gain, Q1.30
+  int32_t         gain_target;  // gain at the end of the ramp, Q1.30
+  uint32_t        in_bytes;     // USB subframe size
+  AUDIO_ConvFormatTypeDef  format;
+  AUDIO_ConvVolModeTypeDef mode;
+} AUDIO_ConvTypeDef;
+
+#define AUDIO_CONV_DECLARE(name, mode) \
+void AUDIO_Conv24_##name(uint32_t* pDst, const uint8_t* pSrc, uint32_t samples, int32_t gain, int32_t gain_step); \
+void AUDIO_Conv16_##name(uint32_t* pDst, const uint8_t* pSrc, uint32_t samples, int32_t gain, int32_t gain_step); \
+void AUDIO_Conv32_##name(uint32_t* pDst, const uint8_t* pSrc, uint32_t samples, int32_t gain, int32_t gain_step);
+AUDIO_CONV_VOL_MODES(AUDIO_CONV_DECLARE)
+#undef AUDIO_CONV_DECLARE
+
+void    AUDIO_Conv24_Ref(uint32_t* pDst, const uint8_t* pSrc, uint32_t samples, int32_t gain, int32_t gain_step);
+void    AUDIO_Conv16_Ref(uint32_t* pDst, const uint8_t* pSrc, uint32_t samples, int32_t gain, int32_t gain_step);
+void    AUDIO_Conv32_Ref(uint32_t* pDst, const uint8_t* pSrc, uint32_t samples, int32_t gain, int32_t gain_step);
+int32_t AUDIO_Conv_VolumeToGain(int16_t volume);
+void    AUDIO_Conv_Select(AUDIO_ConvTypeDef* pConv, uint32_t subframe_bytes, int32_t gain, uint8_t mute, uint8_t ramp);
+void    AUDIO_Conv_Packet(AUDIO_ConvTypeDef* pConv, uint32_t* pDst, const uint8_t* pSrc, uint32_t frames);
+void    AUDIO_Conv_FadeOut(uint32_t* pRing, uint32_t pos, uint32_t size, uint32_t frames);
+
+#ifdef DEBUG_AUDIO_CONV_BENCHMARK
+typedef struct {
+  uint32_t frames;                          // stereo frames per packet
+  uint32_t ref_cycles;                      // AUDIO_Conv24_Ref, -3dB
+  uint32_t cycles[AUDIO_CONV_FMT_NUM][AUDIO_CONV_VOL_NUM];    // specialised kernels
+  uint32_t mismatch[AUDIO_CONV_FMT_NUM][AUDIO_CONV_VOL_NUM];  // number of output words that differ from the reference
+  uint32_t asrc_frames;                     // USE_ADAPTIVE_EP resampler output frames for the packet
+  uint32_t asrc_cycles;                     // AUDIO_ASRC_Process
+} AUDIO_ConvBenchTypeDef;
+
+void AUDIO_Conv_Benchmark(AUDIO_ConvBenchTypeDef* pBench);
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __USBD_AUDIO_CONV_H */
@@ -0,0 +1,67 @@
+/**
+  ******************************************************************************
+  * @file    usbd_audio_fb.h
+  * @brief   Feedback endpoint controller : filtered buffer fill level and PI loop
+  ******************************************************************************
+  */
+
+#ifndef __USBD_AUDIO_FB_H
+#define __USBD_AUDIO_FB_H
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+#include <stdint.h>
+#include "usbd_audio_fb_conf.h"
+
+// Feedback values are Fs in kHz, 10.14 format shifted left by 8 bits, i.e. 1kHz = 1 << 22.
+// The host sends fb / (1 << 22) frames per 1ms USB frame, so a feedback offset of 1 << 22
+// changes the buffer fill level by 1 frame per ms.
+//
+// Every SOF the writable space in the I2S buffer is accumulated. Once per feedback refresh period
+// (bRefresh, 2^SOF_RATE ms) the average is low-pass filtered and compared with the setpoint, half
+// the buffer. The PI controller output is added to the nominal feedback. Filter and integrator
+// steps are scaled by the number of accumulated frames, so the gains stay per ms.
+// The integral term removes the steady state fill error left by the nominal Fs error (PLL and
+// crystal tolerance). Conditional integration stops the integrator winding up while the output
+// is clamped to fb_nom +/- AUDIO_FB_DELTA_MAX.
+//
+// Measured Fs (USE_FB_TIMER) : a timer clocked from HSE, like PLLI2S, captures its count on every
+// SOF. Timer ticks over 2^AUDIO_FB_MEAS_SHIFT USB frames against the nominal tick count give the
+// crystal error relative to the host clock, and the PLL nominal feedback scaled by this ratio is
+// the real Fs in frames per USB frame. It replaces fb_nom once per window, and the fill level
+// controller is left to trim the buffer position with lower gains.
+//
+// No HAL dependency, tools/fb_sim runs this code in a closed loop host simulation.
+
+typedef struct {
+  uint32_t fb_pll;      // nominal feedback of the PLLI2S settings, 0ppm crystal
+  uint32_t fb_nom;      // nominal feedback, fb_pll or the last measured value
+  uint32_t fb;          // last feedback value
+  int32_t  setpoint;    // writable space setpoint, frames Q8
+  int32_t  fill;        // low-pass filtered writable space, frames Q8
+  int64_t  integ;       // integral term, feedback units Q8
+  uint32_t acc;         // writable space accumulated since the last update, words Q8
+  uint32_t acc_n;       // number of accumulated frames
+  uint32_t tick_khz;    // measurement timer clock, 0 = no measurement
+  uint32_t tick_start;  // timer capture at the start of the measurement window
+  uint16_t frame_start; // USB frame number at the start of the measurement window
+  uint8_t  meas_run;    // measurement window started
+} AUDIO_FB_TypeDef;
+
+void     AUDIO_FB_Init(AUDIO_FB_TypeDef* pFb, uint32_t fb_nom, uint32_t setpoint_frames, uint32_t tick_khz);
+uint32_t AUDIO_FB_Update(AUDIO_FB_TypeDef* pFb);
+void     AUDIO_FB_Measure(AUDIO_FB_TypeDef* pFb, uint32_t tick, uint32_t frame);
+
+// Called every SOF with the writable space in the I2S buffer, in 32bit words (2 per frame) Q8
+static inline void AUDIO_FB_Sample(AUDIO_FB_TypeDef* pFb, uint32_t writable_words_q8) {
+  pFb->acc += writable_words_q8;
+  pFb->acc_n++;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __USBD_AUDIO_FB_H */
@@ -0,0 +1,94 @@
+/**
+  ******************************************************************************
+  * @file    usbd_audio_telem.h
+  * @brief   Per-SOF telemetry stream on a vendor specific bulk IN interface
+  ******************************************************************************
+  */
+
+#ifndef __USBD_AUDIO_TELEM_H
+#define __USBD_AUDIO_TELEM_H
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+#include <stdint.h>
+
+// With USE_TELEMETRY the configuration has a third interface, vendor specific class with one bulk IN
+// endpoint, next to the audio control and streaming interfaces. USBD_AUDIO_SOF writes one record per
+// USB frame to a ring of AUDIO_TELEM_RECORDS, and the records are sent in transfers of up to
+// AUDIO_TELEM_BURST records whenever the host reads the endpoint. When nobody reads the ring fills
+// up and new records are dropped, seq counts every record so the reader sees the gap.
+//
+// Bulk transfers only use the bus time left by the isochronous stream, and the endpoint has a 64 byte
+// TX FIFO of its own. The RX FIFO shrinks from 0x120 to 0x110 words to make room, it still holds the
+// largest audio packet (194 words) plus the setup and status overhead of the reference manual
+// RX FIFO formula, 213 words in total.
+//
+// tools/telem reads the stream on a Linux host and writes it to a CSV file.
+// The record is little-endian and 32 bytes, the reader includes this file with AUDIO_TELEM_HOST.
+
+#define AUDIO_TELEM_ITF           0x02U
+#define AUDIO_TELEM_EP            0x82U
+#define AUDIO_TELEM_PACKET        64U
+#define AUDIO_TELEM_RECORDS       64U   // power of 2
+#define AUDIO_TELEM_BURST         16U   // records per bulk transfer
+#define AUDIO_TELEM_MAGIC         0x5441U
+
+#define AUDIO_TELEM_FLAG_PLAYING  0x01U // I2S DMA running
+#define AUDIO_TELEM_FLAG_RD       0x02U // rd_enable, the fill level fields are valid
+#define AUDIO_TELEM_FLAG_XRUN     0x04U // underrun being concealed
+#define AUDIO_TELEM_FLAG_FB       0x08U // feedback value updated in this frame
+
+typedef struct {
+  uint16_t magic;          // AUDIO_TELEM_MAGIC
+  uint16_t seq;            // record number, including the dropped ones
+  uint16_t frame;          // USB frame number
+  uint8_t  flags;          // AUDIO_TELEM_FLAG_xxx
+  uint8_t  alt;            // streaming interface alternate setting
+  uint32_t freq;           // stream sampling frequency
+  uint32_t writable_q8;    // writable ring buffer words, Q8
+  uint32_t rd_q8;          // DMA read position in words, Q8
+  uint32_t feedback;       // controller output, frames per ms Q22
+  uint32_t isr_cycles;     // longest OTG ISR since the previous record, DWT cycles
+  uint16_t conv_cycles;    // longest packet conversion since the previous record, DWT cycles / 16
+  uint8_t  iso_incomplete; // IsoOutIncomplete events, wraps
+  uint8_t  xruns;          // underruns + overruns, wraps
+} AUDIO_TelemRecordTypeDef;
+
+#ifndef AUDIO_TELEM_HOST
+
+#include "usbd_ioreq.h"
+
+extern volatile uint32_t AUDIO_TelemIsrCycles;
+extern volatile uint32_t AUDIO_TelemConvCycles;
+extern volatile uint8_t  AUDIO_TelemIsoIncomplete;
+
+void AUDIO_Telem_Init(USBD_HandleTypeDef* pdev);
+void AUDIO_Telem_DeInit(USBD_HandleTypeDef* pdev);
+void AUDIO_Telem_Put(USBD_HandleTypeDef* pdev, AUDIO_TelemRecordTypeDef* pRec);
+void AUDIO_Telem_DataIn(USBD_HandleTypeDef* pdev);
+
+// longest OTG ISR and conversion, reset by AUDIO_Telem_Put
+static inline void AUDIO_Telem_IsrCycles(uint32_t cycles) {
+  if (cycles > AUDIO_TelemIsrCycles) AUDIO_TelemIsrCycles = cycles;
+}
+
+// Called from PendSV. When AUDIO_Telem_Put resets the maximum in between, the exception return clears
+// the exclusive monitor, the store fails and the cycles are compared with the new record's maximum.
+static inline void AUDIO_Telem_ConvCycles(uint32_t cycles) {
+  do {
+    if (cycles <= __LDREXW(&AUDIO_TelemConvCycles)) {
+      __CLREX();
+      return;
+    }
+  } while (__STREXW(cycles, &AUDIO_TelemConvCycles));
+}
+
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __USBD_AUDIO_TELEM_H */
@@ -0,0 +1,91 @@
+/**
+  ******************************************************************************
+  * @file    usbd_audio_trace.h
+  * @brief   Event triggered trace of the feedback loop, DEBUG_FEEDBACK_ENDPOINT
+  ******************************************************************************
+  */
+
+#ifndef __USBD_AUDIO_TRACE_H
+#define __USBD_AUDIO_TRACE_H
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+#include <stdint.h>
+
+// USBD_AUDIO_SOF writes an entry on every feedback update, and in any frame with an event, to a ring
+// of AUDIO_TRACE_DEPTH entries. The entries are integers, the SOF handler does no float arithmetic.
+// The first event in AUDIO_TRACE_TRIGGER triggers the trace : AUDIO_TRACE_POST more entries are
+// recorded, then the trace freezes and holds the entries before and after the event until it is
+// re-armed, so a rare glitch in a long run is not overwritten. The KEY button printout in main.c
+// dumps the trace, frozen by the trigger or by the button, and re-arms it.
+//
+// All the events are raised in the OTG ISR, the main loop only reads a frozen trace.
+
+#ifndef AUDIO_TRACE_DEPTH
+#define AUDIO_TRACE_DEPTH         256U  // entries, power of 2, 12 bytes each
+#endif
+#ifndef AUDIO_TRACE_POST
+#define AUDIO_TRACE_POST          64U   // entries after the trigger, less than AUDIO_TRACE_DEPTH
+#endif
+
+#define AUDIO_TRACE_EV_UNDERRUN   0x01U // USBD_AUDIO_SOF detected an underrun
+#define AUDIO_TRACE_EV_OVERRUN    0x02U // USBD_AUDIO_DataOut dropped a packet
+#define AUDIO_TRACE_EV_SAFEZONE   0x04U // fill level entered the safe zone
+#define AUDIO_TRACE_EV_RATE       0x08U // SET_CUR sampling frequency
+#define AUDIO_TRACE_EV_ISO_INCOMPLETE 0x10U // IsoOutIncomplete
+
+#ifndef AUDIO_TRACE_TRIGGER
+#define AUDIO_TRACE_TRIGGER       (AUDIO_TRACE_EV_UNDERRUN | AUDIO_TRACE_EV_OVERRUN | AUDIO_TRACE_EV_SAFEZONE | \
+                                   AUDIO_TRACE_EV_RATE | AUDIO_TRACE_EV_ISO_INCOMPLETE)
+#endif
+
+#define AUDIO_TRACE_ARMED         0U
+#define AUDIO_TRACE_TRIGGERED     1U
+#define AUDIO_TRACE_FROZEN        2U
+
+typedef struct {
+  uint32_t sof;               // SOF counter
+  uint32_t feedback;          // controller output, frames per ms Q22
+  uint32_t writable_q8 : 24;  // writable ring buffer words Q8, 0 when not playing
+  uint32_t events : 8;        // AUDIO_TRACE_EV_xxx since the previous entry
+} AUDIO_TraceEntryTypeDef;
+
+typedef struct {
+  AUDIO_TraceEntryTypeDef entry[AUDIO_TRACE_DEPTH];
+  uint32_t head;              // entries written, free running
+  uint32_t trigger;           // entry number of the trigger
+  uint32_t post;              // entries left to record after the trigger
+  uint32_t sof;               // SOF counter
+  uint32_t missed;            // events while frozen
+  uint8_t  events;            // events for the next entry
+  uint8_t  safezone;          // fill level in the safe zone in the last frame
+  volatile uint8_t state;     // AUDIO_TRACE_ARMED, _TRIGGERED, _FROZEN
+} AUDIO_TraceTypeDef;
+
+#ifdef DEBUG_FEEDBACK_ENDPOINT
+
+extern AUDIO_TraceTypeDef AUDIO_Trace;
+
+static inline void AUDIO_Trace_Event(uint8_t ev) {
+  AUDIO_Trace.events |= ev;
+}
+
+// raises AUDIO_TRACE_EV_SAFEZONE when the fill level enters the safe zone
+static inline void AUDIO_Trace_SafeZone(uint32_t in) {
+  if (in && !AUDIO_Trace.safezone) AUDIO_Trace.events |= AUDIO_TRACE_EV_SAFEZONE;
+  AUDIO_Trace.safezone = (uint8_t)(in != 0U);
+}
+
+void AUDIO_Trace_Sof(uint32_t writable_q8, uint32_t feedback, uint32_t record);
+void AUDIO_Trace_Freeze(void);
+void AUDIO_Trace_Arm(void);
+
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __USBD_AUDIO_TRACE_H */
@@ -21,10 +21,10 @@
   *             - Audio Synchronization type: Asynchronous
   *          The current audio class version supports the following audio features:
   *             - Pulse Coded Modulation (PCM) format
-  *             - sampling rate: 44.1kHz, 48kHz, 96kHz
-  *             - Bit resolution: 24
+  *             - sampling rate: 32kHz, 44.1kHz, 48kHz, 88.2kHz, 96kHz, and 176.4kHz, 192kHz with 16 bit (alternate setting 2)
+  *             - Bit resolution: 24 (alternate setting 1), 16 (alternate setting 2), 24 in 32bit subframes (alternate setting 3)
   *             - Number of channels: 2
-  *             - Volume control max=0dB, min=-96dB, 3dB attenuation steps
+  *             - Volume control max=0dB, min=-127dB, 1/256dB resolution, ramped gain changes
   *             - Mute/Unmute
   *             - Asynchronous Endpoints
   *             - Endpoint for Sampling frequency DbgFeedbackHistory 10.14 3bytes
@@ -34,6 +34,7 @@
 #include "usbd_audio.h"
 #include "usbd_ctlreq.h"
 #include "bsp_audio.h"
+#include "profile.h"
 
 
 #define AUDIO_SAMPLE_FREQ(frq) (uint8_t)(frq), (uint8_t)((frq >> 8)), (uint8_t)((frq >> 16))
@@ -44,11 +45,14 @@
 #define AUDIO_PACKET_SZE_24B(frq) (uint8_t)(((frq / 1000U + 1) * 2U * 3U) & 0xFFU), \
                                   (uint8_t)((((frq / 1000U + 1) * 2U * 3U) >> 8) & 0xFFU)
 
+#define AUDIO_PACKET_SZE_16B(frq) (uint8_t)(((frq / 1000U + 1) * 2U * 2U) & 0xFFU), \
+                                  (uint8_t)((((frq / 1000U + 1) * 2U * 2U) >> 8) & 0xFFU)
 
-#define AUDIO_FB_DEFAULT 0x1800ED70 // I2S_Clk_Config24[2].nominal_fdbk (96kHz, 24bit, USE_MCLK_OUT false)
+#define AUDIO_PACKET_SZE_32B(frq) (uint8_t)(((frq / 1000U + 1) * 2U * 4U) & 0xFFU), \
+                                  (uint8_t)((((frq / 1000U + 1) * 2U * 4U) >> 8) & 0xFFU)
 
-// DbgFeedbackHistory is limited to +/- 1kHz
-#define  AUDIO_FB_DELTA_MAX (uint32_t)(1 << 22)
+
+#define AUDIO_FB_DEFAULT 0x18000000 // 96kHz nominal, AUDIO_OUT_Restart loads I2S_Clk_Config24[].nominal_fdbk
 
 static uint8_t USBD_AUDIO_Init(USBD_HandleTypeDef* pdev, uint8_t cfgidx);
 static uint8_t USBD_AUDIO_DeInit(USBD_HandleTypeDef* pdev, uint8_t cfgidx);
@@ -67,9 +71,23 @@ static void AUDIO_REQ_GetMax(USBD_HandleTypeDef* pdev, USBD_SetupReqTypedef* req
 static void AUDIO_REQ_GetMin(USBD_HandleTypeDef* pdev, USBD_SetupReqTypedef* req);
 static void AUDIO_REQ_GetRes(USBD_HandleTypeDef* pdev, USBD_SetupReqTypedef* req);
 static void AUDIO_REQ_SetCurrent(USBD_HandleTypeDef* pdev, USBD_SetupReqTypedef* req);
+static void AUDIO_OUT_Reset(USBD_HandleTypeDef* pdev);
 static void AUDIO_OUT_StopAndReset(USBD_HandleTypeDef* pdev);
+static void AUDIO_OUT_Configure(USBD_AUDIO_HandleTypeDef* haudio);
 static void AUDIO_OUT_Restart(USBD_HandleTypeDef* pdev);
-static int32_t USBD_AUDIO_Get_Vol3dB_Shift(int16_t volume);
+static void AUDIO_OUT_Switch(USBD_HandleTypeDef* pdev);
+static int32_t USBD_AUDIO_Get_Gain(int16_t volume);
+static void AUDIO_OUT_SelectConverter(USBD_AUDIO_HandleTypeDef* haudio, uint8_t ramp);
+static void AUDIO_OUT_PrepareRx(USBD_HandleTypeDef* pdev, USBD_AUDIO_HandleTypeDef* haudio);
+static void AUDIO_OUT_SetBuffer(USBD_AUDIO_HandleTypeDef* haudio);
+static uint8_t AUDIO_OUT_Overrun(USBD_AUDIO_HandleTypeDef* haudio, uint32_t out_frames);
+static void AUDIO_OUT_Conceal(USBD_AUDIO_HandleTypeDef* haudio);
+static void AUDIO_OUT_Recover(USBD_AUDIO_HandleTypeDef* haudio);
+static uint32_t AUDIO_OUT_StartWords(USBD_AUDIO_HandleTypeDef* haudio);
+static void AUDIO_OUT_StartDMA(USBD_HandleTypeDef* pdev);
+static void AUDIO_OUT_FirstPacket(USBD_AUDIO_HandleTypeDef* haudio, uint32_t length);
+static void AUDIO_OUT_SetFeedback(USBD_AUDIO_HandleTypeDef* haudio, uint32_t fb);
+static void AUDIO_OUT_ProcessQueue(USBD_AUDIO_HandleTypeDef* haudio);
 
 
 USBD_ClassTypeDef USBD_AUDIO = {
@@ -96,7 +114,7 @@ __ALIGN_BEGIN static uint8_t USBD_AUDIO_CfgDesc[USB_AUDIO_CONFIG_DESC_SIZ] __ALI
     USB_DESC_TYPE_CONFIGURATION,       /* bDescriptorType */
     LOBYTE(USB_AUDIO_CONFIG_DESC_SIZ), /* wTotalLength bytes*/
     HIBYTE(USB_AUDIO_CONFIG_DESC_SIZ),
-    0x02, /* bNumInterfaces */
+    AUDIO_NUM_INTERFACES, /* bNumInterfaces, 3 with USE_TELEMETRY */
     0x01, /* bConfigurationValue */
     0x00, /* iConfiguration */
     0x80, /* bmAttributes  BUS Powered (0xC0 = self-powered) */
@@ -188,7 +206,7 @@ __ALIGN_BEGIN static uint8_t USBD_AUDIO_CfgDesc[USB_AUDIO_CONFIG_DESC_SIZ] __ALI
     USB_DESC_TYPE_INTERFACE,       /* bDescriptorType */
     0x01,                          /* bInterfaceNumber */
     0x01,                          /* bAlternateSetting */
-    0x02,                          /* bNumEndpoints - 1 output & 1 feedback */
+    AUDIO_AS_NUM_EP,               /* bNumEndpoints - 1 output & 1 feedback, no feedback with USE_ADAPTIVE_EP */
     USB_DEVICE_CLASS_AUDIO,        /* bInterfaceClass */
     AUDIO_SUBCLASS_AUDIOSTREAMING, /* bInterfaceSubClass */
     AUDIO_PROTOCOL_UNDEFINED,      /* bInterfaceProtocol */
@@ -206,29 +224,111 @@ __ALIGN_BEGIN static uint8_t USBD_AUDIO_CfgDesc[USB_AUDIO_CONFIG_DESC_SIZ] __ALI
     // 07 byte
 
     // USB Speaker Audio Type I Format Interface Descriptor
-    17,                            /* bLength */
+    23,                            /* bLength */
     AUDIO_INTERFACE_DESCRIPTOR_TYPE, /* bDescriptorType */
     AUDIO_STREAMING_FORMAT_TYPE,     /* bDescriptorSubtype */
     AUDIO_FORMAT_TYPE_I,             /* bFormatType */
     2,                            /* bNrChannels */
     3,                            /* bSubFrameSize :  3 Bytes per frame (24bits) */
     24,                            /* bBitResolution (24-bits per sample) */
-    3,                            /* bSamFreqType 3 frequencies supported */
+    5,                            /* bSamFreqType 5 frequencies supported */
+    AUDIO_SAMPLE_FREQ(32000),        /* Audio sampling frequency coded on 3 bytes */
+    AUDIO_SAMPLE_FREQ(44100),        /* Audio sampling frequency coded on 3 bytes */
+    AUDIO_SAMPLE_FREQ(48000),        /* Audio sampling frequency coded on 3 bytes */
+    AUDIO_SAMPLE_FREQ(88200),        /* Audio sampling frequency coded on 3 bytes */
+    AUDIO_SAMPLE_FREQ(96000),        /* Audio sampling frequency coded on 3 bytes */
+    // 23 byte
+
+    // Endpoint 1 - Standard Descriptor
+	// Isochronous Async endpoint for audio packets, Adaptive with USE_ADAPTIVE_EP
+    AUDIO_STANDARD_ENDPOINT_DESC_SIZE,         /* bLength */
+    USB_DESC_TYPE_ENDPOINT,                    /* bDescriptorType */
+    AUDIO_OUT_EP,                              /* bEndpointAddress 1 out endpoint*/
+    AUDIO_OUT_EP_ATTRIBUTES,                   /* bmAttributes */
+    AUDIO_PACKET_SZE_24B(AUDIO_OUT_FREQ_MAX_24B), /* wMaxPacketSize in Bytes (freq / 1000 + extra_samples) * channels * bytes_per_sample */
+    0x01,                                      /* bInterval */
+    0x00,                                      /* bRefresh */
+    AUDIO_OUT_EP_SYNCH,                        /* bSynchAddress */
+    // 09 byte
+
+    // Endpoint - Audio Streaming Descriptor
+    AUDIO_STREAMING_ENDPOINT_DESC_SIZE, /* bLength */
+    AUDIO_ENDPOINT_DESCRIPTOR_TYPE,     /* bDescriptorType */
+    AUDIO_ENDPOINT_GENERAL,             /* bDescriptor */
+    0x01,                               /* bmAttributes - Sampling Frequency control is supported. See UAC Spec 1.0 p.62 */
+    0x00,                               /* bLockDelayUnits */
+    0x00,                               /* wLockDelay */
+    0x00,
+    // 07 byte
+
+#ifndef USE_ADAPTIVE_EP
+    // Endpoint 2 - Standard Descriptor - See UAC Spec 1.0 p.63 4.6.2.1 Standard AS Isochronous Synch Endpoint Descriptor
+	// 3byte 10.14 sampling frequency feedback to host
+    AUDIO_STANDARD_ENDPOINT_DESC_SIZE, /* bLength */
+    USB_DESC_TYPE_ENDPOINT,            /* bDescriptorType */
+    AUDIO_IN_EP,                       /* bEndpointAddress */
+    0x11,                              /* bmAttributes */
+    0x03, 0x00,                        /* wMaxPacketSize in Bytes */
+    0x01,                              /* bInterval 1ms */
+    SOF_RATE,                          /* bRefresh 2^SOF_RATE ms */
+    0x00,                              /* bSynchAddress */
+    // 09 byte
+#endif
+
+    // USB Speaker Standard AS Interface Descriptor
+    // Interface 1, Alternate Setting 2
+	// 16bit audio streaming, 2/3 of the USB bandwidth of the 24bit setting
+    AUDIO_INTERFACE_DESC_SIZE,     /* bLength */
+    USB_DESC_TYPE_INTERFACE,       /* bDescriptorType */
+    0x01,                          /* bInterfaceNumber */
+    AUDIO_ALT_SETTING_16B,         /* bAlternateSetting */
+    AUDIO_AS_NUM_EP,               /* bNumEndpoints - 1 output & 1 feedback, no feedback with USE_ADAPTIVE_EP */
+    USB_DEVICE_CLASS_AUDIO,        /* bInterfaceClass */
+    AUDIO_SUBCLASS_AUDIOSTREAMING, /* bInterfaceSubClass */
+    AUDIO_PROTOCOL_UNDEFINED,      /* bInterfaceProtocol */
+    0x00,                          /* iInterface */
+    // 09 byte
+
+    // USB Speaker Audio Streaming Interface Descriptor
+    AUDIO_STREAMING_INTERFACE_DESC_SIZE, /* bLength */
+    AUDIO_INTERFACE_DESCRIPTOR_TYPE,     /* bDescriptorType */
+    AUDIO_STREAMING_GENERAL,             /* bDescriptorSubtype */
+    0x01,                                /* bTerminalLink */
+    0x01,                                /* bDelay */
+    0x01,                                /* wFormatTag AUDIO_FORMAT_PCM  0x0001*/
+    0x00,
+    // 07 byte
+
+    // USB Speaker Audio Type I Format Interface Descriptor
+    AUDIO_FORMAT_16B_DESC_SIZE,      /* bLength */
+    AUDIO_INTERFACE_DESCRIPTOR_TYPE, /* bDescriptorType */
+    AUDIO_STREAMING_FORMAT_TYPE,     /* bDescriptorSubtype */
+    AUDIO_FORMAT_TYPE_I,             /* bFormatType */
+    2,                            /* bNrChannels */
+    2,                            /* bSubFrameSize :  2 Bytes per frame (16bits) */
+    16,                            /* bBitResolution (16-bits per sample) */
+    AUDIO_FORMAT_16B_FREQ_NUM,     /* bSamFreqType 7 frequencies supported, 5 with USE_FIXED_CLOCK at 96kHz */
+    AUDIO_SAMPLE_FREQ(32000),        /* Audio sampling frequency coded on 3 bytes */
     AUDIO_SAMPLE_FREQ(44100),        /* Audio sampling frequency coded on 3 bytes */
     AUDIO_SAMPLE_FREQ(48000),        /* Audio sampling frequency coded on 3 bytes */
+    AUDIO_SAMPLE_FREQ(88200),        /* Audio sampling frequency coded on 3 bytes */
     AUDIO_SAMPLE_FREQ(96000),        /* Audio sampling frequency coded on 3 bytes */
-    // 17 byte
+#if AUDIO_OUT_FREQ_MAX_16B > 96000U
+    AUDIO_SAMPLE_FREQ(176400),        /* Audio sampling frequency coded on 3 bytes */
+    AUDIO_SAMPLE_FREQ(192000),        /* Audio sampling frequency coded on 3 bytes */
+#endif
+    // 29 byte, 23 byte with USE_FIXED_CLOCK at 96kHz
 
     // Endpoint 1 - Standard Descriptor
-	// Isochronous Async endpoint for audio packets
+	// Isochronous Async endpoint for audio packets, Adaptive with USE_ADAPTIVE_EP
     AUDIO_STANDARD_ENDPOINT_DESC_SIZE,         /* bLength */
     USB_DESC_TYPE_ENDPOINT,                    /* bDescriptorType */
     AUDIO_OUT_EP,                              /* bEndpointAddress 1 out endpoint*/
-    USBD_EP_TYPE_ISOC_ASYNC,                   /* bmAttributes */
-    AUDIO_PACKET_SZE_24B(USBD_AUDIO_FREQ_MAX), /* wMaxPacketSize in Bytes (freq / 1000 + extra_samples) * channels * bytes_per_sample */
+    AUDIO_OUT_EP_ATTRIBUTES,                   /* bmAttributes */
+    AUDIO_PACKET_SZE_16B(AUDIO_OUT_FREQ_MAX_16B), /* wMaxPacketSize in Bytes (freq / 1000 + extra_samples) * channels * bytes_per_sample */
     0x01,                                      /* bInterval */
     0x00,                                      /* bRefresh */
-    AUDIO_IN_EP,                               /* bSynchAddress */
+    AUDIO_OUT_EP_SYNCH,                        /* bSynchAddress */
     // 09 byte
 
     // Endpoint - Audio Streaming Descriptor
@@ -241,6 +341,7 @@ __ALIGN_BEGIN static uint8_t USBD_AUDIO_CfgDesc[USB_AUDIO_CONFIG_DESC_SIZ] __ALI
     0x00,
     // 07 byte
 
+#ifndef USE_ADAPTIVE_EP
     // Endpoint 2 - Standard Descriptor - See UAC Spec 1.0 p.63 4.6.2.1 Standard AS Isochronous Synch Endpoint Descriptor
 	// 3byte 10.14 sampling frequency feedback to host
     AUDIO_STANDARD_ENDPOINT_DESC_SIZE, /* bLength */
@@ -249,10 +350,128 @@ __ALIGN_BEGIN static uint8_t USBD_AUDIO_CfgDesc[USB_AUDIO_CONFIG_DESC_SIZ] __ALI
     0x11,                              /* bmAttributes */
     0x03, 0x00,                        /* wMaxPacketSize in Bytes */
     0x01,                              /* bInterval 1ms */
-    SOF_RATE,                          /* bRefresh 4ms = 2^2 */
+    SOF_RATE,                          /* bRefresh 2^SOF_RATE ms */
     0x00,                              /* bSynchAddress */
     // 09 byte
+#endif
+
+    // USB Speaker Standard AS Interface Descriptor
+    // Interface 1, Alternate Setting 3
+	// 24bit samples in 4 byte subframes, for hosts that deliver S24_in_32 / S32 natively
+    AUDIO_INTERFACE_DESC_SIZE,     /* bLength */
+    USB_DESC_TYPE_INTERFACE,       /* bDescriptorType */
+    0x01,                          /* bInterfaceNumber */
+    AUDIO_ALT_SETTING_32B,         /* bAlternateSetting */
+    AUDIO_AS_NUM_EP,               /* bNumEndpoints - 1 output & 1 feedback, no feedback with USE_ADAPTIVE_EP */
+    USB_DEVICE_CLASS_AUDIO,        /* bInterfaceClass */
+    AUDIO_SUBCLASS_AUDIOSTREAMING, /* bInterfaceSubClass */
+    AUDIO_PROTOCOL_UNDEFINED,      /* bInterfaceProtocol */
+    0x00,                          /* iInterface */
+    // 09 byte
 
+    // USB Speaker Audio Streaming Interface Descriptor
+    AUDIO_STREAMING_INTERFACE_DESC_SIZE, /* bLength */
+    AUDIO_INTERFACE_DESCRIPTOR_TYPE,     /* bDescriptorType */
+    AUDIO_STREAMING_GENERAL,             /* bDescriptorSubtype */
+    0x01,                                /* bTerminalLink */
+    0x01,                                /* bDelay */
+    0x01,                                /* wFormatTag AUDIO_FORMAT_PCM  0x0001*/
+    0x00,
+    // 07 byte
+
+    // USB Speaker Audio Type I Format Interface Descriptor
+    23,                            /* bLength */
+    AUDIO_INTERFACE_DESCRIPTOR_TYPE, /* bDescriptorType */
+    AUDIO_STREAMING_FORMAT_TYPE,     /* bDescriptorSubtype */
+    AUDIO_FORMAT_TYPE_I,             /* bFormatType */
+    2,                            /* bNrChannels */
+    4,                            /* bSubFrameSize :  4 Bytes per frame */
+    24,                            /* bBitResolution (24-bits per sample, left-aligned) */
+    5,                            /* bSamFreqType 5 frequencies supported */
+    AUDIO_SAMPLE_FREQ(32000),        /* Audio sampling frequency coded on 3 bytes */
+    AUDIO_SAMPLE_FREQ(44100),        /* Audio sampling frequency coded on 3 bytes */
+    AUDIO_SAMPLE_FREQ(48000),        /* Audio sampling frequency coded on 3 bytes */
+    AUDIO_SAMPLE_FREQ(88200),        /* Audio sampling frequency coded on 3 bytes */
+    AUDIO_SAMPLE_FREQ(96000),        /* Audio sampling frequency coded on 3 bytes */
+    // 23 byte
+
+    // Endpoint 1 - Standard Descriptor
+	// Isochronous Async endpoint for audio packets, Adaptive with USE_ADAPTIVE_EP
+    AUDIO_STANDARD_ENDPOINT_DESC_SIZE,         /* bLength */
+    USB_DESC_TYPE_ENDPOINT,                    /* bDescriptorType */
+    AUDIO_OUT_EP,                              /* bEndpointAddress 1 out endpoint*/
+    AUDIO_OUT_EP_ATTRIBUTES,                   /* bmAttributes */
+    AUDIO_PACKET_SZE_32B(AUDIO_OUT_FREQ_MAX_32B), /* wMaxPacketSize in Bytes (freq / 1000 + extra_samples) * channels * bytes_per_sample */
+    0x01,                                      /* bInterval */
+    0x00,                                      /* bRefresh */
+    AUDIO_OUT_EP_SYNCH,                        /* bSynchAddress */
+    // 09 byte
+
+    // Endpoint - Audio Streaming Descriptor
+    AUDIO_STREAMING_ENDPOINT_DESC_SIZE, /* bLength */
+    AUDIO_ENDPOINT_DESCRIPTOR_TYPE,     /* bDescriptorType */
+    AUDIO_ENDPOINT_GENERAL,             /* bDescriptor */
+    0x01,                               /* bmAttributes - Sampling Frequency control is supported. See UAC Spec 1.0 p.62 */
+    0x00,                               /* bLockDelayUnits */
+    0x00,                               /* wLockDelay */
+    0x00,
+    // 07 byte
+
+#ifndef USE_ADAPTIVE_EP
+    // Endpoint 2 - Standard Descriptor - See UAC Spec 1.0 p.63 4.6.2.1 Standard AS Isochronous Synch Endpoint Descriptor
+	// 3byte 10.14 sampling frequency feedback to host
+    AUDIO_STANDARD_ENDPOINT_DESC_SIZE, /* bLength */
+    USB_DESC_TYPE_ENDPOINT,            /* bDescriptorType */
+    AUDIO_IN_EP,                       /* bEndpointAddress */
+    0x11,                              /* bmAttributes */
+    0x03, 0x00,                        /* wMaxPacketSize in Bytes */
+    0x01,                              /* bInterval 1ms */
+    SOF_RATE,                          /* bRefresh 2^SOF_RATE ms */
+    0x00,                              /* bSynchAddress */
+    // 09 byte
+#endif
+
+#ifdef USE_TELEMETRY
+    // Telemetry Standard interface descriptor, Interface 2, vendor specific
+    AUDIO_INTERFACE_DESC_SIZE,     /* bLength */
+    USB_DESC_TYPE_INTERFACE,       /* bDescriptorType */
+    AUDIO_TELEM_ITF,               /* bInterfaceNumber */
+    0x00,                          /* bAlternateSetting */
+    0x01,                          /* bNumEndpoints */
+    0xFF,                          /* bInterfaceClass vendor specific */
+    0x00,                          /* bInterfaceSubClass */
+    0x00,                          /* bInterfaceProtocol */
+    0x00,                          /* iInterface */
+    // 09 byte
+
+    // Endpoint 2 - Standard Descriptor
+    // Bulk IN endpoint for the per-SOF telemetry records, see usbd_audio_telem.h
+    0x07,                          /* bLength */
+    USB_DESC_TYPE_ENDPOINT,        /* bDescriptorType */
+    AUDIO_TELEM_EP,                /* bEndpointAddress */
+    USBD_EP_TYPE_BULK,             /* bmAttributes */
+    LOBYTE(AUDIO_TELEM_PACKET),    /* wMaxPacketSize */
+    HIBYTE(AUDIO_TELEM_PACKET),
+    0x00,                          /* bInterval */
+    // 07 byte
+#endif
+
+};
+
+// Bit depth of each audio streaming alternate setting
+static const uint8_t AUDIO_AltBitDepth[AUDIO_ALT_SETTING_NUM] = {
+    0,  /* zero bandwidth */
+    24, /* AUDIO_ALT_SETTING_24B */
+    16, /* AUDIO_ALT_SETTING_16B */
+    32, /* AUDIO_ALT_SETTING_32B, 24bit samples in 4 byte subframes */
+};
+
+// Highest sampling frequency of each audio streaming alternate setting, as listed in its format descriptor
+static const uint32_t AUDIO_AltFreqMax[AUDIO_ALT_SETTING_NUM] = {
+    USBD_AUDIO_FREQ_MAX,    /* zero bandwidth */
+    AUDIO_OUT_FREQ_MAX_24B, /* AUDIO_ALT_SETTING_24B */
+    AUDIO_OUT_FREQ_MAX_16B, /* AUDIO_ALT_SETTING_16B */
+    AUDIO_OUT_FREQ_MAX_32B, /* AUDIO_ALT_SETTING_32B */
 };
 
 /** 
@@ -278,7 +497,18 @@ volatile uint32_t all_ready = 0;
 
 volatile uint32_t fb_nom = AUDIO_FB_DEFAULT;
 volatile uint32_t fb_value = AUDIO_FB_DEFAULT;
-volatile uint32_t audio_buf_writable_samples_last = AUDIO_TOTAL_BUF_SIZE /(2*6);
+
+volatile USBD_AUDIO_XrunTypeDef USBD_AUDIO_Xrun = {0};
+
+// Class data USBD_AUDIO_ProcessPackets converts with, and class data released by USBD_AUDIO_DeInit
+// during the conversion, freed when it is done
+static void* volatile audio_conv_data = NULL;
+static void* volatile audio_free_data = NULL;
+static uint32_t xrun_report[2]; // AUDIO_VENDOR_REQ_GET_XRUN data stage
+
+// Latency profile, kept across re-enumeration, applied when the stream (re)starts
+static const uint8_t AUDIO_LatencyPackets[AUDIO_LATENCY_PROFILE_NUM] = AUDIO_LATENCY_PACKETS;
+static uint8_t latency_profile = AUDIO_LATENCY_PROFILE_DEFAULT;
 
 volatile uint8_t fb_data[3] = {
     (uint8_t)((AUDIO_FB_DEFAULT >> 8) & 0x000000FF),
@@ -289,11 +519,143 @@ volatile uint8_t fb_data[3] = {
 // FNSOF is critical for frequency changing to work
 volatile uint32_t fnsof = 0;
 
-// volume attenuation is from 0dB (max volume, 0x0000) to -96dB (min volume, 0xA000) in 3dB steps
-static int32_t USBD_AUDIO_Get_Vol3dB_Shift(int16_t volume ){
+// Frame in which the host last read the feedback endpoint, valid until an IN transfer is missed
+volatile uint32_t fb_poll_frame = 0;
+volatile uint32_t fb_poll_valid = 0;
+
+// volume attenuation is from 0dB (max volume, 0x0000) to -127dB (min volume, 0x8100) in 1/256dB steps
+static int32_t USBD_AUDIO_Get_Gain(int16_t volume ){
 	if (volume < (int16_t)USBD_AUDIO_VOL_MIN) volume = (int16_t)USBD_AUDIO_VOL_MIN;
 	if (volume > (int16_t)USBD_AUDIO_VOL_MAX) volume = (int16_t)USBD_AUDIO_VOL_MAX;
-	return (int32_t)((((int16_t)USBD_AUDIO_VOL_MAX - volume) + (int16_t)USBD_AUDIO_VOL_STEP/2)/(int16_t)USBD_AUDIO_VOL_STEP);
+	return AUDIO_Conv_VolumeToGain(volume);
+	}
+
+// Select the packet conversion kernel once, when the stream format, volume or mute setting
+// changes, instead of testing the volume mode for every sample in USBD_AUDIO_ProcessPackets.
+// With ramp = 1 the gain change is interpolated over the next packet.
+static void AUDIO_OUT_SelectConverter(USBD_AUDIO_HandleTypeDef* haudio, uint8_t ramp){
+	AUDIO_Conv_Select(&haudio->conv, haudio->bit_depth/8, haudio->gain, haudio->mute, ramp);
+	}
+
+// Sampling frequency is in the I2S clock table and within the packet size limit of the alternate setting
+static uint8_t AUDIO_OUT_FreqSupported(uint8_t alt_setting, uint32_t freq){
+	return (BSP_AUDIO_OUT_GetFreqIndex(freq) >= 0) && (freq <= AUDIO_AltFreqMax[alt_setting]);
+	}
+
+// Sampling frequency of the I2S clock and the ring buffer : the stream frequency,
+// or AUDIO_FIXED_FREQ with USE_FIXED_CLOCK
+static uint32_t AUDIO_OUT_I2SFreq(USBD_AUDIO_HandleTypeDef* haudio){
+#ifdef USE_FIXED_CLOCK
+	UNUSED(haudio);
+	return AUDIO_FIXED_FREQ;
+#else
+	return haudio->freq;
+#endif
+	}
+
+// Where the next packet is received : directly into the audio buffer, rx_offset bytes ahead of the
+// write pointer, so that USBD_AUDIO_DataOut can convert it in place. The first packet of the stream is
+// received after the ring buffer, which the DMA plays, and moved by AUDIO_OUT_FirstPacket. With USE_ADAPTIVE_EP or
+// USE_FIXED_CLOCK the packet is resampled, so it is received in the slot of the queue entry it will be queued in.
+static uint8_t* AUDIO_OUT_RxAddr(USBD_AUDIO_HandleTypeDef* haudio){
+#ifdef AUDIO_OUT_RESAMPLE
+	return (uint8_t*)haudio->rx_slot[haudio->queue.head & (AUDIO_OUT_QUEUE_SIZE - 1U)];
+#else
+	if (haudio->offset == AUDIO_OFFSET_UNKNOWN) {
+		return (uint8_t*)&haudio->buffer[haudio->buf_size] + haudio->rx_offset;
+		}
+	return (uint8_t*)&haudio->buffer[haudio->wr_ptr] + haudio->rx_offset;
+#endif
+	}
+
+// Arm the OUT endpoint to receive the next packet
+static void AUDIO_OUT_PrepareRx(USBD_HandleTypeDef* pdev, USBD_AUDIO_HandleTypeDef* haudio){
+	haudio->rx_buf = AUDIO_OUT_RxAddr(haudio);
+	USBD_LL_PrepareReceive(pdev, AUDIO_OUT_EP, haudio->rx_buf, AUDIO_OUT_PACKET_MAX);
+	}
+
+// Ring buffer size for the latency profile at the current I2S frequency, and the receive offset
+// of the current format, (8 - input bytes per frame) * frames as for AUDIO_OUT_RX_OFFSET.
+// The largest packet of the frequency stays clear of the unplayed frames as long as there is one
+// packet of writable space, which the feedback setpoint of half the buffer leaves even for profile 0.
+static void AUDIO_OUT_SetBuffer(USBD_AUDIO_HandleTypeDef* haudio){
+	uint32_t frames = AUDIO_OUT_FRAMES(AUDIO_OUT_I2SFreq(haudio));
+	uint32_t buf_frames = 2U * AUDIO_LatencyPackets[latency_profile] * frames;
+	if (buf_frames > AUDIO_TOTAL_BUF_FRAMES_MAX) {
+		buf_frames = AUDIO_TOTAL_BUF_FRAMES_MAX;
+		}
+	haudio->buf_size = (uint16_t)(buf_frames * 2U);
+	haudio->safezone = (uint16_t)frames;
+	haudio->xrun_margin_words = (uint16_t)frames;
+	haudio->rx_offset = (uint16_t)(((8U - haudio->bit_depth/4U) * frames + 3U) & ~3U);
+#ifdef DEBUG_FEEDBACK_ENDPOINT
+	DbgOptimalWritableSamples = buf_frames/2U;
+	DbgSafeZoneWritableSamples = frames;
+#endif
+	}
+
+// Writable words from wr_ptr to the read position, as in USBD_AUDIO_SOF
+static inline uint32_t AUDIO_OUT_Writable(uint32_t rd, uint32_t wr, uint32_t size){
+	return rd < wr ? rd + size - wr : rd - wr;
+	}
+
+// Silence words of the ring buffer of size words from pos, wrapping at the end
+static void AUDIO_OUT_Silence(uint32_t* buffer, uint32_t pos, uint32_t words, uint32_t size){
+	uint32_t words_end = (words < size - pos) ? words : size - pos;
+	USBD_memset(&buffer[pos], 0, words_end*4U);
+	USBD_memset(&buffer[0], 0, (words - words_end)*4U);
+	}
+
+// Overrun : after the packet of out_frames less than half a packet would be writable, so the next packet,
+// received ahead of wr_ptr, could overwrite frames not played yet. rd_ptr of the last SOF lags the DMA,
+// the DMA position is only read when the space looks short.
+static uint8_t AUDIO_OUT_Overrun(USBD_AUDIO_HandleTypeDef* haudio, uint32_t out_frames){
+	uint32_t need = out_frames*2U + haudio->xrun_margin_words;
+	if ((is_playing == 0U) || (AUDIO_OUT_Writable(haudio->rd_ptr, haudio->wr_ptr, haudio->buf_size) >= need)) {
+		return 0U;
+		}
+	return AUDIO_OUT_Writable(BSP_AUDIO_OUT_GetPlayPosition() >> 8, haudio->wr_ptr, haudio->buf_size) < need;
+	}
+
+// Underrun : fade the frames left to play to silence, up to half a packet, and silence the rest of the ring
+// buffer, so the DMA plays silence instead of old frames until the host sends again.
+// Runs in PendSV after the packets queued before the underrun, later packets are not queued.
+static void AUDIO_OUT_Conceal(USBD_AUDIO_HandleTypeDef* haudio){
+	uint32_t size = haudio->buf_size;
+	uint32_t pos = haudio->rd_ptr + AUDIO_OUT_XRUN_MARGIN;
+	if (pos >= size) {
+		pos -= size;
+		}
+	// in frames, half a packet is xrun_margin_words/2 frames
+	uint32_t fade = AUDIO_OUT_Writable(haudio->wr_ptr, pos, size)/2U;
+	if (fade > haudio->xrun_margin_words/2U) {
+		fade = haudio->xrun_margin_words/2U;
+		}
+	AUDIO_Conv_FadeOut(haudio->buffer, pos, size, fade);
+	pos += fade*2U;
+	if (pos >= size) {
+		pos -= size;
+		}
+	AUDIO_OUT_Silence(haudio->buffer, pos, size - AUDIO_OUT_XRUN_MARGIN - fade*2U, size);
+	}
+
+// First packet after an underrun : the packet is dropped, it was received at the old write position,
+// which is silenced. Writing restarts ahead of the DMA with the fill level of the start of the stream,
+// AUDIO_OUT_StartWords plus the dropped packet, and the converter ramps up from silence over the next packet.
+static void AUDIO_OUT_Recover(USBD_AUDIO_HandleTypeDef* haudio){
+#ifndef AUDIO_OUT_RESAMPLE
+	USBD_memset(haudio->rx_buf, 0, AUDIO_OUT_PACKET_MAX);
+#endif
+	// the dropped packet is safezone frames, safezone*2 words
+	uint32_t wr = ((BSP_AUDIO_OUT_GetPlayPosition() >> 8) + AUDIO_OUT_StartWords(haudio) + haudio->safezone*2U) & ~1U;
+	if (wr >= haudio->buf_size) {
+		wr -= haudio->buf_size;
+		}
+	haudio->wr_ptr = (uint16_t)wr;
+	// no packet is queued, the converter is not in use
+	haudio->conv.gain = 0;
+	haudio->conv_update = 1U;
+	haudio->xrun = AUDIO_OUT_XRUN_NONE;
 	}
 
 /**
@@ -308,9 +670,10 @@ static uint8_t USBD_AUDIO_Init(USBD_HandleTypeDef* pdev, uint8_t cfgidx)
   USBD_AUDIO_HandleTypeDef* haudio;
 
   /* Open EP OUT */
-  USBD_LL_OpenEP(pdev, AUDIO_OUT_EP, USBD_EP_TYPE_ISOC, AUDIO_OUT_PACKET_24B);
+  USBD_LL_OpenEP(pdev, AUDIO_OUT_EP, USBD_EP_TYPE_ISOC, AUDIO_OUT_PACKET_MAX);
   pdev->ep_out[AUDIO_OUT_EP & 0xFU].is_used = 1U;
 
+#ifndef USE_ADAPTIVE_EP
   /* Open EP IN */
   USBD_LL_OpenEP(pdev, AUDIO_IN_EP, USBD_EP_TYPE_ISOC, AUDIO_IN_PACKET);
   pdev->ep_in[AUDIO_IN_EP & 0xFU].is_used = 1U;
@@ -323,6 +686,17 @@ static uint8_t USBD_AUDIO_Init(USBD_HandleTypeDef* pdev, uint8_t cfgidx)
    * device is not ready.
    */
   tx_flag = 1U;
+#endif
+
+#ifdef USE_TELEMETRY
+  AUDIO_Telem_Init(pdev);
+#endif
+
+#ifdef DEBUG_FEEDBACK_ENDPOINT
+  // DWT cycle counter for DbgDataOutCycles
+  CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+  DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+#endif
 
   /* Allocate Audio structure */
   pdev->pClassData = USBD_malloc(sizeof(USBD_AUDIO_HandleTypeDef));
@@ -336,14 +710,28 @@ static uint8_t USBD_AUDIO_Init(USBD_HandleTypeDef* pdev, uint8_t cfgidx)
     haudio->wr_ptr = 0U;
     haudio->rd_ptr = 0U;
     haudio->rd_enable = 0U;
+    haudio->xrun = AUDIO_OUT_XRUN_NONE;
+    haudio->rx_buf = NULL;
+    haudio->conv_update = 0U;
+    haudio->queue.head = 0U;
+    haudio->queue.tail = 0U;
+    haudio->queue.gen = 0U;
+#ifdef AUDIO_OUT_RESAMPLE
+    haudio->asrc_gen = 0U;
+#endif
     haudio->freq = USBD_AUDIO_FREQ_DEFAULT;
     haudio->bit_depth = USBD_AUDIO_BIT_DEPTH_DEFAULT;
     haudio->volume = USBD_AUDIO_VOL_DEFAULT;
-    haudio->vol_3dB_shift = USBD_AUDIO_Get_Vol3dB_Shift(USBD_AUDIO_VOL_DEFAULT);
+    haudio->gain = USBD_AUDIO_Get_Gain(USBD_AUDIO_VOL_DEFAULT);
     haudio->mute = USBD_AUDIO_MUTE_DEFAULT;
+    AUDIO_OUT_SelectConverter(haudio, 0U);
+    AUDIO_OUT_SetBuffer(haudio);
+#ifdef AUDIO_OUT_RESAMPLE
+    AUDIO_ASRC_Init(&haudio->asrc);
+#endif
 
     // Initialize the Audio output Hardware layer
-    if (((USBD_AUDIO_ItfTypeDef*)pdev->pUserData)->Init(haudio->freq, haudio->volume, haudio->mute) != 0) {
+    if (((USBD_AUDIO_ItfTypeDef*)pdev->pUserData)->Init(AUDIO_OUT_I2SFreq(haudio), haudio->volume, haudio->mute) != 0) {
       return USBD_FAIL;
     }
   }
@@ -362,24 +750,44 @@ static uint8_t USBD_AUDIO_DeInit(USBD_HandleTypeDef* pdev,
 {
   /* Flush all endpoints */
   USBD_LL_FlushEP(pdev, AUDIO_OUT_EP);
+#ifndef USE_ADAPTIVE_EP
   USBD_LL_FlushEP(pdev, AUDIO_IN_EP);
+#endif
 
   /* Close EP OUT */
   USBD_LL_CloseEP(pdev, AUDIO_OUT_EP);
   pdev->ep_out[AUDIO_OUT_EP & 0xFU].is_used = 0U;
 
+#ifndef USE_ADAPTIVE_EP
   /* Close EP IN */
   USBD_LL_CloseEP(pdev, AUDIO_IN_EP);
   pdev->ep_in[AUDIO_IN_EP & 0xFU].is_used = 0U;
 
   /* Clear feedback transmission flag */
   tx_flag = 0U;
+#endif
+
+#ifdef USE_TELEMETRY
+  AUDIO_Telem_DeInit(pdev);
+#endif
+
+#ifdef USE_FB_TIMER
+  BSP_AUDIO_OUT_SofTimerDeInit();
+#endif
 
   /* DeInit physical Interface components */
   if (pdev->pClassData != NULL) {
     ((USBD_AUDIO_ItfTypeDef*)pdev->pUserData)->DeInit(0U);
-    USBD_free(pdev->pClassData);
+    // PendSV may be converting a packet with the class data : the packets still queued are discarded
+    // and the data is freed when the conversion is done, see USBD_AUDIO_ProcessPackets
+    USBD_AUDIO_HandleTypeDef* haudio = (USBD_AUDIO_HandleTypeDef*)pdev->pClassData;
+    haudio->queue.gen++;
     pdev->pClassData = NULL;
+    if (haudio == audio_conv_data) {
+      audio_free_data = haudio;
+    } else {
+      USBD_free(haudio);
+    }
   }
 
   return USBD_OK;
@@ -456,6 +864,13 @@ static uint8_t USBD_AUDIO_Setup(USBD_HandleTypeDef* pdev,
           break;
 
         case USB_REQ_GET_INTERFACE:
+#ifdef USE_TELEMETRY
+          // the telemetry interface only has alternate setting 0
+          if (LOBYTE(req->wIndex) == AUDIO_TELEM_ITF) {
+            USBD_CtlSendData(pdev, (uint8_t*)(void*)&status_info, 1U);
+            break;
+          }
+#endif
           if (pdev->dev_state == USBD_STATE_CONFIGURED) {
             USBD_CtlSendData(pdev, (uint8_t*)(void*)&haudio->alt_setting, 1U);
           } else {
@@ -465,8 +880,17 @@ static uint8_t USBD_AUDIO_Setup(USBD_HandleTypeDef* pdev,
           break;
 
         case USB_REQ_SET_INTERFACE:
+#ifdef USE_TELEMETRY
+          if (LOBYTE(req->wIndex) == AUDIO_TELEM_ITF) {
+            if ((uint8_t)(req->wValue) != 0U) {
+              USBD_CtlError(pdev, req);
+              ret = USBD_FAIL;
+            }
+            break;
+          }
+#endif
           if (pdev->dev_state == USBD_STATE_CONFIGURED) {
-            if ((uint8_t)(req->wValue) <= USBD_MAX_NUM_INTERFACES) {
+            if ((uint8_t)(req->wValue) < AUDIO_ALT_SETTING_NUM) {
               /* Do things only when alt_setting changes */
               if (haudio->alt_setting != (uint8_t)(req->wValue)) {
                 haudio->alt_setting = (uint8_t)(req->wValue);
@@ -474,11 +898,13 @@ static uint8_t USBD_AUDIO_Setup(USBD_HandleTypeDef* pdev,
                 	AUDIO_OUT_StopAndReset(pdev);
                 	}
                 else {
-                	haudio->bit_depth = USBD_AUDIO_BIT_DEPTH_DEFAULT;
+                	haudio->bit_depth = AUDIO_AltBitDepth[haudio->alt_setting];
                   	AUDIO_OUT_Restart(pdev);
                 	}
               	}
+#ifndef USE_ADAPTIVE_EP
               USBD_LL_FlushEP(pdev, AUDIO_IN_EP);
+#endif
             } else {
               /* Call the error management function (command will be nacked */
               USBD_CtlError(pdev, req);
@@ -496,6 +922,50 @@ static uint8_t USBD_AUDIO_Setup(USBD_HandleTypeDef* pdev,
           break;
       }
       break;
+
+    /* Vendor Requests : latency profile */
+    case USB_REQ_TYPE_VENDOR:
+      // only for the audio streaming interface, not the control or the telemetry interface
+      if (((req->bmRequest & USB_REQ_RECIPIENT_MASK) != USB_REQ_RECIPIENT_INTERFACE) ||
+          (LOBYTE(req->wIndex) != AUDIO_AS_ITF)) {
+        USBD_CtlError(pdev, req);
+        ret = USBD_FAIL;
+        break;
+      }
+      switch (req->bRequest) {
+        case AUDIO_VENDOR_REQ_SET_LATENCY:
+          if ((req->wValue < AUDIO_LATENCY_PROFILE_NUM) && (req->wLength == 0U)) {
+            if (latency_profile != (uint8_t)req->wValue) {
+              latency_profile = (uint8_t)req->wValue;
+              // a running stream restarts with the new buffer size, otherwise applied at the next start
+              if ((haudio != NULL) && (haudio->alt_setting != 0U)) {
+                AUDIO_OUT_Restart(pdev);
+              }
+            }
+          } else {
+            USBD_CtlError(pdev, req);
+            ret = USBD_FAIL;
+          }
+          break;
+
+        case AUDIO_VENDOR_REQ_GET_LATENCY:
+          USBD_CtlSendData(pdev, &latency_profile, MIN(1U, req->wLength));
+          break;
+
+        case AUDIO_VENDOR_REQ_GET_XRUN:
+          // snapshot, the data stage is sent after the request is handled
+          xrun_report[0] = USBD_AUDIO_Xrun.underruns;
+          xrun_report[1] = USBD_AUDIO_Xrun.overruns;
+          USBD_CtlSendData(pdev, (uint8_t*)xrun_report, MIN(sizeof(xrun_report), req->wLength));
+          break;
+
+        default:
+          USBD_CtlError(pdev, req);
+          ret = USBD_FAIL;
+          break;
+      }
+      break;
+
     default:
       USBD_CtlError(pdev, req);
       ret = USBD_FAIL;
@@ -529,24 +999,136 @@ static uint8_t* USBD_AUDIO_GetCfgDesc(uint16_t* length)
 static uint8_t USBD_AUDIO_DataIn(USBD_HandleTypeDef* pdev,
                                  uint8_t epnum)
 {
+#ifndef USE_ADAPTIVE_EP
   /* epnum is the lowest 4 bits of bEndpointAddress. See UAC 1.0 spec, p.61 */
   if (epnum == (AUDIO_IN_EP & 0xf)) {
+    USB_OTG_GlobalTypeDef* USBx = USB_OTG_FS;
+    uint32_t USBx_BASE = (uint32_t)USBx;
+    fb_poll_frame = (USBx_DEVICE->DSTS & USB_OTG_DSTS_FNSOF) >> 8;
+    fb_poll_valid = 1U;
     tx_flag = 0U;
   }
+#endif
+#ifdef USE_TELEMETRY
+  if (epnum == (AUDIO_TELEM_EP & 0xf)) {
+    AUDIO_Telem_DataIn(pdev);
+  }
+#endif
   return USBD_OK;
 }
 
 
 #ifdef DEBUG_FEEDBACK_ENDPOINT
+volatile uint32_t  DbgOptimalWritableSamples = 0;
+volatile uint32_t  DbgSafeZoneWritableSamples = 0;
 volatile uint32_t  DbgMinWritableSamples = 99999;
 volatile uint32_t  DbgMaxWritableSamples = 0;
-volatile uint32_t  DbgSofHistory[256] = {0};
-volatile uint32_t  DbgWritableSampleHistory[256] = {0};
-volatile float     DbgFeedbackHistory[256] = {0};
-volatile uint8_t   DbgIndex = 0; // roll over every 256 entries
-static volatile uint32_t  DbgSofCounter = 0;
+volatile uint32_t  DbgDataOutCycles = 0;
+volatile uint32_t  DbgDataOutCyclesMax = 0;
+volatile uint32_t  DbgConvCycles = 0;
+volatile uint32_t  DbgConvCyclesMax = 0;
+volatile uint32_t  DbgOtgIsrCyclesMax = 0;
+volatile uint32_t  DbgQueueOverflows = 0;
+volatile uint32_t  DbgRestartCycles = 0;
+volatile uint32_t  DbgSwitchCycles = 0; // SET_CUR frequency to the I2S output of the first packet
+volatile uint8_t   DbgSwitchFast = 0;   // last switch used AUDIO_OUT_Switch
+volatile uint32_t  DbgStartCycles = 0;  // first packet of the stream to the I2S output of the first non-zero sample
+static uint32_t    dbg_switch_start;
+static uint8_t     dbg_switch_run = 0U;
+static uint32_t    dbg_start_cyc;
+static volatile uint8_t dbg_start_run = 0U;
+
+// DWT cycles until the DMA plays the word at words from the read position
+static uint32_t AUDIO_OUT_PlayCycles(USBD_AUDIO_HandleTypeDef* haudio, uint32_t words){
+	return (uint32_t)(((uint64_t)words * SystemCoreClock) / (2U * AUDIO_OUT_I2SFreq(haudio)));
+	}
+
+// Startup latency, called for each converted packet until the first non-zero sample is found.
+// The DMA distance to the sample gives the time it is played.
+static void AUDIO_OUT_DbgStartLatency(USBD_AUDIO_HandleTypeDef* haudio, uint32_t pos, uint32_t frames){
+	uint32_t size = haudio->buf_size;
+	for (uint32_t n = 0; n < frames*2U; n++) {
+		if (haudio->buffer[pos] != 0U) {
+			uint32_t rd = BSP_AUDIO_OUT_GetPlayPosition() >> 8;
+			DbgStartCycles = DWT->CYCCNT - dbg_start_cyc + AUDIO_OUT_PlayCycles(haudio, AUDIO_OUT_Writable(pos, rd, size));
+			dbg_start_run = 0U;
+			return;
+			}
+		if (++pos >= size) {
+			pos = 0U;
+			}
+		}
+	}
 #endif
 
+
+// Words from the DMA read position to the first packet of the stream : AUDIO_OUT_START_PACKETS packets,
+// at most the fill level of the latency profile less the packet
+static uint32_t AUDIO_OUT_StartWords(USBD_AUDIO_HandleTypeDef* haudio){
+	uint32_t words_max = haudio->buf_size/2U - haudio->safezone*2U;
+	uint32_t words = AUDIO_OUT_START_PACKETS * haudio->safezone * 2U;
+	if ((words == 0U) || (words > words_max)) {
+		words = words_max;
+		}
+	return words;
+	}
+
+// Start the DMA on the silent ring buffer when the stream (re)starts, after a frequency switch
+// once PLLI2S is locked (polled in USBD_AUDIO_SOF)
+static void AUDIO_OUT_StartDMA(USBD_HandleTypeDef* pdev){
+	USBD_AUDIO_HandleTypeDef* haudio;
+	haudio = (USBD_AUDIO_HandleTypeDef*)pdev->pClassData;
+	if ((is_playing == 0U) && (haudio->alt_setting != 0U) && BSP_AUDIO_OUT_ClockReady()) {
+		is_playing = 1U;
+		((USBD_AUDIO_ItfTypeDef*)pdev->pUserData)->AudioCmd(&haudio->buffer[0], haudio->buf_size * 4U, AUDIO_CMD_START);
+		}
+	}
+
+// First packet of the stream : it is placed AUDIO_OUT_StartWords ahead of the DMA, which plays silence
+// until then, instead of waiting for the buffer to fill up to the latency profile.
+// The packet was received after the ring buffer, see AUDIO_OUT_RxAddr.
+static void AUDIO_OUT_FirstPacket(USBD_AUDIO_HandleTypeDef* haudio, uint32_t length){
+	uint32_t size = haudio->buf_size;
+	uint32_t rd = BSP_AUDIO_OUT_GetPlayPosition() >> 8;
+	uint32_t wr = (rd + AUDIO_OUT_StartWords(haudio)) & ~1U;
+	if (wr >= size) {
+		wr -= size;
+		}
+#ifndef AUDIO_OUT_RESAMPLE
+	USBD_memmove((uint8_t*)&haudio->buffer[wr] + haudio->rx_offset, haudio->rx_buf, length);
+#else
+	UNUSED(length);
+#endif
+	haudio->rd_ptr = (uint16_t)rd;
+	haudio->wr_ptr = (uint16_t)wr;
+	haudio->offset = AUDIO_OFFSET_NONE;
+	haudio->rd_enable = 1U;
+#ifdef DEBUG_FEEDBACK_ENDPOINT
+	dbg_start_cyc = DWT->CYCCNT;
+	dbg_start_run = 1U;
+	if (dbg_switch_run) {
+		dbg_switch_run = 0U;
+		DbgSwitchCycles = dbg_start_cyc - dbg_switch_start + AUDIO_OUT_PlayCycles(haudio, AUDIO_OUT_Writable(wr, rd, size));
+		}
+#endif
+	}
+
+// Feedback packet data for the controller output fb, I2S frames per ms Q22
+static void AUDIO_OUT_SetFeedback(USBD_AUDIO_HandleTypeDef* haudio, uint32_t fb){
+#ifdef USE_FIXED_CLOCK
+	// the controller runs in I2S frames, the host sends stream frames at the fixed resampling ratio
+	uint32_t fb_host = (uint32_t)(((uint64_t)fb * haudio->freq) / AUDIO_FIXED_FREQ);
+#else
+	UNUSED(haudio);
+	uint32_t fb_host = fb;
+#endif
+	// Set 10.14 format feedback data
+	// Order of 3 bytes in feedback packet: { LO byte, MID byte, HI byte }
+	fb_data[0] = (uint8_t)((fb_host >> 8) & 0x000000FF);
+	fb_data[1] = (uint8_t)((fb_host >> 16) & 0x000000FF);
+	fb_data[2] = (uint8_t)((fb_host >> 24) & 0x000000FF);
+	}
+
 /**
   * @brief  USBD_AUDIO_SOF
   *         handle SOF event
@@ -557,93 +1139,158 @@ static uint8_t USBD_AUDIO_SOF(USBD_HandleTypeDef* pdev)
 {
   USBD_AUDIO_HandleTypeDef* haudio;
   haudio = (USBD_AUDIO_HandleTypeDef*)pdev->pClassData;
-  static volatile uint32_t sof_count = 0;
+  PROF_START(SOF);
+#ifdef USE_TELEMETRY
+  AUDIO_TelemRecordTypeDef telem = {0};
+#endif
+#ifdef DEBUG_FEEDBACK_ENDPOINT
+  uint32_t trace_writable_q8 = 0U;
+  uint32_t trace_record = 0U;
+#endif
+
+  // after a frequency switch the DMA starts once PLLI2S is locked
+  if (is_playing == 0U && all_ready == 1U) {
+    AUDIO_OUT_StartDMA(pdev);
+  }
 
   /* Do stuff only when playing */
   if (haudio->rd_enable == 1U && all_ready == 1U) {
+	// Update audio read pointer, in words. The DMA position is interpolated with the DWT cycle counter
+	// to a fraction of a word (Q8), so the fill level the feedback relies on is not quantised to the NDTR halfword.
+    uint32_t rd_q8 = BSP_AUDIO_OUT_GetPlayPosition();
+    uint32_t wr_q8 = (uint32_t)haudio->wr_ptr << 8;
+    uint32_t rd_prev = haudio->rd_ptr;
+    haudio->rd_ptr = (uint16_t)(rd_q8 >> 8);
+
+    // Calculate remaining writable buffer words (Q8) and samples (stereo frames, 2 words each)
+    uint32_t audio_buf_writable_q8 = rd_q8 < wr_q8 ?
+    		  rd_q8 + ((uint32_t)haudio->buf_size << 8) - wr_q8 : rd_q8 - wr_q8;
+    uint32_t audio_buf_writable_samples = audio_buf_writable_q8 >> 9;
+#ifdef USE_TELEMETRY
+    telem.flags = AUDIO_TELEM_FLAG_RD;
+    telem.writable_q8 = audio_buf_writable_q8;
+    telem.rd_q8 = rd_q8;
+#endif
 #ifdef DEBUG_FEEDBACK_ENDPOINT
-	DbgSofCounter++;
+    trace_writable_q8 = audio_buf_writable_q8;
 #endif
-	// Update audio read pointer
-    haudio->rd_ptr = AUDIO_TOTAL_BUF_SIZE - BSP_AUDIO_OUT_GetRemainingDataSize();
 
-    // Calculate remaining writable buffer samples
-    uint32_t audio_buf_writable_samples = haudio->rd_ptr < haudio->wr_ptr ?
-    		  (haudio->rd_ptr + AUDIO_TOTAL_BUF_SIZE - haudio->wr_ptr)/6 : (haudio->rd_ptr - haudio->wr_ptr)/6;
+    // Underrun : less than half a packet left to play, or the DMA already passed wr_ptr and plays old
+    // frames. The DMA advance since the last SOF is compared with the fill level from the read position
+    // of the last SOF, the DMA moves about a packet per SOF so the current fill level alone can miss it.
+    // USBD_AUDIO_ProcessPackets fades out, the next packet restarts the stream, see AUDIO_OUT_Recover.
+    uint32_t audio_buf_advance_words = AUDIO_OUT_Writable(haudio->rd_ptr, rd_prev, haudio->buf_size);
+    uint32_t audio_buf_fill_words = AUDIO_OUT_Writable(haudio->wr_ptr, rd_prev, haudio->buf_size);
+    if ((haudio->xrun == AUDIO_OUT_XRUN_NONE) &&
+        (audio_buf_advance_words + haudio->xrun_margin_words > audio_buf_fill_words)) {
+      haudio->xrun = AUDIO_OUT_XRUN_FADE;
+      USBD_AUDIO_Xrun.underruns++;
+      SCB->ICSR = SCB_ICSR_PENDSVSET_Msk;
+#ifdef DEBUG_FEEDBACK_ENDPOINT
+      AUDIO_Trace_Event(AUDIO_TRACE_EV_UNDERRUN);
+#endif
+    }
+#ifdef DEBUG_FEEDBACK_ENDPOINT
+    AUDIO_Trace_SafeZone(audio_buf_writable_samples < haudio->safezone);
+#endif
 
-    // Monitor remaining writable buffer samples with LED
-    if (audio_buf_writable_samples < AUDIO_BUF_SAFEZONE_SAMPLES) {
+    // Monitor remaining writable buffer samples with LED, on during an underrun
+    if ((audio_buf_writable_samples < haudio->safezone) || (haudio->xrun != AUDIO_OUT_XRUN_NONE)) {
     	BSP_OnboardLED_On();
     	}
     else {
     	BSP_OnboardLED_Off();
     	}
 
-    sof_count += 1;
-
-    if (sof_count == 1U) {
-		sof_count = 0;
-		// we start transmitting to I2S DAC when the audio buffer is half full, so the optimal
-		// remaining writable size is (AUDIO_TOTAL_BUF_SIZE/2)/6 samples
-		// Calculate feedback value based on the deviation from optimal
-		int32_t audio_buf_writable_dev_from_nom_samples = audio_buf_writable_samples - AUDIO_TOTAL_BUF_SIZE/(2*6);
-		 // The feedback is ideally the true Fs generated by the I2S PLL clock and dividers. Unfortunately we have no means
-		 // to measure it internally. So we can only start with a nominal value calculated by assuming the HSE clock crystal
-		 // has 0ppm accuracy, and calculate the Fs frequency generated by the PLLI2S N, R, I2SDIV and ODD register values.
-		 // We then modify this nominal feedback frequency by the deviation from the ideal write pointer position wrt the read
-		 // pointer over time.
-		 // Need to multiply by at least a "PID k factor" of (1<<22) + 256 for a deviation of 1 sample to produce a change in feedback
-		 // as the internal fb value = (10.14) shifted 8bits in uint32_t.
-		 // We also should use the minimum "PID k factor" that keeps the write-pointer to read-pointer distance out of the
-		 // danger zone. This is to minimize the distortion caused by changes in host sampling frequency Fs.
-		uint64_t tmp = (uint64_t)((int32_t)(1<<22) + (audio_buf_writable_dev_from_nom_samples * 256));
-		uint64_t pid_k = ((uint64_t)fb_nom) * tmp;
-		fb_value = (uint32_t)(pid_k >> 22);
-		// Clamp feedback value to nominal value +/- 1kHz
-		if (fb_value > fb_nom +  AUDIO_FB_DELTA_MAX) {
-			fb_value = fb_nom +  AUDIO_FB_DELTA_MAX;
-			}
-		else
-		if (fb_value < fb_nom -  AUDIO_FB_DELTA_MAX) {
-			fb_value = fb_nom -  AUDIO_FB_DELTA_MAX;
-			}
+    // The feedback is computed once per bRefresh period from the writable space accumulated every SOF,
+    // the fill level during an underrun is not used
+    if (haudio->xrun == AUDIO_OUT_XRUN_NONE) {
+      AUDIO_FB_Sample(&haudio->fb, audio_buf_writable_q8);
+    }
+
+    USB_OTG_GlobalTypeDef* USBx = USB_OTG_FS;
+    uint32_t USBx_BASE = (uint32_t)USBx;
+    /* Get FNSOF. Use volatile for fnsof_new since its address is mapped to a hardware register. */
+    uint32_t volatile fnsof_new = (USBx_DEVICE->DSTS & USB_OTG_DSTS_FNSOF) >> 8;
+
+    // The host polls the feedback endpoint once per refresh period. Once a feedback packet has been sent
+    // (USBD_AUDIO_DataIn) the poll frame is known, and the feedback is updated and armed in the SOF of the
+    // frame before it, so the host always reads a value computed from the latest period.
+    // Until then the feedback is updated on the period boundary and armed on alternate frames.
+    uint32_t fb_update;
+    if (fb_poll_valid) {
+      fb_update = (((fnsof_new + 1U - fb_poll_frame) & AUDIO_FB_PERIOD_MASK) == 0U);
+    }
+    else {
+      fb_update = ((fnsof_new & AUDIO_FB_PERIOD_MASK) == 0U);
+    }
+
+    if (fb_update) {
+		// The DMA starts on the silent ring buffer and the first packet is written AUDIO_OUT_StartWords
+		// ahead of it, usually less than the latency of the profile. The setpoint is half the buffer,
+		// buf_size/4 writable frames, the feedback asks the host for more until the fill level gets there.
+		// The feedback is ideally the true Fs generated by the I2S PLL clock and dividers. Without a timer we have no means
+		// to measure it internally. So we start with the nominal value calculated by assuming the HSE clock crystal
+		// has 0ppm accuracy, and let the PI controller in usbd_audio_fb.c correct it from the filtered deviation
+		// of the writable space from the optimal value. The integral term removes the steady fill error a
+		// proportional-only correction leaves behind for the PLL and crystal Fs error.
+#ifdef USE_FB_TIMER
+		// With USE_FB_TIMER the nominal value is measured : TIM2 captures its HSE derived clock on every SOF,
+		// which gives the crystal error against the host clock, and the fill level is only a slow trim.
+		AUDIO_FB_Measure(&haudio->fb, BSP_AUDIO_OUT_SofTimerCapture(), fnsof_new);
+#endif
+		fb_value = AUDIO_FB_Update(&haudio->fb);
+#ifdef USE_TELEMETRY
+		telem.flags |= AUDIO_TELEM_FLAG_FB;
+#endif
+#ifdef USE_ADAPTIVE_EP
+		// No feedback endpoint : fb_value is the I2S rate in frames per ms of the host clock, the host sends
+		// the nominal stream rate, so the resampler takes nominal / fb_value input frames per output frame
+		AUDIO_ASRC_SetStep(&haudio->asrc, ((((uint64_t)haudio->freq << 32) / 1000U) << 22) / fb_value);
+#endif
 
 		#ifdef DEBUG_FEEDBACK_ENDPOINT
-		if (audio_buf_writable_samples != audio_buf_writable_samples_last) {
-			if (audio_buf_writable_samples > DbgMaxWritableSamples) DbgMaxWritableSamples = audio_buf_writable_samples;
-			if (audio_buf_writable_samples < DbgMinWritableSamples) DbgMinWritableSamples = audio_buf_writable_samples;
-			DbgWritableSampleHistory[DbgIndex] = audio_buf_writable_samples;
-			DbgFeedbackHistory[DbgIndex] = (float)(fb_value >> 8)/(float)(1<<14);
-			DbgSofHistory[DbgIndex] = DbgSofCounter;
-			DbgIndex++; // uint8_t, so only record last 256 entries
-			}
+		if (audio_buf_writable_samples > DbgMaxWritableSamples) DbgMaxWritableSamples = audio_buf_writable_samples;
+		if (audio_buf_writable_samples < DbgMinWritableSamples) DbgMinWritableSamples = audio_buf_writable_samples;
+		// one trace entry per feedback update, see usbd_audio_trace.h
+		trace_record = 1U;
 		#endif
 
-		// Update last writable buffer size
-		audio_buf_writable_samples_last = audio_buf_writable_samples;
-		// Set 10.14 format feedback data
-		// Order of 3 bytes in feedback packet: { LO byte, MID byte, HI byte }
-		fb_data[0] = (uint8_t)((fb_value >> 8) & 0x000000FF);
-		fb_data[1] = (uint8_t)((fb_value >> 16) & 0x000000FF);
-		fb_data[2] = (uint8_t)((fb_value >> 24) & 0x000000FF);
+		AUDIO_OUT_SetFeedback(haudio, fb_value);
 		}
 
-
+#ifndef USE_ADAPTIVE_EP
     /* Transmit feedback only when the last one is transmitted */
     if (tx_flag == 0U) {
-      /* Get FNSOF. Use volatile for fnsof_new since its address is mapped to a hardware register. */
-      USB_OTG_GlobalTypeDef* USBx = USB_OTG_FS;
-      uint32_t USBx_BASE = (uint32_t)USBx;
-      uint32_t volatile fnsof_new = (USBx_DEVICE->DSTS & USB_OTG_DSTS_FNSOF) >> 8;
-
-      if ((fnsof & 0x1) == (fnsof_new & 0x1)) {
+      if (fb_poll_valid ? fb_update : ((fnsof & 0x1) == (fnsof_new & 0x1))) {
         USBD_LL_Transmit(pdev, AUDIO_IN_EP, (uint8_t*)fb_data, 3U);
         /* Block transmission until it's finished. */
         tx_flag = 1U;
       }
     }
+#endif
+  }
+
+#ifdef USE_TELEMETRY
+  // one record per frame, also while the stream is stopped
+  {
+    uint32_t USBx_BASE = (uint32_t)USB_OTG_FS;
+    telem.frame = (uint16_t)((USBx_DEVICE->DSTS & USB_OTG_DSTS_FNSOF) >> 8);
   }
+  if (is_playing) telem.flags |= AUDIO_TELEM_FLAG_PLAYING;
+  if (haudio->xrun != AUDIO_OUT_XRUN_NONE) telem.flags |= AUDIO_TELEM_FLAG_XRUN;
+  telem.alt = haudio->alt_setting;
+  telem.freq = haudio->freq;
+  telem.feedback = fb_value;
+  telem.xruns = (uint8_t)(USBD_AUDIO_Xrun.underruns + USBD_AUDIO_Xrun.overruns);
+  AUDIO_Telem_Put(pdev, &telem);
+#endif
+#ifdef DEBUG_FEEDBACK_ENDPOINT
+  // entries with events are also written while the stream is stopped
+  AUDIO_Trace_Sof(trace_writable_q8, fb_value, trace_record);
+#endif
 
+  PROF_STOP(SOF);
   return USBD_OK;
 }
 
@@ -682,10 +1329,14 @@ static uint8_t USBD_AUDIO_IsoINIncomplete(USBD_HandleTypeDef* pdev, uint8_t epnu
   uint32_t USBx_BASE = (uint32_t)USBx;
   fnsof = (USBx_DEVICE->DSTS & USB_OTG_DSTS_FNSOF) >> 8;
 
+#ifndef USE_ADAPTIVE_EP
   if (tx_flag == 1U) {
+    // the host did not poll in the expected frame, search for the poll frame again
+    fb_poll_valid = 0U;
     tx_flag = 0U;
     USBD_LL_FlushEP(pdev, AUDIO_IN_EP);
   }
+#endif
 
   return USBD_OK;
 }
@@ -703,40 +1354,21 @@ static uint8_t USBD_AUDIO_IsoOutIncomplete(USBD_HandleTypeDef* pdev, uint8_t epn
 	USBD_AUDIO_HandleTypeDef *haudio;
 	haudio = (USBD_AUDIO_HandleTypeDef*)pdev->pClassData;
 
+#ifdef USE_TELEMETRY
+	AUDIO_TelemIsoIncomplete++;
+#endif
+#ifdef DEBUG_FEEDBACK_ENDPOINT
+	AUDIO_Trace_Event(AUDIO_TRACE_EV_ISO_INCOMPLETE);
+#endif
 	USBD_LL_FlushEP(pdev, AUDIO_OUT_EP);
 
 	/* Prepare Out endpoint to receive next audio packet */
-	(void)USBD_LL_PrepareReceive(pdev, AUDIO_OUT_EP, (uint8_t *)&haudio->buffer[haudio->wr_ptr], AUDIO_OUT_PACKET_24B);
+	AUDIO_OUT_PrepareRx(pdev, haudio);
 
 	return (uint8_t)USBD_OK;
 	}
 
 
-typedef  union UN32_ {
-	uint8_t b[4];
-	int32_t s;
-} UN32;
-
-// ref : https://www.microchip.com/forums/m932509.aspx
-
-inline int32_t USBD_AUDIO_Volume_Ctrl(int32_t sample, int32_t shift_3dB){
-	int32_t sample_atten = sample;
-	int32_t shift_6dB = shift_3dB>>1;
-
-	if (shift_3dB & 1) {
-	    // shift_3dB is odd, implement 6dB shift and compensate
-	    shift_6dB++;
-        sample_atten >>= shift_6dB;
-        sample_atten += (sample_atten>>1);
-	    }
-	else{
-	    // shift_3dB is even, implement with 6dB shift
-	    sample_atten >>= shift_6dB;
-		}
-	return sample_atten;
-	}
-
-
 /**
   * @brief  USBD_AUDIO_DataOut
   *         handle data OUT Stage
@@ -747,81 +1379,238 @@ inline int32_t USBD_AUDIO_Volume_Ctrl(int32_t sample, int32_t shift_3dB){
 // incoming USB audio data buffer : uint8_t array
 // Each 24bit stereo sample is encoded as : L channel 3bytes + R channel 3bytes, LSbyte first
 // b0:lo_L, b1:mid_L, b2:hi_L, b3:lo_R, b4:mid_R, b5:hi_R
+// Each 16bit stereo sample (alternate setting 2) is encoded as : b0:lo_L, b1:hi_L, b2:lo_R, b3:hi_R
+// Each 24bit in 32bit stereo sample (alternate setting 3) is encoded as : b0:pad_L, b1:lo_L, b2:mid_L, b3:hi_L, b4:pad_R ...
 
-// volume control is implemented by scaling the data, attenuation resolution is 3dB.
-// 6dB is equivalent to a shift right by 1 bit.
+// volume control is implemented by scaling the data with a Q1.30 gain, resolution is 1/256dB.
+// Gain and mute changes are ramped over one packet to avoid zipper noise.
 
 // outgoing I2S Philips data format is : left-aligned 24bits in 32bit frame, MSbyte first
-// STM32 I2S peripheral uses a 16bit data register
-// => outgoing I2S transmit data buffer : uint16_t array
-// Each I2S stereo sample is encoded as {hi_L:mid_L}, {lo_L:0x00}, {hi_R:mid_R}, {lo_R:0x00}
+// STM32 I2S peripheral uses a 16bit data register, the DMA unpacks each 32bit buffer word into
+// 2 halfwords, low halfword first
+// => outgoing I2S transmit data buffer : uint32_t array, one word per channel
+// The packet is received directly into the I2S transmit buffer and converted in place, see AUDIO_OUT_RX_OFFSET
+// The ring buffer is the first buf_size words of the buffer, set by the latency profile
+// Each I2S stereo sample is transmitted as {hi_L:mid_L}, {lo_L:0x00}, {hi_R:mid_R}, {lo_R:0x00}
+// The conversion kernels are in usbd_audio_conv.c
+
+// The OTG ISR does not convert the packet. It reserves the packet space in the buffer, queues the packet
+// and pends PendSV, which runs USBD_AUDIO_ProcessPackets at the lowest priority. Packets are converted
+// in order, and packet N is always converted before its output area is needed by packet N+1, so the next
+// packet can be received ahead of wr_ptr while earlier packets are still waiting for conversion.
 
 static uint8_t USBD_AUDIO_DataOut(USBD_HandleTypeDef* pdev,  uint8_t epnum){
 	USBD_AUDIO_HandleTypeDef* haudio;
 	haudio = (USBD_AUDIO_HandleTypeDef*)pdev->pClassData;
 
-	static uint8_t tmpbuf[1024];
-
 	if (all_ready == 1U && epnum == AUDIO_OUT_EP) {
+		PROF_START(DATAOUT);
+#ifdef DEBUG_FEEDBACK_ENDPOINT
+		uint32_t dbg_cycles = DWT->CYCCNT;
+#endif
 		uint32_t curr_length = USBD_GetRxCount(pdev, epnum);
-		// Ignore strangely large packets
-		if (curr_length > AUDIO_OUT_PACKET_24B) {
-			curr_length = 0U;
+		uint32_t num_samples = curr_length / (haudio->bit_depth/4U); // 4, 3 or 2 bytes per channel sample
+
+		// Ignore strangely large packets, and packets received at a stale location
+		// because the write pointer was reset after the endpoint was armed. The stale location
+		// may be in the ring buffer the restart silenced, so is the packet.
+		if ((num_samples > AUDIO_OUT_PACKET_FRAMES_MAX) || (haudio->rx_buf != AUDIO_OUT_RxAddr(haudio))) {
+			USBD_memset(haudio->rx_buf, 0, curr_length);
+			num_samples = 0U;
 			}
 
-		uint32_t tmpbuf_ptr = 0U;
-		uint32_t num_samples = curr_length / 6; // 3bytes per sample
+		// After an underrun packets are dropped until the ring buffer is silent, the next one restarts the stream
+		if (num_samples && (haudio->xrun != AUDIO_OUT_XRUN_NONE)) {
+			if (haudio->xrun == AUDIO_OUT_XRUN_SILENT) {
+				AUDIO_OUT_Recover(haudio);
+				}
+			num_samples = 0U;
+			}
+
+		// The first packet of the stream sets the write position, it is dropped until the DMA runs
+		if (num_samples && (haudio->offset == AUDIO_OFFSET_UNKNOWN)) {
+			if (is_playing) {
+				AUDIO_OUT_FirstPacket(haudio, curr_length);
+				}
+			else {
+				num_samples = 0U;
+				}
+			}
 
-		for (int i = 0; i < num_samples; i++) {
-			UN32 sample;
-			sample.b[0] = tmpbuf[tmpbuf_ptr]; // lsb
-			sample.b[1] = tmpbuf[tmpbuf_ptr+1];
-			sample.b[2] = tmpbuf[tmpbuf_ptr+2]; // msb
-			sample.b[3] = sample.b[2] & 0x80 ? 0xFF : 0x00; // sign extend to 32bits
-			sample.s = USBD_AUDIO_Volume_Ctrl(sample.s,haudio->vol_3dB_shift);
+		// The packet is in the audio buffer ahead of wr_ptr (or in its slot when resampled), queue it for conversion
+		if (num_samples) {
+			AUDIO_OUT_QueueTypeDef* queue = &haudio->queue;
+			uint32_t head = queue->head;
+			uint32_t out_frames = num_samples;
+#ifdef AUDIO_OUT_RESAMPLE
+			// the entry slots hold the raw packets, keep the slot the next packet is received in free
+			if (head - queue->tail < AUDIO_OUT_QUEUE_SIZE - 1U) {
+#else
+			if (head - queue->tail < AUDIO_OUT_QUEUE_SIZE) {
+#endif
+				AUDIO_OUT_PacketTypeDef* pkt = &queue->pkt[head & (AUDIO_OUT_QUEUE_SIZE - 1U)];
+				pkt->pos = haudio->wr_ptr;
+				pkt->frames = (uint8_t)num_samples;
+				pkt->gen = queue->gen;
+#ifdef AUDIO_OUT_RESAMPLE
+				// reserve the resampled frames, the ratio is the one in use when the packet arrived
+				pkt->step = haudio->asrc.step;
+				out_frames = AUDIO_ASRC_Reserve(&haudio->asrc, num_samples, &pkt->t);
+				pkt->out_frames = (uint8_t)out_frames;
+#endif
+				// drop the packet on overrun, the host sends faster than the feedback asks for
+				if (AUDIO_OUT_Overrun(haudio, out_frames)) {
+#ifdef AUDIO_OUT_RESAMPLE
+					haudio->asrc.t = pkt->t;
+#endif
+					USBD_AUDIO_Xrun.overruns++;
+#ifdef DEBUG_FEEDBACK_ENDPOINT
+					AUDIO_Trace_Event(AUDIO_TRACE_EV_OVERRUN);
+#endif
+					}
+				else {
+					__DMB();
+					queue->head = head + 1U;
+					SCB->ICSR = SCB_ICSR_PENDSVSET_Msk;
+
+					// 2 words per frame. Rollover at end of buffer, the frames converted into the guard area
+					// are moved to the start by USBD_AUDIO_ProcessPackets
+					haudio->wr_ptr += out_frames*2;
+					if (haudio->wr_ptr >= haudio->buf_size) {
+						haudio->wr_ptr -= haudio->buf_size;
+						}
+					}
+				}
+#ifdef DEBUG_FEEDBACK_ENDPOINT
+			else {
+				DbgQueueOverflows++;
+				}
+#endif
+			}
 
-			haudio->buffer[haudio->wr_ptr++] = (((uint16_t)sample.b[2]) << 8) | (uint16_t)sample.b[1];
-			haudio->buffer[haudio->wr_ptr++] = ((uint16_t)sample.b[0]) << 8;
+		AUDIO_OUT_PrepareRx(pdev, haudio);
+#ifdef DEBUG_FEEDBACK_ENDPOINT
+		DbgDataOutCycles = DWT->CYCCNT - dbg_cycles;
+		if (DbgDataOutCycles > DbgDataOutCyclesMax) DbgDataOutCyclesMax = DbgDataOutCycles;
+#endif
+		PROF_STOP(DATAOUT);
+		}
 
-			sample.b[0] = tmpbuf[tmpbuf_ptr+3]; // lsb
-			sample.b[1] = tmpbuf[tmpbuf_ptr+4];
-			sample.b[2] = tmpbuf[tmpbuf_ptr+5]; // msb
-			sample.b[3] = sample.b[2] & 0x80 ? 0xFF : 0x00; // sign extend to 32bits
+	return USBD_OK;
+	}
 
-			sample.s = USBD_AUDIO_Volume_Ctrl(sample.s,haudio->vol_3dB_shift);
 
-			haudio->buffer[haudio->wr_ptr++] = (((uint16_t)sample.b[2]) << 8) | (uint16_t)sample.b[1];
-			haudio->buffer[haudio->wr_ptr++] = ((uint16_t)sample.b[0]) << 8;
+/**
+  * @brief  USBD_AUDIO_ProcessPackets
+  *         Convert the packets queued by USBD_AUDIO_DataOut, called from PendSV_Handler
+  * @param  pdev: device instance
+  */
+void USBD_AUDIO_ProcessPackets(USBD_HandleTypeDef* pdev){
+	// the OTG ISR preempts PendSV : USBD_AUDIO_DeInit leaves the class data to free to the end of the conversion
+	__disable_irq();
+	USBD_AUDIO_HandleTypeDef* haudio = (USBD_AUDIO_HandleTypeDef*)pdev->pClassData;
+	audio_conv_data = haudio;
+	__enable_irq();
+
+	if (haudio != NULL) {
+		AUDIO_OUT_ProcessQueue(haudio);
+		}
 
-			tmpbuf_ptr += 6;
+	__disable_irq();
+	audio_conv_data = NULL;
+	if (audio_free_data != NULL) {
+		USBD_free(audio_free_data);
+		audio_free_data = NULL;
+		}
+	__enable_irq();
+	}
 
-			// Rollover at end of buffer
-			if (haudio->wr_ptr >= AUDIO_TOTAL_BUF_SIZE) {
-				haudio->wr_ptr = 0U;
+// The OTG ISR may restart the stream (AUDIO_OUT_Reset, new generation) in the middle of a packet :
+// the restart silences the ring buffer and the DMA plays it right away, so the frames of the old
+// stream written after it are silenced again. The ring buffer size is the one the packet was
+// reserved with.
+static void AUDIO_OUT_ProcessQueue(USBD_AUDIO_HandleTypeDef* haudio){
+	AUDIO_OUT_QueueTypeDef* queue = &haudio->queue;
+	uint32_t tail = queue->tail;
+
+	while (tail != queue->head) {
+		__DMB();
+		AUDIO_OUT_PacketTypeDef pkt = queue->pkt[tail & (AUDIO_OUT_QUEUE_SIZE - 1U)];
+
+		if (pkt.gen == queue->gen) {
+			PROF_START(CONV);
+#if defined(DEBUG_FEEDBACK_ENDPOINT) || defined(USE_TELEMETRY)
+			uint32_t dbg_cycles = DWT->CYCCNT;
+#endif
+			uint32_t buf_size = haudio->buf_size;
+			// volume or mute changed since the last packet, ramp to the new gain over this packet
+			if (haudio->conv_update) {
+				haudio->conv_update = 0U;
+				AUDIO_OUT_SelectConverter(haudio, 1U);
 				}
-			}
-
-		// Start playing when half of the audio buffer is filled
-		// so if you increase the buffer length too much, the audio latency will be obvious when watching video+audio
-		if (haudio->offset == AUDIO_OFFSET_UNKNOWN && is_playing == 0U) {
-			if (haudio->wr_ptr >= AUDIO_TOTAL_BUF_SIZE / 2U) {
-				haudio->offset = AUDIO_OFFSET_NONE;
-				is_playing = 1U;
-
-				if (haudio->rd_enable == 0U) {
-					haudio->rd_enable = 1U;
-					// Set last writable buffer size to actual value. Note that rd_ptr is 0 now.
-					audio_buf_writable_samples_last = (AUDIO_TOTAL_BUF_SIZE - haudio->wr_ptr)/6;
-					}
 
-				((USBD_AUDIO_ItfTypeDef*)pdev->pUserData)->AudioCmd(&haudio->buffer[0], AUDIO_TOTAL_BUF_SIZE * 2, AUDIO_CMD_START);
+#ifdef AUDIO_OUT_RESAMPLE
+			// first packet of a new stream, AUDIO_OUT_Reset leaves the history to PendSV
+			if (pkt.gen != haudio->asrc_gen) {
+				haudio->asrc_gen = pkt.gen;
+				AUDIO_ASRC_ClearHistory(&haudio->asrc);
+				}
+			// convert the raw packet to the resampler input, resample into the reserved frames
+			AUDIO_Conv_Packet(&haudio->conv, AUDIO_ASRC_Input(&haudio->asrc),
+					(uint8_t*)haudio->rx_slot[tail & (AUDIO_OUT_QUEUE_SIZE - 1U)], pkt.frames);
+			AUDIO_ASRC_Process(&haudio->asrc, haudio->buffer, pkt.pos, buf_size,
+					pkt.frames, pkt.out_frames, pkt.t, pkt.step);
+			uint32_t words = pkt.out_frames*2U;
+#ifdef DEBUG_FEEDBACK_ENDPOINT
+			if (dbg_start_run) {
+				AUDIO_OUT_DbgStartLatency(haudio, pkt.pos, pkt.out_frames);
+				}
+#endif
+#else
+			AUDIO_Conv_Packet(&haudio->conv, &haudio->buffer[pkt.pos], (uint8_t*)&haudio->buffer[pkt.pos] + haudio->rx_offset, pkt.frames);
+
+			// The buffer has a guard area after the ring so the packet is always contiguous,
+			// move the frames written past the end of the ring to the start
+			uint32_t words = pkt.frames*2U;
+			uint32_t end = pkt.pos + words;
+			if (end > buf_size) {
+				USBD_memcpy(&haudio->buffer[0], &haudio->buffer[buf_size], (end - buf_size)*4);
+				}
+#ifdef DEBUG_FEEDBACK_ENDPOINT
+			if (dbg_start_run) {
+				AUDIO_OUT_DbgStartLatency(haudio, pkt.pos, pkt.frames);
 				}
+#endif
+#endif
+			if (pkt.gen != queue->gen) {
+				AUDIO_OUT_Silence(haudio->buffer, pkt.pos, words, buf_size);
+				}
+#if defined(DEBUG_FEEDBACK_ENDPOINT) || defined(USE_TELEMETRY)
+			dbg_cycles = DWT->CYCCNT - dbg_cycles;
+#endif
+#ifdef DEBUG_FEEDBACK_ENDPOINT
+			DbgConvCycles = dbg_cycles;
+			if (DbgConvCycles > DbgConvCyclesMax) DbgConvCyclesMax = DbgConvCycles;
+#endif
+#ifdef USE_TELEMETRY
+			AUDIO_Telem_ConvCycles(dbg_cycles);
+#endif
+			PROF_STOP(CONV);
 			}
 
-		USBD_LL_PrepareReceive(pdev, AUDIO_OUT_EP, tmpbuf, AUDIO_OUT_PACKET_24B);
+		tail++;
+		queue->tail = tail;
 		}
 
-	return USBD_OK;
+	// underrun detected by USBD_AUDIO_SOF, concealed after the packets queued before it.
+	// A restart meanwhile (new generation) resets the state, the silence is harmless.
+	if (haudio->xrun == AUDIO_OUT_XRUN_FADE) {
+		uint8_t gen = queue->gen;
+		AUDIO_OUT_Conceal(haudio);
+		if (gen == queue->gen) {
+			haudio->xrun = AUDIO_OUT_XRUN_SILENT;
+			}
+		}
 	}
 
 
@@ -961,6 +1750,7 @@ static uint8_t USBD_AUDIO_EP0_RxReady(USBD_HandleTypeDef* pdev)
 {
   USBD_AUDIO_HandleTypeDef* haudio;
   haudio = (USBD_AUDIO_HandleTypeDef*)pdev->pClassData;
+  PROF_START(EP0_RX);
 
   if (haudio->control.cmd == AUDIO_REQ_SET_CUR) { /* In this driver, to simplify code, only SET_CUR request is managed */
 
@@ -969,6 +1759,7 @@ static uint8_t USBD_AUDIO_EP0_RxReady(USBD_HandleTypeDef* pdev)
         // Mute Control
         case AUDIO_CONTROL_REQ_FU_MUTE: {
         	haudio->mute = haudio->control.data[0];
+        	haudio->conv_update = 1U;
           ((USBD_AUDIO_ItfTypeDef*)pdev->pUserData)->MuteCtl(haudio->control.data[0]);
         };
             break;
@@ -976,7 +1767,8 @@ static uint8_t USBD_AUDIO_EP0_RxReady(USBD_HandleTypeDef* pdev)
         case AUDIO_CONTROL_REQ_FU_VOL: {
           int16_t volume = *(int16_t*)&haudio->control.data[0];
           haudio->volume = volume;
-          haudio->vol_3dB_shift = USBD_AUDIO_Get_Vol3dB_Shift(volume);
+          haudio->gain = USBD_AUDIO_Get_Gain(volume);
+          haudio->conv_update = 1U;
           ((USBD_AUDIO_ItfTypeDef*)pdev->pUserData)->VolumeCtl(volume);
         };
             break;
@@ -987,9 +1779,21 @@ static uint8_t USBD_AUDIO_EP0_RxReady(USBD_HandleTypeDef* pdev)
       if (haudio->control.cs == AUDIO_STREAMING_REQ_FREQ_CTRL) {
         uint32_t new_freq = *(uint32_t*)&haudio->control.data & 0x00ffffff;
 
-        if (haudio->freq != new_freq) {
+        // ignore frequencies not listed for the current alternate setting
+        if ((haudio->freq != new_freq) && AUDIO_OUT_FreqSupported(haudio->alt_setting, new_freq)) {
           haudio->freq = new_freq;
-          AUDIO_OUT_Restart(pdev);
+#ifdef DEBUG_FEEDBACK_ENDPOINT
+          dbg_switch_start = DWT->CYCCNT;
+          dbg_switch_run = 1U;
+          DbgSwitchFast = (uint8_t)is_playing;
+          AUDIO_Trace_Event(AUDIO_TRACE_EV_RATE);
+#endif
+          // a playing stream keeps the I2S and DMA set up, only the clock and the buffer change
+          if (is_playing) {
+            AUDIO_OUT_Switch(pdev);
+          } else {
+            AUDIO_OUT_Restart(pdev);
+          }
         }
       }
     }
@@ -1001,6 +1805,7 @@ static uint8_t USBD_AUDIO_EP0_RxReady(USBD_HandleTypeDef* pdev)
     haudio->control.len = 0U;
   }
 
+  PROF_STOP(EP0_RX);
   return USBD_OK;
 }
 
@@ -1019,36 +1824,88 @@ static uint8_t USBD_AUDIO_EP0_TxReady(USBD_HandleTypeDef* pdev)
 
 
 /**
- * @brief  Stop playing and reset buffer pointers
+ * @brief  Reset the stream state and buffer pointers, the I2S is not stopped
  * @param  pdev: instance
  */
-static void AUDIO_OUT_StopAndReset(USBD_HandleTypeDef* pdev)
+static void AUDIO_OUT_Reset(USBD_HandleTypeDef* pdev)
 {
   USBD_AUDIO_HandleTypeDef* haudio;
   haudio = (USBD_AUDIO_HandleTypeDef*)pdev->pClassData;
 
   all_ready = 0U;
+#ifndef USE_ADAPTIVE_EP
   tx_flag = 1U;
+#endif
   is_playing = 0U;
-  audio_buf_writable_samples_last = AUDIO_TOTAL_BUF_SIZE /(2*6);
 #ifdef DEBUG_FEEDBACK_ENDPOINT
   DbgMinWritableSamples = 99999;
   DbgMaxWritableSamples = 0;
-  DbgIndex = 0;
-  DbgSofCounter = 0;
+  DbgDataOutCyclesMax = 0;
+  DbgConvCyclesMax = 0;
+  DbgOtgIsrCyclesMax = 0;
+  DbgQueueOverflows = 0;
+#endif
+  // discard the packets still waiting for conversion
+  haudio->queue.gen++;
+#ifdef AUDIO_OUT_RESAMPLE
+  // the history is cleared by PendSV with the first packet of the new stream, it may be resampling now
+  AUDIO_ASRC_Reset(&haudio->asrc);
 #endif
   haudio->offset = AUDIO_OFFSET_UNKNOWN;
   haudio->rd_enable = 0U;
   haudio->rd_ptr = 0U;
   haudio->wr_ptr = 0U;
+  haudio->xrun = AUDIO_OUT_XRUN_NONE;
 
+#ifndef USE_ADAPTIVE_EP
   USBD_LL_FlushEP(pdev, AUDIO_IN_EP);
+#endif
   USBD_LL_FlushEP(pdev, AUDIO_OUT_EP);
+}
+
 
+/**
+ * @brief  Stop playing and reset buffer pointers
+ * @param  pdev: instance
+ */
+static void AUDIO_OUT_StopAndReset(USBD_HandleTypeDef* pdev)
+{
+  AUDIO_OUT_Reset(pdev);
   ((USBD_AUDIO_ItfTypeDef*)pdev->pUserData)->DeInit(0);
 }
 
 
+/**
+ * @brief  Stream parameters for the alternate setting, frequency and latency profile
+ * @param  haudio: class data
+ */
+static void AUDIO_OUT_Configure(USBD_AUDIO_HandleTypeDef* haudio)
+{
+  AUDIO_OUT_SelectConverter(haudio, 0U);
+
+  // the alternate setting may have changed to one that does not support the current frequency
+  if (!AUDIO_OUT_FreqSupported(haudio->alt_setting, haudio->freq)) {
+    haudio->freq = USBD_AUDIO_FREQ_DEFAULT;
+  }
+  // ring buffer for the latency profile, frequency and format
+  AUDIO_OUT_SetBuffer(haudio);
+  fb_poll_valid = 0U;
+  fb_nom = fb_value = I2S_Clk_Config24[BSP_AUDIO_OUT_GetFreqIndex(AUDIO_OUT_I2SFreq(haudio))].nominal_fdbk;
+  // until the first update the feedback packets are sent with the nominal value, not the one of the last stream
+  AUDIO_OUT_SetFeedback(haudio, fb_value);
+#ifdef USE_FB_TIMER
+  AUDIO_FB_Init(&haudio->fb, fb_nom, haudio->buf_size/4U, BSP_AUDIO_OUT_SofTimerInit());
+#else
+  AUDIO_FB_Init(&haudio->fb, fb_nom, haudio->buf_size/4U, 0U);
+#endif
+
+#ifdef AUDIO_OUT_RESAMPLE
+  // with USE_FIXED_CLOCK a frequency change only changes the resampling ratio
+  AUDIO_ASRC_SetRatio(&haudio->asrc, haudio->freq, AUDIO_OUT_I2SFreq(haudio));
+#endif
+}
+
+
 /**
  * @brief  Restart playing with new parameters
  * @param  pdev: instance
@@ -1057,26 +1914,61 @@ static void AUDIO_OUT_Restart(USBD_HandleTypeDef* pdev)
 {
   USBD_AUDIO_HandleTypeDef* haudio;
   haudio = (USBD_AUDIO_HandleTypeDef*)pdev->pClassData;
+#ifdef DEBUG_FEEDBACK_ENDPOINT
+  uint32_t dbg_cycles = DWT->CYCCNT;
+#endif
 
   AUDIO_OUT_StopAndReset(pdev);
+  AUDIO_OUT_Configure(haudio);
 
-  switch (haudio->freq) {
-    case 44100:
-      fb_nom = fb_value = I2S_Clk_Config24[0].nominal_fdbk;
-      break;
-    case 48000:
-      fb_nom = fb_value = I2S_Clk_Config24[1].nominal_fdbk;
-      break;
-    case 96000:
-    default :
-      fb_nom = fb_value = I2S_Clk_Config24[2].nominal_fdbk;
-      break;
-  }
+  // PLLI2S is only reconfigured when the I2S frequency changes, see BSP_AUDIO_OUT_Init
+  ((USBD_AUDIO_ItfTypeDef*)pdev->pUserData)->Init(AUDIO_OUT_I2SFreq(haudio), haudio->volume, haudio->mute);
+
+  // the DMA plays silence until the first packet, see AUDIO_OUT_FirstPacket
+  USBD_memset(haudio->buffer, 0, haudio->buf_size * 4U);
+  AUDIO_OUT_StartDMA(pdev);
+
+#ifndef USE_ADAPTIVE_EP
+  tx_flag = 0U;
+#endif
+  all_ready = 1U;
+#ifdef DEBUG_FEEDBACK_ENDPOINT
+  DbgRestartCycles = DWT->CYCCNT - dbg_cycles;
+#endif
+}
+
+
+/**
+ * @brief  Change the frequency of a playing stream. The I2S and DMA are not re-initialised :
+ *         BSP_AUDIO_OUT_Switch loads precomputed register images and re-arms the DMA ring on the
+ *         silent buffer while PLLI2S locks, the PLL lock is polled in USBD_AUDIO_SOF by AUDIO_OUT_StartDMA.
+ * @param  pdev: instance
+ */
+static void AUDIO_OUT_Switch(USBD_HandleTypeDef* pdev)
+{
+  USBD_AUDIO_HandleTypeDef* haudio;
+  haudio = (USBD_AUDIO_HandleTypeDef*)pdev->pClassData;
+#ifdef DEBUG_FEEDBACK_ENDPOINT
+  uint32_t dbg_cycles = DWT->CYCCNT;
+#endif
 
-  ((USBD_AUDIO_ItfTypeDef*)pdev->pUserData)->Init(haudio->freq, haudio->volume, haudio->mute);
+  AUDIO_OUT_Reset(pdev);
+  AUDIO_OUT_Configure(haudio);
+  USBD_memset(haudio->buffer, 0, haudio->buf_size * 4U);
 
+  if (((USBD_AUDIO_ItfTypeDef*)pdev->pUserData)->SwitchFreq(AUDIO_OUT_I2SFreq(haudio), haudio->buffer, haudio->buf_size * 4U) != USBD_OK) {
+    ((USBD_AUDIO_ItfTypeDef*)pdev->pUserData)->DeInit(0);
+    ((USBD_AUDIO_ItfTypeDef*)pdev->pUserData)->Init(AUDIO_OUT_I2SFreq(haudio), haudio->volume, haudio->mute);
+  }
+  AUDIO_OUT_StartDMA(pdev);
+
+#ifndef USE_ADAPTIVE_EP
   tx_flag = 0U;
+#endif
   all_ready = 1U;
+#ifdef DEBUG_FEEDBACK_ENDPOINT
+  DbgRestartCycles = DWT->CYCCNT - dbg_cycles;
+#endif
 }
 
 
@@ -1108,6 +2000,20 @@ uint8_t USBD_AUDIO_RegisterInterface(USBD_HandleTypeDef* pdev,
 }
 
 
+/**
+* @brief  USBD_AUDIO_SetLatencyProfile
+*         Select the latency profile before the device is started,
+*         the host can change it with AUDIO_VENDOR_REQ_SET_LATENCY
+* @param  profile: index in AUDIO_LATENCY_PACKETS
+*/
+void USBD_AUDIO_SetLatencyProfile(uint8_t profile)
+{
+  if (profile < AUDIO_LATENCY_PROFILE_NUM) {
+    latency_profile = profile;
+  }
+}
+
+
 
 
 
@@ -0,0 +1,117 @@
+/**
+  ******************************************************************************
+  * @file    usbd_audio_asrc.c
+  * @brief   Asynchronous sample rate converter, see usbd_audio_asrc.h
+  *
+  *          The inner loop is one coefficient interpolation (SMULL) and two
+  *          32x32 multiply-accumulates (SMLAL) per tap, about 9 cycles per tap
+  *          or 300 cycles per stereo output frame with 32 taps, i.e. ~30% of the
+  *          F411 at 96kHz. The DEBUG_AUDIO_CONV_BENCHMARK build prints the cycle
+  *          count for one 96kHz packet.
+  ******************************************************************************
+  */
+
+#include <string.h>
+#include "usbd_audio_asrc.h"
+#include "usbd_audio_asrc_coef.h"
+
+// 24bit sample left-aligned in 32bit word, low byte must stay zero
+#define ASRC_MASK24   0xFFFFFF00U
+
+static inline uint32_t ASRC_Swap16(uint32_t x) {
+	return (x >> 16) | (x << 16);
+	}
+
+static inline int32_t ASRC_Sat(int64_t acc) {
+	if (acc > INT32_MAX) return INT32_MAX;
+	if (acc < INT32_MIN) return INT32_MIN;
+	return (int32_t)acc;
+	}
+
+void AUDIO_ASRC_Init(AUDIO_ASRC_TypeDef* pAsrc) {
+	AUDIO_ASRC_ClearHistory(pAsrc);
+	AUDIO_ASRC_Reset(pAsrc);
+	}
+
+// Output position and step for a new stream, the history is left to AUDIO_ASRC_ClearHistory
+void AUDIO_ASRC_Reset(AUDIO_ASRC_TypeDef* pAsrc) {
+	pAsrc->t = (uint64_t)(AUDIO_ASRC_TAPS / 2U) << 32;
+	pAsrc->step = AUDIO_ASRC_STEP_ONE;
+	pAsrc->step_nom = AUDIO_ASRC_STEP_ONE;
+	}
+
+void AUDIO_ASRC_ClearHistory(AUDIO_ASRC_TypeDef* pAsrc) {
+	memset(pAsrc->x, 0, sizeof(pAsrc->x));
+	}
+
+// Nominal ratio, set before the stream starts. A change of the stream rate only changes the step,
+// the coefficient table covers any output position.
+void AUDIO_ASRC_SetRatio(AUDIO_ASRC_TypeDef* pAsrc, uint32_t in_freq, uint32_t out_freq) {
+	pAsrc->step_nom = ((uint64_t)in_freq << 32) / out_freq;
+	pAsrc->step = pAsrc->step_nom;
+	}
+
+void AUDIO_ASRC_SetStep(AUDIO_ASRC_TypeDef* pAsrc, uint64_t step) {
+	uint64_t step_min = pAsrc->step_nom - (pAsrc->step_nom >> AUDIO_ASRC_STEP_SHIFT);
+	uint64_t step_max = pAsrc->step_nom + (pAsrc->step_nom >> AUDIO_ASRC_STEP_SHIFT);
+	if (step < step_min) step = step_min;
+	if (step > step_max) step = step_max;
+	pAsrc->step = step;
+	}
+
+// Number of output frames for a packet of in_frames, *pT is the start position for AUDIO_ASRC_Process.
+// Outputs are produced while the filter has all its taps, t < in_frames + AUDIO_ASRC_TAPS/2,
+// so t stays in [AUDIO_ASRC_TAPS/2, AUDIO_ASRC_TAPS/2 + step) between packets.
+uint32_t AUDIO_ASRC_Reserve(AUDIO_ASRC_TypeDef* pAsrc, uint32_t in_frames, uint64_t* pT) {
+	uint64_t t = pAsrc->t;
+	uint64_t end = (uint64_t)(in_frames + AUDIO_ASRC_TAPS / 2U) << 32;
+	uint32_t out_frames = 0U;
+	*pT = t;
+	if (t < end) {
+		out_frames = (uint32_t)((end - t + pAsrc->step - 1U) / pAsrc->step);
+		}
+	pAsrc->t = t + out_frames * pAsrc->step - ((uint64_t)in_frames << 32);
+	return out_frames;
+	}
+
+// The packet is at AUDIO_ASRC_Input as I2S words. Writes out_frames frames to the ring buffer
+// of size words from word pos, wrapping at the end.
+void AUDIO_ASRC_Process(AUDIO_ASRC_TypeDef* pAsrc, uint32_t* pRing, uint32_t pos, uint32_t size,
+                        uint32_t in_frames, uint32_t out_frames, uint64_t t, uint64_t step) {
+	int32_t* x = pAsrc->x;
+
+	// I2S words to left-aligned samples
+	uint32_t* in = AUDIO_ASRC_Input(pAsrc);
+	for (uint32_t n = 0; n < in_frames * 2U; n++) {
+		in[n] = ASRC_Swap16(in[n]);
+		}
+
+	for (uint32_t j = 0; j < out_frames; j++) {
+		uint32_t i = (uint32_t)(t >> 32);
+		uint32_t frac = (uint32_t)t;
+		const int32_t* c0 = AUDIO_ASRC_Coef[frac >> (32U - AUDIO_ASRC_PHASE_BITS)];
+		const int32_t* c1 = c0 + AUDIO_ASRC_TAPS;
+		int32_t f = (int32_t)((frac << AUDIO_ASRC_PHASE_BITS) >> 1); // Q31 between the two phases
+		const int32_t* xs = &x[(i - (AUDIO_ASRC_TAPS / 2U - 1U)) * 2U];
+
+		int64_t acc_l = 0;
+		int64_t acc_r = 0;
+		for (uint32_t k = 0; k < AUDIO_ASRC_TAPS; k++) {
+			int32_t c = c0[k] + (int32_t)(((int64_t)(c1[k] - c0[k]) * f) >> 31);
+			acc_l += (int64_t)c * xs[2U*k];
+			acc_r += (int64_t)c * xs[2U*k + 1U];
+			}
+
+		// Q30 coefficients, rounded
+		pRing[pos] = ASRC_Swap16((uint32_t)ASRC_Sat((acc_l + (1 << 29)) >> 30) & ASRC_MASK24);
+		pRing[pos + 1U] = ASRC_Swap16((uint32_t)ASRC_Sat((acc_r + (1 << 29)) >> 30) & ASRC_MASK24);
+		pos += 2U;
+		if (pos >= size) {
+			pos = 0U;
+			}
+		t += step;
+		}
+
+	// the last AUDIO_ASRC_TAPS input frames are the history of the next packet
+	memmove(x, &x[in_frames * 2U], AUDIO_ASRC_TAPS * 2U * sizeof(int32_t));
+	}
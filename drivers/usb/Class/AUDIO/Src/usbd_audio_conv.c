@@ -0,0 +1,505 @@
+/**
+  ******************************************************************************
+  * @file    usbd_audio_conv.c
+  * @brief   USB audio packet to I2S buffer sample conversion kernels
+  *
+  *          AUDIO_Conv24_Ref is the byte-at-a-time conversion and is kept as the
+  *          bit-exact reference. The specialised kernels load 3 words (12 bytes =
+  *          4 samples) at a time and build the left-aligned samples with shifts and
+  *          halfword packs, so the gain and the I2S halfword swap are done on full
+  *          32bit words. The 16bit kernels load 1 word (2 samples) at a time,
+  *          the 32bit kernels only mask the pad byte and swap the halfwords.
+  *
+  *          One kernel is generated per gain mode from AUDIO_CONV_VOL_MODES.
+  *          AUDIO_Conv_Select picks the kernel when the stream format, volume or
+  *          mute setting changes, so there is no per-sample gain mode test.
+  *          AUDIO_Conv_Packet runs the ramp kernel for one packet after a gain
+  *          change and then switches to the constant gain kernel.
+  ******************************************************************************
+  */
+
+#include "usbd_audio_conv.h"
+#include "stm32f4xx.h"
+#ifdef DEBUG_AUDIO_CONV_BENCHMARK
+#include <string.h>
+#include "usbd_audio_asrc.h"
+#endif
+
+#if defined(__ARM_FEATURE_DSP) && (__ARM_FEATURE_DSP == 1)
+// { hi halfword of b : lo halfword of a }
+#define CONV_PKHBT(a, b, sh)    __PKHBT((a), (b), (sh))
+#define CONV_SWAP16(x)          __ROR((x), 16U)
+#define CONV_ROR14(x)           __ROR((x), 14U)
+#else
+#define CONV_PKHBT(a, b, sh)    (((uint32_t)(a) & 0x0000FFFFU) | (((uint32_t)(b) << (sh)) & 0xFFFF0000U))
+#define CONV_SWAP16(x)          (((uint32_t)(x) >> 16) | ((uint32_t)(x) << 16))
+#define CONV_ROR14(x)           (((uint32_t)(x) >> 14) | ((uint32_t)(x) << 18))
+#endif
+
+// 24bit sample left-aligned in 32bit word, low byte must stay zero
+#define CONV_MASK24             0xFFFFFF00U
+// same mask after the I2S halfword swap
+#define CONV_MASK24_SWAP16      0xFF00FFFFU
+
+
+typedef  union UN32_ {
+	uint8_t b[4];
+	int32_t s;
+} UN32;
+
+// high word of the 64bit product, a single SMMUL
+__STATIC_FORCEINLINE int32_t Conv_Smmul(int32_t a, int32_t b){
+#if defined(__ARM_FEATURE_DSP) && (__ARM_FEATURE_DSP == 1)
+	int32_t result;
+	__ASM ("smmul %0, %1, %2" : "=r" (result) : "r" (a), "r" (b) );
+	return result;
+#else
+	return (int32_t)(((int64_t)a * b) >> 32);
+#endif
+	}
+
+// Q1.30 multiply, rounded
+static int32_t Conv_Mul30(int32_t a, int32_t b){
+	return (int32_t)(((int64_t)a * b + (1 << 29)) >> 30);
+	}
+
+
+// Volume to gain tables, Q1.30. The attenuation in 1/256dB units is split into
+// tens of dB, whole dB and 1/16dB steps, with linear interpolation between the
+// 1/16dB steps. The gain error is below 0.001dB down to -96dB.
+
+// 10^(-q), q = 0..6, -20dB steps
+static const int32_t VolDecade[7] = {
+	0x40000000, 0x06666666, 0x00A3D70A, 0x0010624E, 0x0001A36E, 0x000029F1, 0x00000432
+	};
+
+// 10^(-r/20), r = 0..19, -1dB steps
+static const int32_t VolDb[20] = {
+	0x40000000, 0x390A4160, 0x32D64618, 0x2D4EFBD6, 0x28619AEA, 0x23FD6678, 0x2013739E, 0x1C9676C7,
+	0x197A967F, 0x16B54338, 0x143D1362, 0x1209A37B, 0x10137988, 0x0E53EBB4, 0x0CC509AC, 0x0B618872,
+	0x0A24B063, 0x090A4D30, 0x080E9F97, 0x072E50A6
+	};
+
+// 10^(-k/320), k = 0..16, -1/16dB steps
+static const int32_t VolFrac[17] = {
+	0x40000000, 0x3F8A87E1, 0x3F15E75E, 0x3EA21CEC, 0x3E2F2701, 0x3DBD0417, 0x3D4BB2AC, 0x3CDB313E,
+	0x3C6B7E4F, 0x3BFC9866, 0x3B8E7E09, 0x3B212DC2, 0x3AB4A620, 0x3A48E5B1, 0x39DDEB09, 0x3973B4BB,
+	0x390A4160
+	};
+
+/**
+  * @brief  Convert a UAC volume setting to a linear gain
+  * @param  volume: 1/256dB units, 0x0000 = 0dB, 0x8000 = -128dB
+  * @retval gain, Q1.30
+  */
+int32_t AUDIO_Conv_VolumeToGain(int16_t volume){
+	if (volume > 0) volume = 0;
+	uint32_t atten = (uint32_t)(-(int32_t)volume);
+	uint32_t db = atten >> 8;
+	uint32_t k = (atten >> 4) & 0xFU;
+	uint32_t frac = atten & 0xFU;
+
+	int32_t gain = Conv_Mul30(VolDb[db % 20U], VolDecade[db / 20U]);
+	int32_t fine = VolFrac[k] - (((VolFrac[k] - VolFrac[k + 1U]) * (int32_t)frac) >> 4);
+	return Conv_Mul30(gain, fine);
+	}
+
+
+/**
+  * @brief  Reference 24bit conversion, one byte at a time
+  * @param  pDst: I2S buffer, 1 word per sample
+  * @param  pSrc: USB packet data
+  * @param  samples: number of samples (frames * channels)
+  * @param  gain: Q1.30 gain
+  * @param  gain_step: added to the gain before each stereo frame
+  */
+void AUDIO_Conv24_Ref(uint32_t* pDst, const uint8_t* pSrc, uint32_t samples, int32_t gain, int32_t gain_step){
+	for (uint32_t i = 0; i < samples; i++) {
+		UN32 sample;
+		sample.b[0] = 0x00;
+		sample.b[1] = pSrc[0]; // lsb
+		sample.b[2] = pSrc[1];
+		sample.b[3] = pSrc[2]; // msb, left-aligned
+		if ((i & 1U) == 0U) gain += gain_step;
+
+		uint32_t x = ((uint32_t)(int32_t)(((int64_t)sample.s * gain) >> 30)) & CONV_MASK24;
+		// {hi:mid} in the low halfword, {lo:0x00} in the high halfword
+		*pDst++ = (x >> 16) | (x << 16);
+		pSrc += 3;
+		}
+	}
+
+
+/**
+  * @brief  Reference 16bit conversion, one byte at a time
+  * @param  pDst: I2S buffer, 1 word per sample
+  * @param  pSrc: USB packet data
+  * @param  samples: number of samples (frames * channels)
+  * @param  gain: Q1.30 gain
+  * @param  gain_step: added to the gain before each stereo frame
+  */
+void AUDIO_Conv16_Ref(uint32_t* pDst, const uint8_t* pSrc, uint32_t samples, int32_t gain, int32_t gain_step){
+	for (uint32_t i = 0; i < samples; i++) {
+		UN32 sample;
+		sample.b[0] = 0x00;
+		sample.b[1] = 0x00;
+		sample.b[2] = pSrc[0]; // lsb
+		sample.b[3] = pSrc[1]; // msb, left-aligned
+		if ((i & 1U) == 0U) gain += gain_step;
+
+		uint32_t x = ((uint32_t)(int32_t)(((int64_t)sample.s * gain) >> 30)) & CONV_MASK24;
+		*pDst++ = (x >> 16) | (x << 16);
+		pSrc += 2;
+		}
+	}
+
+
+/**
+  * @brief  Reference 24bit in 32bit conversion, one byte at a time
+  * @param  pDst: I2S buffer, 1 word per sample
+  * @param  pSrc: USB packet data
+  * @param  samples: number of samples (frames * channels)
+  * @param  gain: Q1.30 gain
+  * @param  gain_step: added to the gain before each stereo frame
+  */
+void AUDIO_Conv32_Ref(uint32_t* pDst, const uint8_t* pSrc, uint32_t samples, int32_t gain, int32_t gain_step){
+	for (uint32_t i = 0; i < samples; i++) {
+		UN32 sample;
+		sample.b[0] = 0x00;    // pad byte is ignored
+		sample.b[1] = pSrc[1]; // lsb
+		sample.b[2] = pSrc[2];
+		sample.b[3] = pSrc[3]; // msb
+		if ((i & 1U) == 0U) gain += gain_step;
+
+		uint32_t x = ((uint32_t)(int32_t)(((int64_t)sample.s * gain) >> 30)) & CONV_MASK24;
+		*pDst++ = (x >> 16) | (x << 16);
+		pSrc += 4;
+		}
+	}
+
+
+// SMMUL returns the Q1.30 product shifted right by 2. Rotating right by 14 instead of 16
+// undoes the shift and does the I2S halfword swap in one step, the mask clears the sign
+// bits and product bits that land in the low byte of the sample.
+// mode is a compile-time constant in every kernel, so only one branch survives.
+__STATIC_FORCEINLINE uint32_t Conv_Gain(uint32_t x, int32_t gain, const AUDIO_ConvVolModeTypeDef mode){
+	if (mode == AUDIO_CONV_VOL_UNITY) {
+		return CONV_SWAP16(x);
+		}
+	return CONV_ROR14(Conv_Smmul((int32_t)x, gain)) & CONV_MASK24_SWAP16;
+	}
+
+
+__STATIC_FORCEINLINE void Conv24_Kernel(uint32_t* pDst, const uint8_t* pSrc, uint32_t samples, int32_t gain, int32_t gain_step, const AUDIO_ConvVolModeTypeDef mode){
+	if (mode == AUDIO_CONV_VOL_MUTE) {
+		while (samples--) {
+			*pDst++ = 0U;
+			}
+		return;
+		}
+
+	const uint32_t* pIn = (const uint32_t*)pSrc;
+	uint32_t quads = samples >> 2;
+
+	while (quads--) {
+		// w0 = {R0.lo, L0.hi, L0.mid, L0.lo}  w1 = {L1.mid, L1.lo, R0.hi, R0.mid}  w2 = {R1.hi, R1.mid, R1.lo, L1.hi}
+		uint32_t w0 = pIn[0];
+		uint32_t w1 = pIn[1];
+		uint32_t w2 = pIn[2];
+		if (mode == AUDIO_CONV_VOL_RAMP) gain += gain_step;
+		pDst[0] = Conv_Gain(w0 << 8, gain, mode);
+		pDst[1] = Conv_Gain(CONV_PKHBT((w0 >> 16) & 0xFF00U, w1, 16), gain, mode);
+		if (mode == AUDIO_CONV_VOL_RAMP) gain += gain_step;
+		pDst[2] = Conv_Gain((w2 << 24) | ((w1 >> 8) & 0x00FFFF00U), gain, mode);
+		pDst[3] = Conv_Gain(w2 & CONV_MASK24, gain, mode);
+		pIn += 3;
+		pDst += 4;
+		}
+
+	// remaining samples with byte loads
+	const uint8_t* pb = (const uint8_t*)pIn;
+	samples &= 3U;
+	for (uint32_t i = 0; i < samples; i++) {
+		uint32_t x = ((uint32_t)pb[2] << 24) | ((uint32_t)pb[1] << 16) | ((uint32_t)pb[0] << 8);
+		if ((mode == AUDIO_CONV_VOL_RAMP) && ((i & 1U) == 0U)) gain += gain_step;
+		*pDst++ = Conv_Gain(x, gain, mode);
+		pb += 3;
+		}
+	}
+
+
+// The gain keeps the low bits of an attenuated 16bit sample in the 24bit output
+__STATIC_FORCEINLINE void Conv16_Kernel(uint32_t* pDst, const uint8_t* pSrc, uint32_t samples, int32_t gain, int32_t gain_step, const AUDIO_ConvVolModeTypeDef mode){
+	if (mode == AUDIO_CONV_VOL_MUTE) {
+		while (samples--) {
+			*pDst++ = 0U;
+			}
+		return;
+		}
+
+	const uint32_t* pIn = (const uint32_t*)pSrc;
+	uint32_t pairs = samples >> 1;
+
+	while (pairs--) {
+		// w = {R.hi, R.lo, L.hi, L.lo}
+		uint32_t w = *pIn++;
+		if (mode == AUDIO_CONV_VOL_RAMP) gain += gain_step;
+		pDst[0] = Conv_Gain(w << 16, gain, mode);
+		pDst[1] = Conv_Gain(w & 0xFFFF0000U, gain, mode);
+		pDst += 2;
+		}
+
+	if (samples & 1U) {
+		const uint8_t* pb = (const uint8_t*)pIn;
+		if (mode == AUDIO_CONV_VOL_RAMP) gain += gain_step;
+		*pDst = Conv_Gain(((uint32_t)pb[1] << 24) | ((uint32_t)pb[0] << 16), gain, mode);
+		}
+	}
+
+
+// The samples are already left-aligned words, at unity gain this is a copy with a mask and a rotate
+__STATIC_FORCEINLINE void Conv32_Kernel(uint32_t* pDst, const uint8_t* pSrc, uint32_t samples, int32_t gain, int32_t gain_step, const AUDIO_ConvVolModeTypeDef mode){
+	if (mode == AUDIO_CONV_VOL_MUTE) {
+		while (samples--) {
+			*pDst++ = 0U;
+			}
+		return;
+		}
+
+	const uint32_t* pIn = (const uint32_t*)pSrc;
+
+	for (uint32_t i = 0; i < samples; i++) {
+		if ((mode == AUDIO_CONV_VOL_RAMP) && ((i & 1U) == 0U)) gain += gain_step;
+		*pDst++ = Conv_Gain(*pIn++ & CONV_MASK24, gain, mode);
+		}
+	}
+
+
+/**
+  * @brief  Specialised word-at-a-time conversion kernels, one per subframe format and gain mode
+  * @param  pDst: I2S buffer, 1 word per sample, word aligned
+  * @param  pSrc: USB packet data, word aligned
+  * @param  samples: number of samples (frames * channels)
+  * @param  gain: Q1.30 gain
+  * @param  gain_step: added to the gain before each stereo frame, ramp kernel only
+  */
+#define AUDIO_CONV_DEFINE(name, mode) \
+void AUDIO_Conv24_##name(uint32_t* pDst, const uint8_t* pSrc, uint32_t samples, int32_t gain, int32_t gain_step){ \
+	Conv24_Kernel(pDst, pSrc, samples, gain, gain_step, mode); \
+	} \
+void AUDIO_Conv16_##name(uint32_t* pDst, const uint8_t* pSrc, uint32_t samples, int32_t gain, int32_t gain_step){ \
+	Conv16_Kernel(pDst, pSrc, samples, gain, gain_step, mode); \
+	} \
+void AUDIO_Conv32_##name(uint32_t* pDst, const uint8_t* pSrc, uint32_t samples, int32_t gain, int32_t gain_step){ \
+	Conv32_Kernel(pDst, pSrc, samples, gain, gain_step, mode); \
+	}
+AUDIO_CONV_VOL_MODES(AUDIO_CONV_DEFINE)
+#undef AUDIO_CONV_DEFINE
+
+#define AUDIO_CONV_ENTRY16(name, mode) [mode] = AUDIO_Conv16_##name,
+#define AUDIO_CONV_ENTRY24(name, mode) [mode] = AUDIO_Conv24_##name,
+#define AUDIO_CONV_ENTRY32(name, mode) [mode] = AUDIO_Conv32_##name,
+static const AUDIO_ConvFunc ConvTable[AUDIO_CONV_FMT_NUM][AUDIO_CONV_VOL_NUM] = {
+	[AUDIO_CONV_FMT_16] = { AUDIO_CONV_VOL_MODES(AUDIO_CONV_ENTRY16) },
+	[AUDIO_CONV_FMT_24] = { AUDIO_CONV_VOL_MODES(AUDIO_CONV_ENTRY24) },
+	[AUDIO_CONV_FMT_32] = { AUDIO_CONV_VOL_MODES(AUDIO_CONV_ENTRY32) },
+};
+#undef AUDIO_CONV_ENTRY16
+#undef AUDIO_CONV_ENTRY24
+#undef AUDIO_CONV_ENTRY32
+
+#ifdef DEBUG_AUDIO_CONV_BENCHMARK
+typedef void (*AUDIO_ConvRefFunc)(uint32_t* pDst, const uint8_t* pSrc, uint32_t samples, int32_t gain, int32_t gain_step);
+static const AUDIO_ConvRefFunc ConvRefTable[AUDIO_CONV_FMT_NUM] = {
+	[AUDIO_CONV_FMT_16] = AUDIO_Conv16_Ref,
+	[AUDIO_CONV_FMT_24] = AUDIO_Conv24_Ref,
+	[AUDIO_CONV_FMT_32] = AUDIO_Conv32_Ref,
+};
+#endif
+
+
+static void Conv_SetMode(AUDIO_ConvTypeDef* pConv){
+	AUDIO_ConvVolModeTypeDef mode;
+
+	if (pConv->gain != pConv->gain_target) {
+		mode = AUDIO_CONV_VOL_RAMP;
+		}
+	else
+	if (pConv->gain == 0) {
+		mode = AUDIO_CONV_VOL_MUTE;
+		}
+	else
+	if (pConv->gain == AUDIO_CONV_GAIN_UNITY) {
+		mode = AUDIO_CONV_VOL_UNITY;
+		}
+	else {
+		mode = AUDIO_CONV_VOL_GAIN;
+		}
+
+	pConv->mode = mode;
+	pConv->func = ConvTable[pConv->format][mode];
+	}
+
+
+/**
+  * @brief  Select the conversion kernel for the stream format and gain setting.
+  *         Call when the alternate setting, volume or mute setting changes.
+  * @param  pConv: converter to update
+  * @param  subframe_bytes: USB audio subframe size
+  * @param  gain: Q1.30 gain, see AUDIO_Conv_VolumeToGain
+  * @param  mute: 1 = muted
+  * @param  ramp: 1 = ramp to the new gain over the next packet, 0 = apply immediately
+  */
+void AUDIO_Conv_Select(AUDIO_ConvTypeDef* pConv, uint32_t subframe_bytes, int32_t gain, uint8_t mute, uint8_t ramp){
+	switch (subframe_bytes) {
+		case 2:
+			pConv->format = AUDIO_CONV_FMT_16;
+			break;
+		case 4:
+			pConv->format = AUDIO_CONV_FMT_32;
+			break;
+		case 3:
+		default:
+			subframe_bytes = 3U;
+			pConv->format = AUDIO_CONV_FMT_24;
+			break;
+		}
+	pConv->in_bytes = subframe_bytes;
+	pConv->gain_target = mute ? 0 : gain;
+	if (ramp == 0U) {
+		pConv->gain = pConv->gain_target;
+		}
+	Conv_SetMode(pConv);
+	}
+
+
+/**
+  * @brief  Convert one USB packet into the I2S buffer. After a gain change the
+  *         gain is interpolated over the packet, then the constant gain kernel
+  *         is selected for the next packets.
+  * @param  pConv: converter
+  * @param  pDst: I2S buffer, word aligned
+  * @param  pSrc: USB packet data, word aligned
+  * @param  frames: number of stereo frames in the packet
+  */
+void AUDIO_Conv_Packet(AUDIO_ConvTypeDef* pConv, uint32_t* pDst, const uint8_t* pSrc, uint32_t frames){
+	if (frames == 0U) {
+		return;
+		}
+	if (pConv->mode == AUDIO_CONV_VOL_RAMP) {
+		int32_t gain_step = (pConv->gain_target - pConv->gain) / (int32_t)frames;
+		pConv->func(pDst, pSrc, frames * 2U, pConv->gain, gain_step);
+		pConv->gain = pConv->gain_target;
+		Conv_SetMode(pConv);
+		}
+	else {
+		pConv->func(pDst, pSrc, frames * 2U, pConv->gain, 0);
+		}
+	}
+
+
+/**
+  * @brief  Fade converted frames linearly to silence, used to conceal a buffer underrun.
+  * @param  pRing: I2S ring buffer
+  * @param  pos: word offset of the first frame
+  * @param  size: ring buffer size in words, pos wraps to 0 at the end
+  * @param  frames: number of stereo frames to fade, the last one is near silence
+  */
+void AUDIO_Conv_FadeOut(uint32_t* pRing, uint32_t pos, uint32_t size, uint32_t frames){
+	if (frames == 0U) {
+		return;
+		}
+	int32_t gain_step = AUDIO_CONV_GAIN_UNITY / (int32_t)frames;
+	int32_t gain = AUDIO_CONV_GAIN_UNITY;
+	for (uint32_t n = 0; n < frames; n++) {
+		gain -= gain_step;
+		for (uint32_t ch = 0; ch < 2U; ch++) {
+			int32_t s = AUDIO_I2S_Sample(pRing[pos]);
+			pRing[pos] = AUDIO_I2S_Word((int32_t)((uint32_t)(int32_t)(((int64_t)s * gain) >> 30) & CONV_MASK24));
+			pos++;
+			}
+		if (pos >= size) {
+			pos = 0U;
+			}
+		}
+	}
+
+
+#ifdef DEBUG_AUDIO_CONV_BENCHMARK
+
+#define BENCH_FRAMES   97U // 96kHz packet with one extra frame, 582 bytes
+
+static uint32_t BenchSrc[BENCH_FRAMES * 2U]; // sized for 32bit subframes
+static uint32_t BenchRef[BENCH_FRAMES * 2U];
+static uint32_t BenchOut[BENCH_FRAMES * 2U];
+
+// -3dB constant gain, ramp from -3dB towards -6dB
+static const int32_t BenchGain[AUDIO_CONV_VOL_NUM] = {
+	[AUDIO_CONV_VOL_UNITY] = AUDIO_CONV_GAIN_UNITY,
+	[AUDIO_CONV_VOL_GAIN]  = 0x2D4EFBD6,
+	[AUDIO_CONV_VOL_RAMP]  = 0x2D4EFBD6,
+	[AUDIO_CONV_VOL_MUTE]  = 0,
+};
+
+static const int32_t BenchStep[AUDIO_CONV_VOL_NUM] = {
+	[AUDIO_CONV_VOL_RAMP]  = -(0x2D4EFBD6 - 0x2013739E) / (int32_t)BENCH_FRAMES,
+};
+
+static AUDIO_ASRC_TypeDef BenchAsrc;
+static uint32_t BenchRing[(BENCH_FRAMES + 2U) * 2U];
+
+/**
+  * @brief  Measure the DWT cycle count for converting one 97 frame packet (582 bytes in 24bit,
+  *         388 in 16bit, 776 in 32bit) with the reference kernel and each specialised kernel, and check
+  *         that they produce identical I2S buffer contents. Also measures resampling the packet with
+  *         the USE_ADAPTIVE_EP converter at +100ppm.
+  * @param  pBench: results
+  */
+void AUDIO_Conv_Benchmark(AUDIO_ConvBenchTypeDef* pBench){
+	uint32_t seed = 0x12345678U;
+	uint8_t* pb = (uint8_t*)BenchSrc;
+	for (uint32_t i = 0; i < sizeof(BenchSrc); i++) {
+		seed = seed * 1664525U + 1013904223U;
+		pb[i] = (uint8_t)(seed >> 24);
+		}
+
+	CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+	DWT->CYCCNT = 0;
+	DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+	pBench->frames = BENCH_FRAMES;
+
+	__disable_irq();
+	uint32_t t0 = DWT->CYCCNT;
+	AUDIO_Conv24_Ref(BenchRef, (const uint8_t*)BenchSrc, BENCH_FRAMES * 2U, BenchGain[AUDIO_CONV_VOL_GAIN], 0);
+	pBench->ref_cycles = DWT->CYCCNT - t0;
+	__enable_irq();
+
+	for (uint32_t fmt = 0; fmt < AUDIO_CONV_FMT_NUM; fmt++) {
+		for (uint32_t mode = 0; mode < AUDIO_CONV_VOL_NUM; mode++) {
+			__disable_irq();
+			t0 = DWT->CYCCNT;
+			ConvTable[fmt][mode](BenchOut, (const uint8_t*)BenchSrc, BENCH_FRAMES * 2U, BenchGain[mode], BenchStep[mode]);
+			pBench->cycles[fmt][mode] = DWT->CYCCNT - t0;
+			__enable_irq();
+
+			ConvRefTable[fmt](BenchRef, (const uint8_t*)BenchSrc, BENCH_FRAMES * 2U, BenchGain[mode], BenchStep[mode]);
+			pBench->mismatch[fmt][mode] = 0;
+			for (uint32_t i = 0; i < BENCH_FRAMES * 2U; i++) {
+				if (BenchRef[i] != BenchOut[i]) pBench->mismatch[fmt][mode]++;
+				}
+			}
+		}
+
+	AUDIO_ASRC_Init(&BenchAsrc);
+	AUDIO_ASRC_SetStep(&BenchAsrc, AUDIO_ASRC_STEP_ONE + (AUDIO_ASRC_STEP_ONE / 10000U));
+	memcpy(AUDIO_ASRC_Input(&BenchAsrc), BenchRef, sizeof(BenchRef));
+	uint64_t t;
+	pBench->asrc_frames = AUDIO_ASRC_Reserve(&BenchAsrc, BENCH_FRAMES, &t);
+	__disable_irq();
+	t0 = DWT->CYCCNT;
+	AUDIO_ASRC_Process(&BenchAsrc, BenchRing, 0U, sizeof(BenchRing)/4U, BENCH_FRAMES, pBench->asrc_frames, t, BenchAsrc.step);
+	pBench->asrc_cycles = DWT->CYCCNT - t0;
+	__enable_irq();
+	}
+#endif
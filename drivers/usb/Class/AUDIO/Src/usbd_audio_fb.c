@@ -0,0 +1,92 @@
+/**
+  ******************************************************************************
+  * @file    usbd_audio_fb.c
+  * @brief   Feedback endpoint controller, see usbd_audio_fb.h
+  *
+  *          Gains are tuned with the closed loop simulator in tools/fb_sim,
+  *          which models host/device clock drift, packet size patterns and
+  *          packet arrival jitter.
+  ******************************************************************************
+  */
+
+#include "usbd_audio_fb.h"
+
+// USB frame number (FNSOF) is 14 bits
+#define FRAME_MASK  0x3FFFU
+
+void AUDIO_FB_Init(AUDIO_FB_TypeDef* pFb, uint32_t fb_nom, uint32_t setpoint_frames, uint32_t tick_khz) {
+	pFb->fb_pll = fb_nom;
+	pFb->fb_nom = fb_nom;
+	pFb->fb = fb_nom;
+	pFb->setpoint = (int32_t)(setpoint_frames << 8);
+	pFb->fill = pFb->setpoint;
+	pFb->integ = 0;
+	pFb->acc = 0;
+	pFb->acc_n = 0;
+	pFb->tick_khz = tick_khz;
+	pFb->meas_run = 0;
+	}
+
+// Called once per feedback refresh period, returns the new feedback value
+uint32_t AUDIO_FB_Update(AUDIO_FB_TypeDef* pFb) {
+	const int64_t delta_max = (int64_t)AUDIO_FB_DELTA_MAX << 8;
+	uint32_t n = pFb->acc_n;
+	if (n == 0U) return pFb->fb;
+
+	// average writable space in frames Q8
+	int32_t writable_q8 = (int32_t)(pFb->acc / (2U * n));
+	pFb->acc = 0;
+	pFb->acc_n = 0;
+
+	// first order low-pass filter, removes the packet arrival sawtooth and read pointer quantisation
+	uint32_t n_lpf = (n < (1U << AUDIO_FB_LPF_SHIFT)) ? n : (1U << AUDIO_FB_LPF_SHIFT);
+	pFb->fill += (int32_t)(((int64_t)(writable_q8 - pFb->fill) * n_lpf) >> AUDIO_FB_LPF_SHIFT);
+
+	// more writable space than the setpoint : the buffer is draining, ask the host for more frames
+	int32_t err = pFb->fill - pFb->setpoint;
+	int64_t integ = pFb->integ + (int64_t)AUDIO_FB_KI * n * err;
+	if (integ > delta_max) integ = delta_max;
+	if (integ < -delta_max) integ = -delta_max;
+
+	int64_t out = (int64_t)AUDIO_FB_KP * err + integ;
+	if (out > delta_max) {
+		out = delta_max;
+		// do not integrate further into saturation
+		if (err > 0) integ = pFb->integ;
+		}
+	else
+	if (out < -delta_max) {
+		out = -delta_max;
+		if (err < 0) integ = pFb->integ;
+		}
+	pFb->integ = integ;
+	pFb->fb = (uint32_t)((int32_t)pFb->fb_nom + (int32_t)(out >> 8));
+	return pFb->fb;
+	}
+
+
+// Called every SOF with the timer count captured at the SOF and the USB frame number.
+// Missed SOF interrupts only lengthen the window, the frame number counts the USB frames.
+void AUDIO_FB_Measure(AUDIO_FB_TypeDef* pFb, uint32_t tick, uint32_t frame) {
+	if (pFb->tick_khz == 0U) return;
+	if (!pFb->meas_run) {
+		pFb->tick_start = tick;
+		pFb->frame_start = (uint16_t)(frame & FRAME_MASK);
+		pFb->meas_run = 1;
+		return;
+		}
+	uint32_t frames = (frame - pFb->frame_start) & FRAME_MASK;
+	if (frames < (1U << AUDIO_FB_MEAS_SHIFT)) return;
+
+	uint32_t ticks = tick - pFb->tick_start;
+	pFb->tick_start = tick;
+	pFb->frame_start = (uint16_t)(frame & FRAME_MASK);
+
+	uint32_t fb_meas = (uint32_t)(((uint64_t)pFb->fb_pll * ticks) / ((uint64_t)pFb->tick_khz * frames));
+	// discard windows with a timer or SOF glitch (bus suspend, stalled debugger)
+	uint32_t meas_max = (uint32_t)(((uint64_t)pFb->fb_pll * AUDIO_FB_MEAS_PPM_MAX) / 1000000U);
+	if (fb_meas > pFb->fb_pll + meas_max || fb_meas < pFb->fb_pll - meas_max) return;
+
+	// the integral term keeps only the residual trim, so it is not transferred
+	pFb->fb_nom = fb_meas;
+	}
@@ -0,0 +1,80 @@
+/**
+  ******************************************************************************
+  * @file    usbd_audio_telem.c
+  * @brief   Per-SOF telemetry stream, see usbd_audio_telem.h
+  *
+  *          The records are written by USBD_AUDIO_SOF and sent from
+  *          USBD_AUDIO_DataIn, both in the OTG ISR, so the ring needs no locking.
+  *          AUDIO_TelemConvCycles is also raised from PendSV, which the OTG ISR
+  *          preempts, see AUDIO_Telem_ConvCycles.
+  ******************************************************************************
+  */
+
+#include "usbd_audio_telem.h"
+
+static AUDIO_TelemRecordTypeDef telem_ring[AUDIO_TELEM_RECORDS];
+static uint32_t telem_head;  // records written, free running
+static uint32_t telem_tail;  // records sent
+static uint32_t telem_busy;  // records of the transfer in progress, 0 = idle
+static uint16_t telem_seq;
+
+volatile uint32_t AUDIO_TelemIsrCycles = 0;
+volatile uint32_t AUDIO_TelemConvCycles = 0;
+volatile uint8_t  AUDIO_TelemIsoIncomplete = 0;
+
+// send the next contiguous part of the ring
+static void AUDIO_Telem_Send(USBD_HandleTypeDef* pdev) {
+	uint32_t count = telem_head - telem_tail;
+	uint32_t pos = telem_tail & (AUDIO_TELEM_RECORDS - 1U);
+	if (telem_busy || count == 0U) {
+		return;
+		}
+	if (count > AUDIO_TELEM_RECORDS - pos) count = AUDIO_TELEM_RECORDS - pos;
+	if (count > AUDIO_TELEM_BURST) count = AUDIO_TELEM_BURST;
+	telem_busy = count;
+	USBD_LL_Transmit(pdev, AUDIO_TELEM_EP, (uint8_t*)&telem_ring[pos], count * sizeof(AUDIO_TelemRecordTypeDef));
+	}
+
+void AUDIO_Telem_Init(USBD_HandleTypeDef* pdev) {
+	USBD_LL_OpenEP(pdev, AUDIO_TELEM_EP, USBD_EP_TYPE_BULK, AUDIO_TELEM_PACKET);
+	pdev->ep_in[AUDIO_TELEM_EP & 0xFU].is_used = 1U;
+	USBD_LL_FlushEP(pdev, AUDIO_TELEM_EP);
+	telem_head = 0U;
+	telem_tail = 0U;
+	telem_busy = 0U;
+
+	// DWT cycle counter for the ISR and conversion times
+	CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+	DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+	}
+
+void AUDIO_Telem_DeInit(USBD_HandleTypeDef* pdev) {
+	USBD_LL_CloseEP(pdev, AUDIO_TELEM_EP);
+	pdev->ep_in[AUDIO_TELEM_EP & 0xFU].is_used = 0U;
+	telem_busy = 0U;
+	}
+
+// Completes the record with the counters and queues it, dropped when the ring is full
+void AUDIO_Telem_Put(USBD_HandleTypeDef* pdev, AUDIO_TelemRecordTypeDef* pRec) {
+	uint32_t conv = AUDIO_TelemConvCycles >> 4;
+	pRec->magic = AUDIO_TELEM_MAGIC;
+	pRec->seq = telem_seq++;
+	pRec->isr_cycles = AUDIO_TelemIsrCycles;
+	pRec->conv_cycles = (uint16_t)((conv > 0xFFFFU) ? 0xFFFFU : conv);
+	pRec->iso_incomplete = AUDIO_TelemIsoIncomplete;
+	AUDIO_TelemIsrCycles = 0U;
+	AUDIO_TelemConvCycles = 0U;
+
+	if (telem_head - telem_tail < AUDIO_TELEM_RECORDS) {
+		telem_ring[telem_head & (AUDIO_TELEM_RECORDS - 1U)] = *pRec;
+		telem_head++;
+		}
+	AUDIO_Telem_Send(pdev);
+	}
+
+// The host has read the transfer
+void AUDIO_Telem_DataIn(USBD_HandleTypeDef* pdev) {
+	telem_tail += telem_busy;
+	telem_busy = 0U;
+	AUDIO_Telem_Send(pdev);
+	}
@@ -0,0 +1,69 @@
+/**
+  ******************************************************************************
+  * @file    usbd_audio_trace.c
+  * @brief   Event triggered trace of the feedback loop, see usbd_audio_trace.h
+  ******************************************************************************
+  */
+
+#include "usbd_audio_trace.h"
+
+#ifdef DEBUG_FEEDBACK_ENDPOINT
+
+_Static_assert((AUDIO_TRACE_DEPTH & (AUDIO_TRACE_DEPTH - 1U)) == 0U, "AUDIO_TRACE_DEPTH must be a power of 2");
+_Static_assert(AUDIO_TRACE_POST < AUDIO_TRACE_DEPTH, "AUDIO_TRACE_POST must be less than AUDIO_TRACE_DEPTH");
+
+AUDIO_TraceTypeDef AUDIO_Trace = {0};
+
+// Called in every SOF, writes an entry if record is set or an event is pending
+void AUDIO_Trace_Sof(uint32_t writable_q8, uint32_t feedback, uint32_t record) {
+	AUDIO_TraceTypeDef* t = &AUDIO_Trace;
+	uint8_t ev = t->events;
+	t->sof++;
+	if (t->state == AUDIO_TRACE_FROZEN) {
+		if (ev) t->missed++;
+		t->events = 0U;
+		return;
+		}
+	if (!record && !ev) {
+		return;
+		}
+	t->events = 0U;
+
+	AUDIO_TraceEntryTypeDef* e = &t->entry[t->head & (AUDIO_TRACE_DEPTH - 1U)];
+	e->sof = t->sof;
+	e->feedback = feedback;
+	e->writable_q8 = (writable_q8 > 0xFFFFFFU) ? 0xFFFFFFU : writable_q8;
+	e->events = ev;
+	t->head++;
+
+	if (t->state == AUDIO_TRACE_ARMED) {
+		if (ev & AUDIO_TRACE_TRIGGER) {
+			t->trigger = t->head - 1U;
+			t->post = AUDIO_TRACE_POST;
+			t->state = AUDIO_TRACE_TRIGGERED;
+			}
+		}
+	else {
+		t->post--;
+		}
+	if (t->state == AUDIO_TRACE_TRIGGERED && t->post == 0U) {
+		t->state = AUDIO_TRACE_FROZEN;
+		}
+	}
+
+// Main loop : stop recording to read the entries, untriggered the trace holds the latest ones
+void AUDIO_Trace_Freeze(void) {
+	AUDIO_Trace.state = AUDIO_TRACE_FROZEN;
+	}
+
+// Main loop : clear the entries and wait for the next trigger
+void AUDIO_Trace_Arm(void) {
+	AUDIO_TraceTypeDef* t = &AUDIO_Trace;
+	t->head = 0U;
+	t->trigger = 0U;
+	t->missed = 0U;
+	t->events = 0U;
+	t->state = AUDIO_TRACE_ARMED;
+	}
+
+#endif
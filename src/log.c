@@ -0,0 +1,109 @@
+/**
+  ******************************************************************************
+  * @file    log.c
+  * @brief   Non-blocking binary logger, see log.h
+  *
+  *          The ring indexes are free running word counts :
+  *          log_rd <= log_commit <= log_reserve <= log_rd + LOG_RING_WORDS
+  ******************************************************************************
+  */
+
+#include "log.h"
+
+static uint32_t log_ring[LOG_RING_WORDS];
+static volatile uint32_t log_reserve;  // words reserved by producers
+static volatile uint32_t log_commit;   // words written, the DMA sends up to here
+static volatile uint32_t log_rd;       // words sent, only written by LOG_IRQHandler
+static volatile uint32_t log_writers;  // producers between reserve and commit
+static uint32_t log_dma_words;         // words of the running transfer, 0 = idle
+
+volatile uint32_t LogDropped = 0;
+
+static inline uint32_t LOG_AtomicAdd(volatile uint32_t* p, uint32_t v) {
+	uint32_t x;
+	do {
+		x = __LDREXW(p) + v;
+		} while (__STREXW(x, p));
+	return x;
+	}
+
+// USART2 is initialised by MX_USART2_UART_Init, the DMA stream by HAL_UART_MspInit
+void LOG_Init(void) {
+	LOG_DMA_STREAM->PAR = (uint32_t)&USART2->DR;
+	LOG_DMA_STREAM->CR |= DMA_SxCR_TCIE | DMA_SxCR_TEIE;
+	USART2->CR3 |= USART_CR3_DMAT;
+	}
+
+void LOG_Write(const char* fmt, const uint32_t* args, uint32_t nargs) {
+	uint32_t pos;
+	uint32_t full;
+	if (nargs > LOG_ARGS_MAX) nargs = LOG_ARGS_MAX;
+	uint32_t words = nargs + 1U;
+
+	LOG_AtomicAdd(&log_writers, 1U);
+	do {
+		pos = __LDREXW(&log_reserve);
+		full = (pos + words - log_rd > LOG_RING_WORDS);
+		if (full) {
+			__CLREX();
+			break;
+			}
+		} while (__STREXW(pos + words, &log_reserve));
+
+	if (full) {
+		LOG_AtomicAdd(&LogDropped, 1U);
+		}
+	else {
+		log_ring[pos & (LOG_RING_WORDS - 1U)] = LOG_SYNC | (nargs << 24) | ((uint32_t)fmt - FLASH_BASE);
+		for (uint32_t n = 0; n < nargs; n++) {
+			log_ring[(pos + 1U + n) & (LOG_RING_WORDS - 1U)] = args[n];
+			}
+		}
+
+	// The last producer out publishes everything reserved so far. A producer preempted before its
+	// commit is still counted in log_writers, so its record is not published half written.
+	if (LOG_AtomicAdd(&log_writers, (uint32_t)-1) == 0U) {
+		uint32_t end = log_reserve;
+		uint32_t commit;
+		__DMB();
+		do {
+			commit = __LDREXW(&log_commit);
+			if ((int32_t)(end - commit) <= 0) {
+				__CLREX();
+				break;
+				}
+			} while (__STREXW(end, &log_commit));
+		NVIC_SetPendingIRQ(LOG_DMA_IRQ);
+		}
+	}
+
+// Main loop only : wait until the DMA has sent enough of the ring for words more
+void LOG_Wait(uint32_t words) {
+	while (log_reserve + words - log_rd > LOG_RING_WORDS) {
+		}
+	}
+
+// DMA transfer complete, or pended by LOG_Write : send the next contiguous part of the ring
+void LOG_IRQHandler(void) {
+	if (LOG_DMA->HISR & (DMA_HISR_TCIF6 | DMA_HISR_TEIF6)) {
+		LOG_DMA->HIFCR = LOG_DMA_FLAGS;
+		log_rd += log_dma_words;
+		log_dma_words = 0U;
+		}
+
+	if (log_dma_words == 0U) {
+		uint32_t rd = log_rd;
+		uint32_t pos = rd & (LOG_RING_WORDS - 1U);
+		uint32_t words = log_commit - rd;
+		if (words > LOG_RING_WORDS - pos) {
+			words = LOG_RING_WORDS - pos;
+			}
+		if (words) {
+			log_dma_words = words;
+			LOG_DMA->HIFCR = LOG_DMA_FLAGS;
+			LOG_DMA_STREAM->M0AR = (uint32_t)&log_ring[pos];
+			LOG_DMA_STREAM->NDTR = words * 4U;
+			LOG_DMA_STREAM->CR |= DMA_SxCR_EN;
+			}
+		}
+	}
@@ -0,0 +1,67 @@
+/**
+  ******************************************************************************
+  * @file    log.h
+  * @brief   Non-blocking binary logger, USART2 TX DMA
+  ******************************************************************************
+  */
+
+#ifndef __LOG_H
+#define __LOG_H
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+#include "stm32f4xx_hal.h"
+
+// LOG(fmt, args...) does not format anything. It writes a record with the flash address of the
+// format string and the arguments as 32bit words to a ring buffer, and the USART2 TX DMA sends
+// the ring in the background. tools/logdec expands the records to text with the format strings
+// from the firmware elf file, so the elf must be the one flashed.
+//
+// LOG can be called from the main loop and from any ISR. Producers reserve ring space with
+// LDREX/STREX, the last producer to finish publishes the reserved words to the DMA, so a record
+// interrupted by a higher priority one is never sent half written. When the ring is full the
+// record is dropped and counted in LogDropped, LOG never waits.
+//
+// fmt must be a string literal. The arguments are converted to uint32_t, use LOG_F for a float
+// (%f %e %g) and LOG_S for a string constant (%s), the decoder reads the string from the elf.
+//
+// Record, little-endian words : header, args[n]
+// header = LOG_SYNC | n << 24 | (fmt - FLASH_BASE)
+
+#define LOG_RING_WORDS    512U   // power of 2
+#define LOG_ARGS_MAX      15U
+#define LOG_SYNC          0xA0000000U
+#define LOG_SYNC_MASK     0xF0000000U
+
+#define LOG_DMA                 DMA1
+#define LOG_DMA_STREAM          DMA1_Stream6
+#define LOG_DMA_CHANNEL         DMA_CHANNEL_4
+#define LOG_DMA_IRQ             DMA1_Stream6_IRQn
+#define LOG_DMA_FLAGS           (DMA_HIFCR_CTCIF6 | DMA_HIFCR_CHTIF6 | DMA_HIFCR_CTEIF6 | DMA_HIFCR_CDMEIF6 | DMA_HIFCR_CFEIF6)
+
+extern volatile uint32_t LogDropped;
+
+static inline uint32_t LOG_F(float f) {
+  union { float f; uint32_t u; } v = { .f = f };
+  return v.u;
+}
+
+#define LOG_S(s)  ((uint32_t)(const char*)(s))
+
+#define LOG(fmt, ...) do { \
+  const uint32_t log_args_[] = {0U, ##__VA_ARGS__}; \
+  LOG_Write(fmt, &log_args_[1], sizeof(log_args_)/sizeof(uint32_t) - 1U); \
+  } while (0)
+
+void LOG_Init(void);
+void LOG_Write(const char* fmt, const uint32_t* args, uint32_t nargs);
+void LOG_Wait(uint32_t words);
+void LOG_IRQHandler(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __LOG_H */
@@ -1,8 +1,11 @@
 #include "main.h"
 #include "usart.h"
 #include "usbd_audio.h"
-#include <stdio.h>
-#include <stdarg.h>
+#include "profile.h"
+#include "log.h"
+#ifdef DEBUG_AUDIO_CONV_BENCHMARK
+#include "usbd_audio_conv.h"
+#endif
 
 USBD_HandleTypeDef USBD_Device;
 AUDIO_STATUS_TypeDef audio_status;
@@ -15,9 +18,37 @@ int main(void) {
   SystemClock_Config();
 
   MX_USART2_UART_Init();
-  printMsg("\r\nUSB Audio I2S Bridge\r\n");
+  LOG_Init();
+  LOG("\r\nUSB Audio I2S Bridge\r\n");
 
   bsp_init();
+#ifdef DEBUG_PROFILE // see Makefile C_DEFS
+  PROF_Init();
+#endif
+
+  // KEY held at boot : lowest latency profile, the host can change it with a vendor request
+  HAL_Delay(2); // PA0 pull-up settling
+  if (BSP_PB_GetState() == GPIO_PIN_RESET) {
+	USBD_AUDIO_SetLatencyProfile(0);
+	LOG("Low latency profile\r\n");
+	}
+
+#ifdef DEBUG_AUDIO_CONV_BENCHMARK // see Makefile C_DEFS
+  // DWT cycles to convert one 96kHz packet (97 frames), see usbd_audio_conv.c
+  {
+	static const char* fmt_name[AUDIO_CONV_FMT_NUM] = {"16bit", "24bit", "32bit"};
+	static const char* mode_name[AUDIO_CONV_VOL_NUM] = {"unity", "-3dB", "ramp", "mute"};
+	AUDIO_ConvBenchTypeDef bench;
+	AUDIO_Conv_Benchmark(&bench);
+	LOG("Conv24 %d frames : ref %d cycles\r\n", bench.frames, bench.ref_cycles);
+	for (int fmt = 0; fmt < AUDIO_CONV_FMT_NUM; fmt++) {
+		for (int mode = 0; mode < AUDIO_CONV_VOL_NUM; mode++) {
+			LOG("  %s %s : %d cycles, mismatch %d\r\n", LOG_S(fmt_name[fmt]), LOG_S(mode_name[mode]), bench.cycles[fmt][mode], bench.mismatch[fmt][mode]);
+			}
+		}
+	LOG("ASRC %d frames : %d cycles\r\n", bench.asrc_frames, bench.asrc_cycles);
+  }
+#endif
 
   // Init Device Library
   USBD_Init(&USBD_Device, &AUDIO_Desc, 0);
@@ -29,42 +60,68 @@ int main(void) {
   USBD_Start(&USBD_Device);
   
   while (1) {
+    // one LED combination per sampling frequency
+    uint32_t leds;
     switch (audio_status.frequency) {
-      case 44100:
-          BSP_LED_Off(LED_RED);
-          BSP_LED_Off(LED_GREEN);
-          BSP_LED_On(LED_BLUE);
-          break;
-      case 48000:
-          BSP_LED_Off(LED_RED);
-          BSP_LED_On(LED_GREEN);
-          BSP_LED_Off(LED_BLUE);
-          break;
-      case 96000:
-          BSP_LED_On(LED_RED);
-          BSP_LED_Off(LED_GREEN);
-          BSP_LED_Off(LED_BLUE);
-          break;
-      default:
-          BSP_LED_Off(LED_RED);
-          BSP_LED_Off(LED_GREEN);
-          BSP_LED_Off(LED_BLUE);
-          break;
+      case 32000:  leds = (1 << LED_GREEN) | (1 << LED_BLUE); break;
+      case 44100:  leds = (1 << LED_BLUE); break;
+      case 48000:  leds = (1 << LED_GREEN); break;
+      case 88200:  leds = (1 << LED_RED) | (1 << LED_BLUE); break;
+      case 96000:  leds = (1 << LED_RED); break;
+      case 176400: leds = (1 << LED_RED) | (1 << LED_GREEN) | (1 << LED_BLUE); break;
+      case 192000: leds = (1 << LED_RED) | (1 << LED_GREEN); break;
+      default:     leds = 0; break;
+    }
+    for (Led_TypeDef led = LED_RED; led <= LED_BLUE; led++) {
+      if (leds & (1 << led)) {
+        BSP_LED_On(led);
+      } else {
+        BSP_LED_Off(led);
+      }
     }
 
     HAL_Delay(100);
-#ifdef DEBUG_FEEDBACK_ENDPOINT // see Makefile C_DEFS
-    // see USBD_AUDIO_SOF() in usbd_audio.c
+#if defined(DEBUG_FEEDBACK_ENDPOINT) || defined(DEBUG_PROFILE) // see Makefile C_DEFS
 	if (BtnPressed) {
 		BtnPressed = 0;
-		printMsg("DbgOptimalWritableSamples = %d\r\nDbgSafeZoneWritableSamples = %d\r\n", AUDIO_TOTAL_BUF_SIZE/(2*6), AUDIO_BUF_SAFEZONE_SAMPLES);
-		printMsg("DbgMaxWritableSamples = %d\r\nDbgMinWritableSamples = %d\r\n\r\n", DbgMaxWritableSamples, DbgMinWritableSamples);
-		int count = 256;
-		while (count--){
-			// print oldest to newest
-			printMsg("%d %d %f\r\n", DbgSofHistory[DbgIndex], DbgWritableSampleHistory[DbgIndex], DbgFeedbackHistory[DbgIndex]);
-			DbgIndex++;
+#ifdef DEBUG_PROFILE
+		// ISR and hot path cycles since the last press, see profile.h
+		PROF_Dump();
+#endif
+#ifdef DEBUG_FEEDBACK_ENDPOINT
+		// see USBD_AUDIO_SOF() in usbd_audio.c
+		LOG("DbgOptimalWritableSamples = %d\r\nDbgSafeZoneWritableSamples = %d\r\n", DbgOptimalWritableSamples, DbgSafeZoneWritableSamples);
+		LOG("DbgMaxWritableSamples = %d\r\nDbgMinWritableSamples = %d\r\n", DbgMaxWritableSamples, DbgMinWritableSamples);
+		// packets are converted in place, the rx guard area replaces a 1024 byte receive buffer
+		LOG("DbgDataOutCycles = %d\r\nDbgDataOutCyclesMax = %d\r\nRxGuardBytes = %d\r\n", DbgDataOutCycles, DbgDataOutCyclesMax, AUDIO_OUT_RX_GUARD*4);
+		// conversion runs in PendSV, the OTG ISR only queues the packet
+		LOG("DbgConvCycles = %d\r\nDbgConvCyclesMax = %d\r\nDbgOtgIsrCyclesMax = %d\r\nDbgQueueOverflows = %d\r\n", DbgConvCycles, DbgConvCyclesMax, DbgOtgIsrCyclesMax, DbgQueueOverflows);
+		// concealed underruns and dropped packets since power up
+		LOG("Underruns = %d\r\nOverruns = %d\r\n", USBD_AUDIO_Xrun.underruns, USBD_AUDIO_Xrun.overruns);
+		// log records dropped on a full ring, see log.h
+		LOG("LogDropped = %d\r\n", LogDropped);
+		// stream restart, the last sampling frequency or alternate setting change
+		LOG("DbgRestartCycles = %d\r\n", DbgRestartCycles);
+		// SET_CUR frequency to the first valid sample, fast = switched without re-initialising I2S and DMA
+		LOG("DbgSwitchCycles = %d\r\nDbgSwitchFast = %d\r\n", DbgSwitchCycles, DbgSwitchFast);
+		// first packet of the stream to the first non-zero sample on I2S
+		LOG("DbgStartCycles = %d\r\n\r\n", DbgStartCycles);
+		// trace around the first trigger event, or the latest entries, see usbd_audio_trace.h
+		uint8_t triggered = (AUDIO_Trace.state != AUDIO_TRACE_ARMED);
+		AUDIO_Trace_Freeze();
+		uint32_t head = AUDIO_Trace.head;
+		uint32_t first = (head > AUDIO_TRACE_DEPTH) ? head - AUDIO_TRACE_DEPTH : 0U;
+		LOG("Trace %d entries, triggered %d, missed events %d\r\nsof writable_samples feedback events\r\n",
+				head - first, triggered, AUDIO_Trace.missed);
+		for (uint32_t n = first; n < head; n++) {
+			// print oldest to newest, > marks the trigger
+			AUDIO_TraceEntryTypeDef e = AUDIO_Trace.entry[n & (AUDIO_TRACE_DEPTH - 1U)];
+			LOG_Wait(8U);
+			LOG("%c%d %.2f %f 0x%02x\r\n", (triggered && n == AUDIO_Trace.trigger) ? '>' : ' ', e.sof,
+					LOG_F((float)e.writable_q8/512.0f), LOG_F((float)e.feedback/(float)(1U << 22)), e.events);
 			}
+		AUDIO_Trace_Arm();
+#endif
 		}
 #endif
 
@@ -186,15 +243,6 @@ void SystemClock_Config(void)
 
 
 
-void printMsg(char* format, ...) {
-	char sz[100];
-	va_list args;
-	va_start(args, format);
-	vsprintf(sz, format, args);
-	HAL_UART_Transmit(&huart2, (uint8_t *)sz, strlen(sz), HAL_MAX_DELAY);
-	va_end(args);
-	}
-
 void Error_Handler(void){
 	uint32_t counter;
 	while(1){
@@ -215,7 +263,7 @@ void Error_Handler(void){
   */
 void assert_failed(uint8_t *file, uint32_t line)
 { 
-    printMsg("Wrong parameters value: file %s on line %d\r\n", file, line);
+    LOG("Wrong parameters value: file %s on line %d\r\n", LOG_S(file), line);
 }
 #endif /* USE_FULL_ASSERT */
 
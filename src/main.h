@@ -34,7 +34,6 @@ extern "C" {
 #include "bsp_audio.h"
 
 void Error_Handler(void);
-void printMsg(char* format, ...);
 
 
 #ifdef __cplusplus
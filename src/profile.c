@@ -0,0 +1,67 @@
+/**
+  ******************************************************************************
+  * @file    profile.c
+  * @brief   DWT cycle counter profiler, see profile.h
+  ******************************************************************************
+  */
+
+#include "main.h"
+#include "profile.h"
+#include "log.h"
+
+#ifdef DEBUG_PROFILE
+
+PROF_StatTypeDef ProfStat[PROF_SITE_NUM];
+
+static const char* prof_name[PROF_SITE_NUM] = {
+#define PROF_SITE_NAME(site, name) name,
+  PROF_SITES(PROF_SITE_NAME)
+#undef PROF_SITE_NAME
+};
+
+// cycles counted by an empty probe, included in every measurement
+static uint32_t prof_overhead;
+
+static void PROF_Clear(PROF_StatTypeDef* p) {
+	memset(p, 0, sizeof(PROF_StatTypeDef));
+	p->min = UINT32_MAX;
+	}
+
+void PROF_Init(void) {
+	CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+	DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+	for (int site = 0; site < PROF_SITE_NUM; site++) {
+		PROF_Clear(&ProfStat[site]);
+		}
+	uint32_t start = DWT->CYCCNT;
+	prof_overhead = DWT->CYCCNT - start;
+	}
+
+void PROF_Dump(void) {
+	LOG("Profile, cycles incl. probe overhead %d\r\n", prof_overhead);
+	for (int site = 0; site < PROF_SITE_NUM; site++) {
+		// snapshot and clear, the ISRs keep recording
+		PROF_StatTypeDef stat;
+		__disable_irq();
+		stat = ProfStat[site];
+		PROF_Clear(&ProfStat[site]);
+		__enable_irq();
+
+		if (stat.count == 0U) continue;
+		// one site is at most 56 words of records
+		LOG_Wait(64U);
+		LOG("%s : n %d min %d mean %d max %d\r\n", LOG_S(prof_name[site]), stat.count, stat.min,
+				(uint32_t)(stat.sum / stat.count), stat.max);
+		// non-empty bins as lower bound:count
+		LOG("  hist");
+		for (uint32_t bin = 0; bin < PROF_HIST_BINS; bin++) {
+			if (stat.hist[bin]) {
+				LOG(" %d:%d", bin ? (1U << (bin + PROF_HIST_SHIFT - 1U)) : 0U, stat.hist[bin]);
+				}
+			}
+		LOG("\r\n");
+		}
+	LOG("\r\n");
+	}
+
+#endif
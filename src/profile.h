@@ -0,0 +1,92 @@
+/**
+  ******************************************************************************
+  * @file    profile.h
+  * @brief   DWT cycle counter profiler for the ISRs and the audio hot paths
+  ******************************************************************************
+  */
+
+#ifndef __PROFILE_H
+#define __PROFILE_H
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+#include "stm32f4xx_hal.h"
+
+// Build with DEBUG_PROFILE (see Makefile C_DEFS). Without it the probes expand to nothing.
+//
+// A probe is a PROF_START(site) / PROF_STOP(site) pair in the same block. Each site records
+// the number of calls, min, max, the sum of cycles (mean = sum / count) and a log2 histogram.
+// A site is only updated from one interrupt level, so no locking is needed. The times are
+// inclusive : the OTG ISR contains SOF, DataOut and EP0_RxReady, PendSV contains the packet
+// conversion, and a probe preempted by a higher priority ISR also counts the ISR.
+// A probe costs two DWT->CYCCNT reads and ~15 cycles to record.
+//
+// PROF_Dump prints and clears the statistics, each dump covers the time since the previous one.
+
+// Probe sites
+// X(site, name)
+#define PROF_SITES(X) \
+  X(OTG_ISR, "OTG_FS_IRQHandler")       \
+  X(DMA_ISR, "DMA1_Stream4_IRQHandler") \
+  X(PENDSV,  "PendSV_Handler")          \
+  X(SYSTICK, "SysTick_Handler")         \
+  X(SOF,     "USBD_AUDIO_SOF")          \
+  X(DATAOUT, "USBD_AUDIO_DataOut")      \
+  X(EP0_RX,  "USBD_AUDIO_EP0_RxReady")  \
+  X(CONV,    "Packet conversion")
+
+typedef enum {
+#define PROF_SITE_ENUM(site, name) PROF_##site,
+  PROF_SITES(PROF_SITE_ENUM)
+#undef PROF_SITE_ENUM
+  PROF_SITE_NUM
+} PROF_SiteTypeDef;
+
+// Histogram bin 0 : < 2^PROF_HIST_SHIFT cycles, bin k : [2^(k+PROF_HIST_SHIFT-1), 2^(k+PROF_HIST_SHIFT)),
+// the last bin is open ended (>= 262144 cycles, 2.7ms at 96MHz)
+#define PROF_HIST_SHIFT   4U
+#define PROF_HIST_BINS    16U
+
+typedef struct {
+  uint32_t count;
+  uint32_t min;
+  uint32_t max;
+  uint64_t sum;
+  uint32_t hist[PROF_HIST_BINS];
+} PROF_StatTypeDef;
+
+#ifdef DEBUG_PROFILE
+
+extern PROF_StatTypeDef ProfStat[PROF_SITE_NUM];
+
+static inline void PROF_Record(PROF_SiteTypeDef site, uint32_t cycles) {
+  PROF_StatTypeDef* p = &ProfStat[site];
+  uint32_t bin = 32U - __CLZ(cycles >> PROF_HIST_SHIFT);
+  if (bin >= PROF_HIST_BINS) bin = PROF_HIST_BINS - 1U;
+  p->count++;
+  p->sum += cycles;
+  if (cycles < p->min) p->min = cycles;
+  if (cycles > p->max) p->max = cycles;
+  p->hist[bin]++;
+}
+
+#define PROF_START(site)  uint32_t prof_start_##site = DWT->CYCCNT
+#define PROF_STOP(site)   PROF_Record(PROF_##site, DWT->CYCCNT - prof_start_##site)
+
+void PROF_Init(void);
+void PROF_Dump(void);
+
+#else
+
+#define PROF_START(site)
+#define PROF_STOP(site)
+
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __PROFILE_H */
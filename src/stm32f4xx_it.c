@@ -18,9 +18,12 @@
   */
 #include "main.h"
 #include "stm32f4xx_it.h"
+#include "profile.h"
+#include "log.h"
 
 extern PCD_HandleTypeDef hpcd;
 extern DMA_HandleTypeDef hdma_i2sTx;
+extern USBD_HandleTypeDef USBD_Device;
 
 /******************************************************************************/
 /*           Cortex-M4 Processor Interruption and Exception Handlers          */ 
@@ -130,6 +133,10 @@ void DebugMon_Handler(void)
 void PendSV_Handler(void)
 {
   /* USER CODE BEGIN PendSV_IRQn 0 */
+  PROF_START(PENDSV);
+  // deferred audio packet conversion, pended by the OTG ISR
+  USBD_AUDIO_ProcessPackets(&USBD_Device);
+  PROF_STOP(PENDSV);
 
   /* USER CODE END PendSV_IRQn 0 */
   /* USER CODE BEGIN PendSV_IRQn 1 */
@@ -144,9 +151,11 @@ void SysTick_Handler(void)
 {
   /* USER CODE BEGIN SysTick_IRQn 0 */
 
+  PROF_START(SYSTICK);
   /* USER CODE END SysTick_IRQn 0 */
   HAL_IncTick();
   /* USER CODE BEGIN SysTick_IRQn 1 */
+  PROF_STOP(SYSTICK);
 
   /* USER CODE END SysTick_IRQn 1 */
 }
@@ -167,7 +176,17 @@ void EXTI0_IRQHandler(void)
   */
 void DMA1_Stream4_IRQHandler(void)
 {
+  PROF_START(DMA_ISR);
   HAL_DMA_IRQHandler(&hdma_i2sTx);
+  PROF_STOP(DMA_ISR);
+}
+
+/**
+  * @brief This function handles DMA1 stream6 global interrupt, USART2 TX for the logger.
+  */
+void DMA1_Stream6_IRQHandler(void)
+{
+  LOG_IRQHandler();
 }
 
 /**
@@ -175,7 +194,21 @@ void DMA1_Stream4_IRQHandler(void)
   */
 void OTG_FS_IRQHandler(void)
 {
+#if defined(DEBUG_FEEDBACK_ENDPOINT) || defined(USE_TELEMETRY)
+  uint32_t dbg_cycles = DWT->CYCCNT;
+#endif
+  PROF_START(OTG_ISR);
   HAL_PCD_IRQHandler(&hpcd);
+  PROF_STOP(OTG_ISR);
+#if defined(DEBUG_FEEDBACK_ENDPOINT) || defined(USE_TELEMETRY)
+  dbg_cycles = DWT->CYCCNT - dbg_cycles;
+#endif
+#ifdef DEBUG_FEEDBACK_ENDPOINT
+  if (dbg_cycles > DbgOtgIsrCyclesMax) DbgOtgIsrCyclesMax = dbg_cycles;
+#endif
+#ifdef USE_TELEMETRY
+  AUDIO_Telem_IsrCycles(dbg_cycles);
+#endif
 }
 
 /* USER CODE BEGIN 1 */
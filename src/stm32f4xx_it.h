@@ -33,6 +33,7 @@ void DebugMon_Handler(void);
 void PendSV_Handler(void);
 void SysTick_Handler(void);
 void DMA1_Stream4_IRQHandler(void);
+void DMA1_Stream6_IRQHandler(void);
 void OTG_FS_IRQHandler(void);
 void EXTI1_IRQHandler(void);
 
@@ -17,9 +17,11 @@
   ******************************************************************************
   */
 #include "usart.h"
+#include "log.h"
 
 
 UART_HandleTypeDef huart2;
+DMA_HandleTypeDef hdma_usart2_tx;
 
 
 void MX_USART2_UART_Init(void)
@@ -59,6 +61,28 @@ void HAL_UART_MspInit(UART_HandleTypeDef* uartHandle)
     GPIO_InitStruct.Speed = GPIO_SPEED_FREQ_VERY_HIGH;
     GPIO_InitStruct.Alternate = GPIO_AF7_USART2;
     HAL_GPIO_Init(GPIOA, &GPIO_InitStruct);
+
+    /* USART2_TX DMA, the transfers are started by LOG_IRQHandler */
+    __HAL_RCC_DMA1_CLK_ENABLE();
+    hdma_usart2_tx.Instance = LOG_DMA_STREAM;
+    hdma_usart2_tx.Init.Channel = LOG_DMA_CHANNEL;
+    hdma_usart2_tx.Init.Direction = DMA_MEMORY_TO_PERIPH;
+    hdma_usart2_tx.Init.PeriphInc = DMA_PINC_DISABLE;
+    hdma_usart2_tx.Init.MemInc = DMA_MINC_ENABLE;
+    hdma_usart2_tx.Init.PeriphDataAlignment = DMA_PDATAALIGN_BYTE;
+    hdma_usart2_tx.Init.MemDataAlignment = DMA_MDATAALIGN_BYTE;
+    hdma_usart2_tx.Init.Mode = DMA_NORMAL;
+    hdma_usart2_tx.Init.Priority = DMA_PRIORITY_LOW;
+    hdma_usart2_tx.Init.FIFOMode = DMA_FIFOMODE_DISABLE;
+    if (HAL_DMA_Init(&hdma_usart2_tx) != HAL_OK)
+    {
+      Error_Handler();
+    }
+    __HAL_LINKDMA(uartHandle, hdmatx, hdma_usart2_tx);
+
+    /* lowest priority, below the audio conversion in PendSV */
+    HAL_NVIC_SetPriority(LOG_DMA_IRQ, 15, 0);
+    HAL_NVIC_EnableIRQ(LOG_DMA_IRQ);
   }
 }
 
@@ -74,5 +98,8 @@ void HAL_UART_MspDeInit(UART_HandleTypeDef* uartHandle)
     PA3     ------> USART2_RX
     */
     HAL_GPIO_DeInit(GPIOA, GPIO_PIN_2|GPIO_PIN_3);
+
+    HAL_DMA_DeInit(uartHandle->hdmatx);
+    HAL_NVIC_DisableIRQ(LOG_DMA_IRQ);
   }
 } 
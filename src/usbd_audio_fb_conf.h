@@ -0,0 +1,55 @@
+/**
+  ******************************************************************************
+  * @file    usbd_audio_fb_conf.h
+  * @brief   Feedback endpoint controller tuning, see usbd_audio_fb.h
+  *
+  *          Feedback units : 1kHz = 1 << 22, 1Hz ~= 4194.
+  *          Check changes with the closed loop simulator : cd tools/fb_sim; make
+  *          The defaults can be overridden from the compiler command line.
+  ******************************************************************************
+  */
+
+#ifndef __USBD_AUDIO_FB_CONF_H
+#define __USBD_AUDIO_FB_CONF_H
+
+#ifdef USE_FB_TIMER
+// Measured Fs : the fill level controller only trims the buffer position, lower gains halve the feedback jitter
+#ifndef AUDIO_FB_KP
+#define AUDIO_FB_KP          4096
+#endif
+#ifndef AUDIO_FB_KI
+#define AUDIO_FB_KI          3
+#endif
+#endif
+
+// Proportional gain, feedback units per frame of fill error
+#ifndef AUDIO_FB_KP
+#define AUDIO_FB_KP          8192
+#endif
+
+// Integral gain, feedback units per frame of fill error per ms
+#ifndef AUDIO_FB_KI
+#define AUDIO_FB_KI          8
+#endif
+
+// Fill level low-pass filter time constant 2^AUDIO_FB_LPF_SHIFT ms
+#ifndef AUDIO_FB_LPF_SHIFT
+#define AUDIO_FB_LPF_SHIFT   5
+#endif
+
+// Feedback is limited to the nominal value +/- 1kHz
+#ifndef AUDIO_FB_DELTA_MAX
+#define AUDIO_FB_DELTA_MAX   (1 << 22)
+#endif
+
+// Measured Fs (USE_FB_TIMER) window 2^AUDIO_FB_MEAS_SHIFT ms, resolution ~0.01ppm at 1s with a 96MHz timer
+#ifndef AUDIO_FB_MEAS_SHIFT
+#define AUDIO_FB_MEAS_SHIFT  10
+#endif
+
+// Measured Fs windows further than this from the PLL nominal Fs are discarded
+#ifndef AUDIO_FB_MEAS_PPM_MAX
+#define AUDIO_FB_MEAS_PPM_MAX  1000
+#endif
+
+#endif /* __USBD_AUDIO_FB_CONF_H */
@@ -48,11 +48,12 @@
 
 static int8_t Audio_Init(uint32_t audioFreq, int16_t volume, uint8_t options);
 static int8_t Audio_DeInit(uint8_t options);
-static int8_t Audio_PlaybackCmd(uint16_t* pbuf, uint32_t size, uint8_t cmd);
+static int8_t Audio_PlaybackCmd(uint32_t* pbuf, uint32_t size, uint8_t cmd);
 static int8_t Audio_VolumeCtl(int16_t volume);
 static int8_t Audio_MuteCtl(uint8_t cmd);
 static int8_t Audio_PeriodicTC(uint8_t cmd);
 static int8_t Audio_GetState(void);
+static int8_t Audio_SwitchFreq(uint32_t audioFreq, uint32_t* pbuf, uint32_t size);
 
 extern AUDIO_STATUS_TypeDef audio_status;
 extern USBD_HandleTypeDef USBD_Device;
@@ -64,6 +65,7 @@ USBD_AUDIO_ItfTypeDef USBD_AUDIO_fops = {
     Audio_MuteCtl,
     Audio_PeriodicTC,
     Audio_GetState,
+    Audio_SwitchFreq,
 };
 
 
@@ -101,7 +103,7 @@ static int8_t Audio_DeInit(uint8_t options){
  * @retval Result of the operation: USBD_OK if all operations are OK else
  * USBD_FAIL
  */
-static int8_t Audio_PlaybackCmd(uint16_t* pbuf, uint32_t size, uint8_t cmd){
+static int8_t Audio_PlaybackCmd(uint32_t* pbuf, uint32_t size, uint8_t cmd){
 	switch (cmd) {
 		case AUDIO_CMD_START:
 		  BSP_AUDIO_OUT_Play(pbuf, size);
@@ -159,6 +161,19 @@ static int8_t Audio_GetState(void){
 	return 0;
 	}
 
+/**
+ * @brief  Changes the frequency of a playing stream, the transmit restarts with AUDIO_CMD_START.
+ * @param  AudioFreq: new audio frequency
+ * @param  pbuf: Pointer to the audio buffer, filled with silence
+ * @param  size: Size of the audio buffer in bytes
+ * @retval Result of the operation: USBD_OK if all operations are OK else
+ * USBD_FAIL
+ */
+static int8_t Audio_SwitchFreq(uint32_t audioFreq, uint32_t* pbuf, uint32_t size){
+	audio_status.frequency = audioFreq;
+	return (BSP_AUDIO_OUT_Switch(audioFreq, pbuf, size) == AUDIO_OK) ? USBD_OK : USBD_FAIL;
+	}
+
 /**
  * @brief  Manages the DMA full Transfer complete event.
  * @param  None
@@ -78,6 +78,9 @@ void HAL_PCD_MspInit(PCD_HandleTypeDef *hpcd)
   
   /* Enable USBFS Interrupt */
   HAL_NVIC_EnableIRQ(OTG_FS_IRQn);
+
+  /* Audio packets are converted in PendSV, below the USB and I2S DMA interrupts */
+  HAL_NVIC_SetPriority(PendSV_IRQn, 15, 0);
 }
 
 
@@ -263,11 +266,20 @@ USBD_StatusTypeDef USBD_LL_Init(USBD_HandleTypeDef *pdev)
   HAL_PCD_Init(&hpcd);
   
   // USB fifos share 1.25kB memory = 0x140 words
+#ifdef USE_TELEMETRY
+  // the telemetry endpoint FIFO is taken from the RX FIFO, see usbd_audio_telem.h
+  HAL_PCDEx_SetRxFiFo(&hpcd, 0x110);
+#else
   HAL_PCDEx_SetRxFiFo(&hpcd, 0x120);
+#endif
   /* Set Tx0 FIFO (for EP0 IN) */
   HAL_PCDEx_SetTxFiFo(&hpcd, 0, 0x10);
   /* Set Tx1 FIFO (for EP1 IN) */
   HAL_PCDEx_SetTxFiFo(&hpcd, 1, 0x10);
+#ifdef USE_TELEMETRY
+  /* Set Tx2 FIFO (for EP2 IN, telemetry) */
+  HAL_PCDEx_SetTxFiFo(&hpcd, 2, 0x10);
+#endif
   
   return USBD_OK;
 }
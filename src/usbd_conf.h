@@ -51,7 +51,11 @@
 #include <string.h>
 
 /* Common Config */
+#ifdef USE_TELEMETRY
+#define USBD_MAX_NUM_INTERFACES               3 // audio control, audio streaming, telemetry
+#else
 #define USBD_MAX_NUM_INTERFACES               2 // Isn't interface different from alt_setting ?
+#endif
 #define USBD_MAX_NUM_CONFIGURATION            1
 #define USBD_MAX_STR_DESC_SIZ                 0x100
 #define USBD_SUPPORT_USER_STRING              0 
@@ -60,7 +64,7 @@
 
 /* AUDIO Class Config */
 #define USBD_AUDIO_FREQ_DEFAULT               96000
-#define USBD_AUDIO_FREQ_MAX                   96000
+#define USBD_AUDIO_FREQ_MAX                   192000
 #define USBD_AUDIO_BIT_DEPTH_DEFAULT 			24
 
 /* Memory management macros */   
@@ -68,6 +72,7 @@
 #define USBD_free                 free
 #define USBD_memset               memset
 #define USBD_memcpy               memcpy
+#define USBD_memmove              memmove
     
 /* DEBUG macros */  
 #if (USBD_DEBUG_LEVEL > 0)
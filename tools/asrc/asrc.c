@@ -0,0 +1,250 @@
+/**
+  ******************************************************************************
+  * @file    asrc.c
+  * @brief   Host tool : generate the ASRC coefficient table and test the
+  *          firmware resampler (drivers/usb/Class/AUDIO/Src/usbd_audio_asrc.c)
+  ******************************************************************************
+  *
+  * Build and run on the host, see tools/asrc/Makefile :
+  *   make            build the tool and run the tests
+  *   make header     regenerate drivers/usb/Class/AUDIO/Inc/usbd_audio_asrc_coef.h
+  *
+  * Coefficients : windowed sinc interpolator, Kaiser window, cutoff ASRC_CUTOFF * Fs/2.
+  * Row p holds the taps for the output position fraction p / AUDIO_ASRC_PHASES, the extra
+  * last row is row 0 shifted by one frame for the interpolation between phases.
+  * Each row is normalised to unity DC gain, so the gain does not depend on the phase.
+  *
+  * Tests : a sine is packetised like the USB stream (44.1kHz packet size pattern), converted
+  * to I2S words, resampled with AUDIO_ASRC_Reserve / AUDIO_ASRC_Process into a ring buffer,
+  * and every output frame is compared with the exact input sine at the output position.
+  * THD+N is the error power against the signal power, it includes the 24bit output rounding.
+  * The drift tests change the ratio every packet, as the fill level controller does.
+ * The fixed clock tests upsample to the USE_FIXED_CLOCK I2S rate.
+  * The tool exits with an error if a limit is exceeded or the table is stale.
+  */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "usbd_audio_asrc.h"
+
+#define ASRC_CUTOFF         1.0     // x Fs/2, phase 0 is the identity
+#define ASRC_KAISER_BETA    12.0
+
+static double Coef[AUDIO_ASRC_PHASES + 1][AUDIO_ASRC_TAPS];
+
+static double bessel_i0(double x) {
+	double sum = 1.0, term = 1.0;
+	for (int k = 1; k < 50; k++) {
+		term *= (x / (2.0 * k)) * (x / (2.0 * k));
+		sum += term;
+		}
+	return sum;
+	}
+
+// interpolation kernel at u input frames from the output position, support [-TAPS/2, TAPS/2]
+static double kernel(double u) {
+	double half = AUDIO_ASRC_TAPS / 2.0;
+	double r = u / half;
+	if (r <= -1.0 || r >= 1.0) return 0.0;
+	double w = bessel_i0(ASRC_KAISER_BETA * sqrt(1.0 - r * r)) / bessel_i0(ASRC_KAISER_BETA);
+	double a = M_PI * ASRC_CUTOFF * u;
+	double s = (fabs(a) < 1e-12) ? 1.0 : sin(a) / a;
+	return ASRC_CUTOFF * s * w;
+	}
+
+static void design(void) {
+	for (uint32_t p = 0; p <= AUDIO_ASRC_PHASES; p++) {
+		double sum = 0.0;
+		for (uint32_t k = 0; k < AUDIO_ASRC_TAPS; k++) {
+			// tap k is input frame i - (TAPS/2 - 1) + k, the output is at i + p/PHASES
+			Coef[p][k] = kernel((double)p / AUDIO_ASRC_PHASES + AUDIO_ASRC_TAPS / 2.0 - 1.0 - k);
+			sum += Coef[p][k];
+			}
+		for (uint32_t k = 0; k < AUDIO_ASRC_TAPS; k++) {
+			Coef[p][k] /= sum;
+			}
+		}
+	}
+
+static int32_t q30(double c) {
+	return (int32_t)lrint(c * (double)(1 << 30));
+	}
+
+static int write_header(const char* path) {
+	FILE* fp = fopen(path, "wb");
+	if (fp == NULL) {
+		perror(path);
+		return 1;
+		}
+	fprintf(fp, "// Generated by tools/asrc, do not edit. Included by usbd_audio_asrc.c only.\r\n");
+	fprintf(fp, "// Windowed sinc interpolator, Kaiser beta %.1f, cutoff %.2f x Fs/2, Q30.\r\n", ASRC_KAISER_BETA, ASRC_CUTOFF);
+	fprintf(fp, "// Row p : output position fraction p/%u, the last row is row 0 shifted by one frame.\r\n\r\n", AUDIO_ASRC_PHASES);
+	fprintf(fp, "#ifndef __USBD_AUDIO_ASRC_COEF_H\r\n#define __USBD_AUDIO_ASRC_COEF_H\r\n\r\n");
+	fprintf(fp, "#if (AUDIO_ASRC_TAPS != %u) || (AUDIO_ASRC_PHASES != %u)\r\n", AUDIO_ASRC_TAPS, AUDIO_ASRC_PHASES);
+	fprintf(fp, "#error \"ASRC coefficient table does not match usbd_audio_asrc.h\"\r\n#endif\r\n\r\n");
+	fprintf(fp, "static const int32_t AUDIO_ASRC_Coef[AUDIO_ASRC_PHASES + 1][AUDIO_ASRC_TAPS] = {\r\n");
+	for (uint32_t p = 0; p <= AUDIO_ASRC_PHASES; p++) {
+		fprintf(fp, "{");
+		for (uint32_t k = 0; k < AUDIO_ASRC_TAPS; k++) {
+			fprintf(fp, "%s%s%d", k ? "," : "", (k % 8U) == 0U && k ? "\r\n " : "", q30(Coef[p][k]));
+			}
+		fprintf(fp, "}%s\r\n", p < AUDIO_ASRC_PHASES ? "," : "");
+		}
+	fprintf(fp, "};\r\n\r\n#endif /* __USBD_AUDIO_ASRC_COEF_H */\r\n");
+	fclose(fp);
+	return 0;
+	}
+
+#ifndef ASRC_GEN_ONLY
+
+#include "usbd_audio_asrc_coef.h"
+
+#define RING_SIZE   4096U   // words
+
+typedef struct {
+	const char* name;
+	uint32_t fs;
+	uint32_t out_fs;    // fixed I2S rate for USE_FIXED_CLOCK, 0 : same as fs
+	double   f;         // tone Hz
+	double   ppm;       // step / nominal step - 1
+	double   drift_ppm; // ratio swing, changed every packet
+	double   drift_hz;  // ratio swing rate
+	double   limit_db;  // THD+N
+	} SCENARIO;
+
+static const SCENARIO Scenarios[] = {
+	{"48k 1kHz",                   48000,      0,  1000.0,     0.0,    0.0, 0.0, -130.0},
+	{"48k 1kHz +100ppm",           48000,      0,  1000.0,   100.0,    0.0, 0.0, -120.0},
+	{"44.1k 1kHz -100ppm",         44100,      0,  1000.0,  -100.0,    0.0, 0.0, -120.0},
+	{"48k 10kHz +100ppm",          48000,      0, 10000.0,   100.0,    0.0, 0.0, -105.0},
+	{"48k 18kHz +100ppm",          48000,      0, 18000.0,   100.0,    0.0, 0.0,  -95.0},
+	{"96k 1kHz -1000ppm",          96000,      0,  1000.0, -1000.0,    0.0, 0.0, -120.0},
+	{"96k 20kHz +1000ppm",         96000,      0, 20000.0,  1000.0,    0.0, 0.0, -105.0},
+	{"192k 1kHz +20000ppm",       192000,      0,  1000.0, 20000.0,    0.0, 0.0, -125.0},
+	{"48k 1kHz drift 500ppm",      48000,      0,  1000.0,     0.0,  500.0, 1.0, -120.0},
+	{"44.1k 10kHz drift 500ppm",   44100,      0, 10000.0,     0.0,  500.0, 3.0, -105.0},
+	{"44.1k to 96k 1kHz",          44100,  96000,  1000.0,     0.0,    0.0, 0.0, -120.0},
+	{"48k to 96k 10kHz +100ppm",   48000,  96000, 10000.0,   100.0,    0.0, 0.0, -105.0},
+	{"32k to 96k drift 500ppm",    32000,  96000,  1000.0,     0.0,  500.0, 1.0, -120.0},
+	{"88.2k to 96k 20kHz",         88200,  96000, 20000.0,     0.0,    0.0, 0.0, -105.0},
+	};
+#define SCENARIO_NUM  (sizeof(Scenarios)/sizeof(Scenarios[0]))
+
+static AUDIO_ASRC_TypeDef Asrc;
+static uint32_t Ring[RING_SIZE];
+
+static uint32_t i2s_word(int32_t s) {
+	return ((uint32_t)s >> 16) | ((uint32_t)s << 16);
+	}
+
+static int32_t i2s_sample(uint32_t w) {
+	return (int32_t)((w >> 16) | (w << 16));
+	}
+
+// returns THD+N in dB, -1000 on a bookkeeping error
+static double run(const SCENARIO* sc) {
+	const double amp = 0.891 * 2147483648.0; // -1dBFS
+	const double w = 2.0 * M_PI * sc->f / sc->fs;
+	const uint32_t seconds = 2;
+	double err2 = 0.0, sig2 = 0.0;
+	uint64_t in_total = 0;    // global index of the first frame of the packet
+	uint32_t pos = 0;
+	double t_exp = AUDIO_ASRC_TAPS / 2.0; // expected output position, independent of the Q32 arithmetic
+
+	AUDIO_ASRC_Init(&Asrc);
+	AUDIO_ASRC_SetRatio(&Asrc, sc->fs, sc->out_fs ? sc->out_fs : sc->fs);
+	for (uint32_t pkt = 0; pkt < seconds * 1000U; pkt++) {
+		double ppm = sc->ppm + sc->drift_ppm * sin(2.0 * M_PI * sc->drift_hz * pkt / 1000.0);
+		uint64_t step = (uint64_t)llround((1.0 + ppm * 1e-6) * (double)Asrc.step_nom);
+		AUDIO_ASRC_SetStep(&Asrc, step);
+		step = Asrc.step;
+
+		// USB packet sizes : 44.1kHz is 9 packets of 44 frames and one of 45
+		uint32_t frames = (uint32_t)(((uint64_t)(pkt + 1U) * sc->fs) / 1000U - ((uint64_t)pkt * sc->fs) / 1000U);
+		uint32_t* in = AUDIO_ASRC_Input(&Asrc);
+		for (uint32_t n = 0; n < frames; n++) {
+			double v = amp * sin(w * (double)(in_total + n));
+			int32_t s = (int32_t)((uint32_t)(int32_t)lrint(v) & 0xFFFFFF00U);
+			in[2U*n] = i2s_word(s);
+			in[2U*n + 1U] = i2s_word(-s);
+			}
+
+		uint64_t t;
+		uint32_t out_frames = AUDIO_ASRC_Reserve(&Asrc, frames, &t);
+		if (fabs((double)t / 4294967296.0 - t_exp) > 1e-6) {
+			printf("%s : packet %u output position %.6f, expected %.6f\n", sc->name, pkt, (double)t / 4294967296.0, t_exp);
+			return -1000.0;
+			}
+		AUDIO_ASRC_Process(&Asrc, Ring, pos, RING_SIZE, frames, out_frames, t, step);
+
+		// x[0] is global input frame in_total - TAPS
+		for (uint32_t j = 0; j < out_frames; j++) {
+			double tau = (double)in_total - AUDIO_ASRC_TAPS + (double)(t + j * step) / 4294967296.0;
+			int32_t l = i2s_sample(Ring[pos]);
+			int32_t r = i2s_sample(Ring[pos + 1U]);
+			pos = (pos + 2U) % RING_SIZE;
+			if (tau < AUDIO_ASRC_TAPS) continue; // zero history
+			double ref = amp * sin(w * tau);
+			err2 += (l - ref) * (l - ref) + (r + ref) * (r + ref);
+			sig2 += 2.0 * ref * ref;
+			}
+		t_exp += out_frames * ((double)step / 4294967296.0) - frames;
+		if (t_exp < AUDIO_ASRC_TAPS / 2.0 - 1e-6 || t_exp >= AUDIO_ASRC_TAPS / 2.0 + (double)step / 4294967296.0 + 1e-6) {
+			printf("%s : packet %u output position %.6f out of range\n", sc->name, pkt, t_exp);
+			return -1000.0;
+			}
+		in_total += frames;
+		}
+	return 10.0 * log10(err2 / sig2);
+	}
+
+static int check_table(void) {
+	int stale = 0;
+	for (uint32_t p = 0; p <= AUDIO_ASRC_PHASES; p++) {
+		for (uint32_t k = 0; k < AUDIO_ASRC_TAPS; k++) {
+			if (AUDIO_ASRC_Coef[p][k] != q30(Coef[p][k])) stale = 1;
+			}
+		}
+	if (stale) {
+		printf("usbd_audio_asrc_coef.h does not match the filter design, run make header\n");
+		}
+	return stale;
+	}
+
+#endif
+
+int main(int argc, char** argv) {
+	const char* header = NULL;
+	for (int i = 1; i < argc; i++) {
+		if (!strcmp(argv[i], "-o") && i + 1 < argc) header = argv[++i];
+		else {
+			fprintf(stderr, "usage : %s [-o coef_header]\n", argv[0]);
+			return 1;
+			}
+		}
+
+	design();
+	if (header != NULL) {
+		return write_header(header);
+		}
+
+#ifdef ASRC_GEN_ONLY
+	return 0;
+#else
+	int fail = check_table();
+	printf("ASRC %u taps, %u phases, cutoff %.2f, beta %.1f\n", AUDIO_ASRC_TAPS, AUDIO_ASRC_PHASES, ASRC_CUTOFF, ASRC_KAISER_BETA);
+	printf("scenario                        THD+N     limit\n");
+	for (uint32_t i = 0; i < SCENARIO_NUM; i++) {
+		const SCENARIO* sc = &Scenarios[i];
+		double db = run(sc);
+		int ok = db <= sc->limit_db;
+		printf("%-28s %9.1fdB %7.1fdB  %s\n", sc->name, db, sc->limit_db, ok ? "ok" : "FAIL");
+		if (!ok) fail = 1;
+		}
+	return fail;
+#endif
+	}
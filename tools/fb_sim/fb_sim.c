@@ -0,0 +1,313 @@
+/**
+  ******************************************************************************
+  * @file    fb_sim.c
+  * @brief   Host tool : closed loop simulation of the feedback endpoint controller
+  ******************************************************************************
+  *
+  * Build and run on the host, see tools/fb_sim/Makefile :
+  *   make              build and run the regression scenarios
+  *   ./fb_sim -l       list the scenarios
+  *   ./fb_sim -s N -t  run scenario N and print a trace (ms, fill error, feedback Hz)
+  *   ./fb_sim -c p     use the previous proportional-only controller
+  *   ./fb_sim -q       read pointer quantised to words (NDTR only)
+  *
+  * The controller in drivers/usb/Class/AUDIO/Src/usbd_audio_fb.c is compiled in unchanged,
+  * the gains come from src/usbd_audio_fb_conf.h and can be overridden with
+  * make CFLAGS_TUNE="-DAUDIO_FB_KP=... -DAUDIO_FB_KI=..."
+  *
+  * Model, time step is the 1ms USB frame (SOF) :
+  *   - Device : I2S consumes Fs_dev/1000 frames per USB frame, Fs_dev is the nominal PLL Fs
+  *     with a crystal error relative to the host clock (ppm, optionally ramping).
+  *     The read pointer has the 1/256 word resolution of BSP_AUDIO_OUT_GetPlayPosition, or with -q
+  *     is quantised to 32bit words like the NDTR based BSP_AUDIO_OUT_GetRemainingDataSize.
+  *   - Host : sends one packet per frame, packet size from a fractional accumulator at the
+  *     rate given by the last feedback value it read. The host reads the feedback endpoint
+  *     every 2^bRefresh ms with a latency, optionally smoothing it. Before the first read it
+  *     uses the nominal Fs. Optional bursts : an empty packet followed by a double one.
+  *   - Packets arrive at a random time in the frame (jitter), the fill level is sampled at SOF.
+  *     The controller runs once per refresh period, latency ms before the host reads it.
+  *   - Built with -DUSE_FB_TIMER (make runs both builds) : a 96MHz timer with the device crystal
+  *     error is captured at every SOF and AUDIO_FB_Measure updates the nominal feedback.
+  *     The convergence limits are doubled for the slower fill level trim.
+  *
+  * Reported per scenario, over the last quarter of the run unless noted :
+  *   converge    time after which the 32ms averaged fill error stays within the scenario peak limit
+  *   fill mean   mean fill error (frames), max |fill| is the largest averaged fill error
+  *   fb std/pp   feedback standard deviation and peak to peak (Hz)
+  *   xrun        buffer underruns + overruns over the whole run
+  * The tool exits with an error if a scenario exceeds its limits.
+  */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "usbd_audio_fb.h"
+
+#define FB_ONE_KHZ          (double)(1 << 22)
+#define BUF_FRAMES          1552    // default latency profile (8 packets) at 96kHz
+#define PACKET_FRAMES_MAX   193     // AUDIO_OUT_PACKET_FRAMES_MAX
+#define AVG_MS              32
+#define TICK_KHZ            96000   // SOF timer clock, F411
+
+typedef struct {
+	const char* name;
+	double   fs;            // host nominal Fs, Hz
+	double   fs_pll;        // device nominal PLL Fs, Hz (nominal feedback)
+	double   ppm;           // device crystal error relative to the host clock
+	double   ppm_ramp;      // ppm change per second
+	int      refresh;       // bRefresh, host reads the feedback every 2^refresh ms
+	int      latency;       // feedback read latency, ms
+	double   smooth;        // host feedback smoothing factor, 0 = none
+	double   jitter;        // packet arrival jitter, fraction of a frame
+	double   burst;         // probability of an empty packet followed by a double one
+	double   fill0;         // initial fill error, frames
+	int      run_ms;
+	// limits
+	double   converge_max;  // ms
+	double   mean_max;      // frames, mean fill error
+	double   peak_max;      // frames, 32ms averaged fill error, also the convergence limit
+	double   fb_std_max;    // Hz
+	} SCENARIO;
+
+static const SCENARIO Scenarios[] = {
+	// name                           fs      fs_pll      ppm   ramp ref lat smooth jit  burst fill0  run    conv  mean peak  std
+	{"48k, +100ppm",                48000,  48000.0,    100,    0, 2, 2, 0.0,  0.5, 0.0,     0, 60000,  5000, 0.5, 1.0, 1.0},
+	{"44.1k, -100ppm",              44100,  44099.5066, -100,   0, 2, 2, 0.0,  0.5, 0.0,     0, 60000,  5000, 0.5, 1.0, 1.0},
+	{"96k F401 PLL +151ppm",        96000,  96014.4928, 0,      0, 2, 2, 0.0,  0.5, 0.0,     0, 60000,  5000, 0.5, 1.0, 1.0},
+	{"96k F401 PLL, -250ppm xtal",  96000,  96014.4928, -250,   0, 2, 2, 0.0,  0.5, 0.0,     0, 60000,  8000, 0.5, 1.0, 1.0},
+	{"192k, +50ppm",               192000, 191990.8588, 50,     0, 2, 2, 0.0,  0.5, 0.0,     0, 60000,  5000, 0.5, 1.0, 1.5},
+	{"48k, drift ramp 5ppm/s",      48000,  48000.0,    0,      5, 2, 2, 0.0,  0.5, 0.0,     0, 60000, 10000, 0.5, 1.0, 2.0},
+	{"44.1k, jitter and bursts",    44100,  44099.5066, 100,    0, 2, 2, 0.0,  0.9, 0.02,    0, 60000, 20000, 0.5, 10.0, 4.0},
+	{"96k, fill error -300",        96000,  95996.7320, 0,      0, 2, 2, 0.0,  0.5, 0.0,  -300, 60000, 10000, 0.5, 1.0, 1.0},
+	{"96k, slow host, smoothing",   96000,  95996.7320, 200,    0, 5, 8, 0.1,  0.5, 0.0,     0, 60000, 10000, 0.5, 1.0, 1.0},
+	};
+#define SCENARIO_NUM  (sizeof(Scenarios)/sizeof(Scenarios[0]))
+
+typedef struct {
+	double converge_ms;
+	double fill_mean;
+	double fill_max;
+	double fb_std;
+	double fb_pp;
+	int    xruns;
+	} RESULT;
+
+typedef enum { CTRL_PI = 0, CTRL_P } CTRL;
+
+static int rd_quantised = 0;
+
+#ifdef USE_FB_TIMER
+static const int tick_measured = 1;
+#else
+static const int tick_measured = 0;
+#endif
+
+// previous controller in USBD_AUDIO_SOF, proportional only, on the writable frames
+static uint32_t fb_legacy(uint32_t fb_nom, uint32_t writable_frames) {
+	int32_t dev = (int32_t)writable_frames - BUF_FRAMES/2;
+	uint64_t tmp = (uint64_t)((int32_t)(1<<22) + (dev * 256));
+	uint32_t fb = (uint32_t)((((uint64_t)fb_nom) * tmp) >> 22);
+	if (fb > fb_nom + AUDIO_FB_DELTA_MAX) fb = fb_nom + AUDIO_FB_DELTA_MAX;
+	else if (fb < fb_nom - AUDIO_FB_DELTA_MAX) fb = fb_nom - AUDIO_FB_DELTA_MAX;
+	return fb;
+	}
+
+static double urand(void) {
+	return (double)rand() / ((double)RAND_MAX + 1.0);
+	}
+
+static void simulate(const SCENARIO* sc, CTRL ctrl, FILE* trace, RESULT* res) {
+	AUDIO_FB_TypeDef fbc;
+	uint32_t fb_nom = (uint32_t)llround(sc->fs_pll / 1000.0 * FB_ONE_KHZ);
+	uint32_t fb_hist[64];
+	double   rd = 0.0;                      // frames read by the I2S DMA
+	double   wr = BUF_FRAMES / 2 - sc->fill0; // frames received
+	double   host_rate = sc->fs / 1000.0;   // frames per USB frame
+	double   host_acc = 0.0;
+	int      carry = 0;                     // frames held back by a burst
+	double   pend_t[8]; int pend_n[8]; int npend = 0;
+	double   last_arrival = 0.0;
+	double   err_avg[AVG_MS] = {0};
+	double   err_sum = 0.0;
+	int      tail_ms = sc->run_ms / 4, tail_start = sc->run_ms - tail_ms;
+	double   fb_sum = 0.0, fb_sq = 0.0, fb_min = 1e30, fb_max = -1e30, fill_sum = 0.0, fill_max = 0.0;
+	int      last_out = -1;
+	double   tick = 1e9;                    // SOF timer count, arbitrary start
+	uint32_t tick_khz = 0;
+#ifdef USE_FB_TIMER
+	tick_khz = TICK_KHZ;
+#endif
+
+	srand(12345);
+	memset(res, 0, sizeof(*res));
+	AUDIO_FB_Init(&fbc, fb_nom, BUF_FRAMES / 2, tick_khz);
+	for (int i = 0; i < 64; i++) fb_hist[i] = fb_nom;
+
+	for (int ms = 0; ms < sc->run_ms; ms++) {
+		// packets that arrived before this SOF
+		while (npend && pend_t[0] <= ms) {
+			wr += pend_n[0];
+			memmove(pend_t, pend_t + 1, (npend - 1) * sizeof(double));
+			memmove(pend_n, pend_n + 1, (npend - 1) * sizeof(int));
+			npend--;
+			}
+
+		// device : sample the fill level at SOF, read pointer in words
+		double fill = wr - rd;
+		if (fill < 0.0 || fill > BUF_FRAMES) {
+			res->xruns++;
+			// resync at half buffer like a stream restart
+			wr = rd + BUF_FRAMES / 2;
+			fill = BUF_FRAMES / 2;
+			}
+		double ppm = sc->ppm + sc->ppm_ramp * ms / 1000.0;
+		int64_t rd_q8 = rd_quantised ? (int64_t)floor(rd * 2.0) * 256 : (int64_t)floor(rd * 512.0);
+		int64_t wr_q8 = (int64_t)llround(wr * 2.0) * 256;
+		uint32_t writable_q8 = (uint32_t)(2 * BUF_FRAMES * 256 - (wr_q8 - rd_q8));
+		uint32_t fb;
+		if (ctrl == CTRL_PI) {
+			AUDIO_FB_Sample(&fbc, writable_q8);
+			if (((ms + sc->latency) & ((1 << sc->refresh) - 1)) == 0) {
+				AUDIO_FB_Measure(&fbc, (uint32_t)(uint64_t)floor(tick), (uint32_t)ms);
+				AUDIO_FB_Update(&fbc);
+				}
+			fb = fbc.fb;
+			}
+		else {
+			fb = fb_legacy(fb_nom, writable_q8 >> 9);
+			}
+		fb_hist[ms & 63] = fb;
+
+		// host : read the feedback every 2^bRefresh ms
+		if ((ms & ((1 << sc->refresh) - 1)) == 0 && ms >= sc->latency) {
+			double rate = fb_hist[(ms - sc->latency) & 63] / FB_ONE_KHZ;
+			host_rate = (sc->smooth > 0.0) ? host_rate + sc->smooth * (rate - host_rate) : rate;
+			}
+
+		// host : packet for this frame
+		host_acc += host_rate;
+		int n = (int)host_acc;
+		host_acc -= n;
+		n += carry;
+		carry = 0;
+		if (sc->burst > 0.0 && urand() < sc->burst) {
+			carry = n;
+			n = 0;
+			}
+		if (n > PACKET_FRAMES_MAX) {
+			carry += n - PACKET_FRAMES_MAX;
+			n = PACKET_FRAMES_MAX;
+			}
+		double t = ms + 0.05 + sc->jitter * urand();
+		if (t < last_arrival) t = last_arrival;
+		last_arrival = t;
+		if (npend < 8) {
+			pend_t[npend] = t;
+			pend_n[npend] = n;
+			npend++;
+			}
+
+		// device : I2S consumption and timer ticks during this frame
+		rd += sc->fs_pll * (1.0 + ppm * 1e-6) / 1000.0;
+		tick += TICK_KHZ * (1.0 + ppm * 1e-6);
+
+		// statistics, fill error positive when the buffer holds more than the setpoint
+		double err = fill - BUF_FRAMES / 2;
+		err_sum += err - err_avg[ms % AVG_MS];
+		err_avg[ms % AVG_MS] = err;
+		double avg = err_sum / AVG_MS;
+		double fb_hz = fb / FB_ONE_KHZ * 1000.0;
+		if (ms >= AVG_MS && fabs(avg) > sc->peak_max) {
+			last_out = ms;
+			}
+		if (ms >= tail_start) {
+			fb_sum += fb_hz;
+			fb_sq += fb_hz * fb_hz;
+			if (fb_hz < fb_min) fb_min = fb_hz;
+			if (fb_hz > fb_max) fb_max = fb_hz;
+			fill_sum += err;
+			if (fabs(avg) > fill_max) fill_max = fabs(avg);
+			}
+		if (trace) {
+			fprintf(trace, "%d %.3f %.3f %.4f\n", ms, err, avg, fb_hz);
+			}
+		}
+
+	res->converge_ms = (last_out < 0) ? 0.0 : last_out + 1.0;
+	if (last_out >= tail_start) {
+		res->converge_ms = -1.0; // not converged
+		}
+	res->fill_mean = fill_sum / tail_ms;
+	res->fill_max = fill_max;
+	double mean = fb_sum / tail_ms;
+	double var = fb_sq / tail_ms - mean * mean;
+	res->fb_std = var > 0.0 ? sqrt(var) : 0.0;
+	res->fb_pp = fb_max - fb_min;
+	}
+
+static int check(const SCENARIO* sc, const RESULT* r) {
+	// with measured Fs the fill level trim is slower by design
+	double converge_max = tick_measured ? 2.0 * sc->converge_max : sc->converge_max;
+	return (r->converge_ms >= 0.0) && (r->converge_ms <= converge_max) &&
+		(fabs(r->fill_mean) <= sc->mean_max) && (r->fill_max <= sc->peak_max) &&
+		(r->fb_std <= sc->fb_std_max) && (r->xruns == 0);
+	}
+
+int main(int argc, char* argv[]) {
+	int sel = -1, do_trace = 0, list = 0;
+	CTRL ctrl = CTRL_PI;
+
+	for (int i = 1; i < argc; i++) {
+		if (strcmp(argv[i], "-s") == 0 && i + 1 < argc) sel = atoi(argv[++i]);
+		else if (strcmp(argv[i], "-t") == 0) do_trace = 1;
+		else if (strcmp(argv[i], "-l") == 0) list = 1;
+		else if (strcmp(argv[i], "-q") == 0) rd_quantised = 1;
+		else if (strcmp(argv[i], "-c") == 0 && i + 1 < argc) {
+			i++;
+			ctrl = (strcmp(argv[i], "p") == 0) ? CTRL_P : CTRL_PI;
+			}
+		else {
+			fprintf(stderr, "usage : %s [-l] [-s scenario] [-t] [-c pi|p] [-q]\n", argv[0]);
+			return 1;
+			}
+		}
+	if (list) {
+		for (unsigned s = 0; s < SCENARIO_NUM; s++) printf("%u : %s\n", s, Scenarios[s].name);
+		return 0;
+		}
+	if (sel >= (int)SCENARIO_NUM) {
+		fprintf(stderr, "no scenario %d\n", sel);
+		return 1;
+		}
+	if (do_trace && sel < 0) {
+		fprintf(stderr, "-t needs -s\n");
+		return 1;
+		}
+
+	int failed = 0;
+	if (!do_trace) {
+		printf("controller %s%s, KP %d KI %d LPF_SHIFT %d\n", ctrl == CTRL_PI ? "PI" : "P (previous)",
+			(ctrl == CTRL_PI && tick_measured) ? " with measured Fs" : "", AUDIO_FB_KP, AUDIO_FB_KI, AUDIO_FB_LPF_SHIFT);
+		printf("%-30s %9s %9s %9s %8s %8s %5s\n", "scenario", "converge", "fill mean", "max |fill|", "fb std", "fb pp", "xrun");
+		}
+	for (unsigned s = 0; s < SCENARIO_NUM; s++) {
+		if (sel >= 0 && (unsigned)sel != s) continue;
+		RESULT r;
+		simulate(&Scenarios[s], ctrl, do_trace ? stdout : NULL, &r);
+		if (do_trace) continue;
+		int ok = check(&Scenarios[s], &r);
+		char conv[16];
+		if (r.converge_ms < 0.0) snprintf(conv, sizeof(conv), "never");
+		else snprintf(conv, sizeof(conv), "%.0fms", r.converge_ms);
+		printf("%-30s %9s %9.2f %9.2f %7.3fHz %6.2fHz %5d  %s\n", Scenarios[s].name, conv,
+			r.fill_mean, r.fill_max, r.fb_std, r.fb_pp, r.xruns, ok ? "ok" : "FAIL");
+		failed += !ok;
+		}
+	if (failed) {
+		printf("%d scenarios failed\n", failed);
+		}
+	return failed ? 1 : 0;
+	}
@@ -0,0 +1,239 @@
+/**
+  ******************************************************************************
+  * @file    i2s_pll.c
+  * @brief   Host tool : search the PLLI2S and I2S prescaler settings with the
+  *          smallest sampling frequency error, and generate bsp_audio_clk.h
+  ******************************************************************************
+  *
+  * Build and run on the host, see tools/i2s_pll/Makefile :
+  *   make            build the tool
+  *   make header     regenerate drivers/BSP/bsp_audio_clk.h
+  *
+  * I2S clock tree, HSE = 25MHz
+  *   VCO input  = HSE / M              1 .. 2MHz
+  *   VCO output = VCO input * N        100 .. 432MHz, N = 50 .. 432
+  *   I2SCLK     = VCO output / R       R = 2 .. 7
+  *   Fs         = I2SCLK / (256 * (2*I2SDIV + ODD))   with MCLK output
+  *   Fs         = I2SCLK / (64 * (2*I2SDIV + ODD))    without, 24bit data in 32bit channel frames
+  *
+  * The F401 PLLI2S shares the main PLL input divider, M is fixed at 25 (see SystemClock_Config).
+  * The F411 PLLI2S has its own input divider.
+  *
+  * HAL_I2S_Init recomputes I2SDIV and ODD from the PLLI2S output frequency, so only settings
+  * where the HAL rounding gives the same prescaler are accepted.
+  *
+  * Every generated entry is checked against the closed-form Fs formula, and the feedback word
+  * against the exact rational value. The tool exits with an error if any check fails.
+  */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#define HSE_HZ              25000000ULL
+#define VCO_IN_MIN          1000000ULL
+#define VCO_IN_MAX          2000000ULL
+#define VCO_OUT_MIN         100000000ULL
+#define VCO_OUT_MAX         432000000ULL
+#define I2SCLK_MAX          216000000ULL
+#define PLLI2S_N_MIN        50
+#define PLLI2S_N_MAX        432
+#define PLLI2S_R_MIN        2
+#define PLLI2S_R_MAX        7
+#define PLLI2S_M_MAX        63
+#define PLLM_F401           25
+#define I2SDIV_MIN          2
+#define I2SDIV_MAX          255
+
+// Sampling frequencies, same order as I2SFreq
+static const uint32_t FreqTable[] = {32000, 44100, 48000, 88200, 96000, 176400, 192000};
+#define FREQ_NUM            (sizeof(FreqTable)/sizeof(FreqTable[0]))
+#define FREQ_INDEX_DEFAULT  4 // 96000Hz
+
+typedef struct {
+	const char* name;
+	const char* condition;  // preprocessor condition selecting the table, NULL for the default
+	int fixed_m;            // 0 : search PLLI2SM
+	int mclk;               // 1 : MCLK output enabled, Fs = I2SCLK / 256 / div
+	} TARGET;
+
+static const TARGET Targets[] = {
+	{"STM32F411 with MCLK output", "defined(STM32F411xE) && defined(USE_MCLK_OUT)", 0, 1},
+	{"STM32F411", "defined(STM32F411xE)", 0, 0},
+	{"STM32F401", NULL, PLLM_F401, 0},
+	};
+#define TARGET_NUM  (sizeof(Targets)/sizeof(Targets[0]))
+
+typedef struct {
+	uint32_t M, N, R, I2SDIV, ODD;
+	uint32_t fdbk;      // Fs in kHz, 10.14 format shifted left by 8 bits
+	double fs;          // actual sampling frequency in Hz
+	double ppm;
+	} CLK_CONFIG;
+
+// Prescaler (2*I2SDIV + ODD) computed by HAL_I2S_Init, in integer arithmetic
+static uint32_t hal_prescaler(uint32_t m, uint32_t n, uint32_t r, uint32_t fs, int mclk) {
+	uint32_t i2sclk = (uint32_t)(HSE_HZ / m) * n / r;
+	uint32_t tmp;
+	if (mclk) {
+		tmp = (((i2sclk / (64U * 4U)) * 10U) / fs) + 5U;
+		}
+	else {
+		tmp = (((i2sclk / 64U) * 10U) / fs) + 5U;
+		}
+	return tmp / 10U;
+	}
+
+// Exact sampling frequency in Hz : HSE * N / (M * R * (2*I2SDIV + ODD) * (256 or 64))
+static double clk_fs(const CLK_CONFIG* c, int mclk) {
+	return (double)HSE_HZ * c->N / ((double)c->M * c->R * (2 * c->I2SDIV + c->ODD) * (mclk ? 256 : 64));
+	}
+
+// Feedback word Fs/1000 * 2^22, rounded, computed from the exact rational value
+static uint32_t clk_fdbk(const CLK_CONFIG* c, int mclk) {
+	uint64_t num = HSE_HZ * c->N << 22;
+	uint64_t den = (uint64_t)c->M * c->R * (2 * c->I2SDIV + c->ODD) * (mclk ? 256 : 64) * 1000;
+	return (uint32_t)((num + den / 2) / den);
+	}
+
+// Lowest absolute ppm error, then highest VCO input frequency (less jitter), then lowest VCO frequency
+static int clk_better(const CLK_CONFIG* a, const CLK_CONFIG* b) {
+	double ea = fabs(a->ppm), eb = fabs(b->ppm);
+	if (ea < eb - 1e-9) return 1;
+	if (ea > eb + 1e-9) return 0;
+	if (a->M != b->M) return a->M < b->M;
+	return (uint64_t)a->N * b->M < (uint64_t)b->N * a->M;
+	}
+
+static int clk_search(const TARGET* t, uint32_t fs, CLK_CONFIG* best) {
+	int found = 0;
+	uint32_t m_min = t->fixed_m ? t->fixed_m : 2;
+	uint32_t m_max = t->fixed_m ? t->fixed_m : PLLI2S_M_MAX;
+	for (uint32_t m = m_min; m <= m_max; m++) {
+		uint64_t vco_in = HSE_HZ / m;
+		if (vco_in < VCO_IN_MIN || vco_in > VCO_IN_MAX) continue;
+		for (uint32_t n = PLLI2S_N_MIN; n <= PLLI2S_N_MAX; n++) {
+			uint64_t vco_out = vco_in * n;
+			if (vco_out < VCO_OUT_MIN || vco_out > VCO_OUT_MAX) continue;
+			for (uint32_t r = PLLI2S_R_MIN; r <= PLLI2S_R_MAX; r++) {
+				if (vco_out / r > I2SCLK_MAX) continue;
+				// the best prescaler for this I2SCLK is the rounded one, which is also what the HAL uses
+				uint32_t div = hal_prescaler(m, n, r, fs, t->mclk);
+				CLK_CONFIG c = {m, n, r, div / 2, div & 1, 0, 0.0, 0.0};
+				if (c.I2SDIV < I2SDIV_MIN || c.I2SDIV > I2SDIV_MAX) continue;
+				c.fs = clk_fs(&c, t->mclk);
+				c.ppm = (c.fs - fs) / fs * 1e6;
+				c.fdbk = clk_fdbk(&c, t->mclk);
+				if (!found || clk_better(&c, best)) {
+					*best = c;
+					found = 1;
+					}
+				}
+			}
+		}
+	return found;
+	}
+
+// Verify an entry against the closed-form formula and the hardware limits
+static int clk_check(const TARGET* t, uint32_t fs, const CLK_CONFIG* c) {
+	int err = 0;
+	uint64_t vco_in = HSE_HZ / c->M;
+	uint64_t vco_out = vco_in * c->N;
+	uint32_t div = 2 * c->I2SDIV + c->ODD;
+	double fs_formula = (double)HSE_HZ / c->M * c->N / c->R / div / (t->mclk ? 256.0 : 64.0);
+	double fdbk_formula = fs_formula / 1000.0 * (double)(1 << 22);
+
+	if (vco_in < VCO_IN_MIN || vco_in > VCO_IN_MAX) err |= 1;
+	if (vco_out < VCO_OUT_MIN || vco_out > VCO_OUT_MAX) err |= 2;
+	if (vco_out / c->R > I2SCLK_MAX) err |= 4;
+	if (c->I2SDIV < I2SDIV_MIN || c->I2SDIV > I2SDIV_MAX || c->ODD > 1) err |= 8;
+	if (hal_prescaler(c->M, c->N, c->R, fs, t->mclk) != div) err |= 16;
+	if (fabs(fs_formula - c->fs) > 1e-6) err |= 32;
+	if (fabs(fdbk_formula - c->fdbk) > 0.5) err |= 64;
+	// feedback word must fit the 3 byte 10.14 format
+	if (c->fdbk >> 8 > 0xFFFFFFU) err |= 128;
+	if (err) {
+		fprintf(stderr, "%s %uHz : check failed (0x%02X) M %u N %u R %u I2SDIV %u ODD %u\n",
+			t->name, fs, err, c->M, c->N, c->R, c->I2SDIV, c->ODD);
+		}
+	return err;
+	}
+
+int main(int argc, char* argv[]) {
+	FILE* fp = stdout;
+	int verbose = 0, errors = 0;
+	CLK_CONFIG cfg[TARGET_NUM][FREQ_NUM];
+
+	for (int i = 1; i < argc; i++) {
+		if (strcmp(argv[i], "-v") == 0) {
+			verbose = 1;
+			}
+		else if (strcmp(argv[i], "-o") == 0 && i + 1 < argc) {
+			fp = fopen(argv[++i], "wb");
+			if (fp == NULL) {
+				perror(argv[i]);
+				return 1;
+				}
+			}
+		else {
+			fprintf(stderr, "usage : %s [-v] [-o bsp_audio_clk.h]\n", argv[0]);
+			return 1;
+			}
+		}
+
+	for (unsigned t = 0; t < TARGET_NUM; t++) {
+		for (unsigned f = 0; f < FREQ_NUM; f++) {
+			if (!clk_search(&Targets[t], FreqTable[f], &cfg[t][f])) {
+				fprintf(stderr, "%s %uHz : no valid setting\n", Targets[t].name, FreqTable[f]);
+				return 1;
+				}
+			if (clk_check(&Targets[t], FreqTable[f], &cfg[t][f])) {
+				errors++;
+				}
+			if (verbose) {
+				const CLK_CONFIG* c = &cfg[t][f];
+				fprintf(stderr, "%-28s %6u : M %2u N %3u R %u I2SDIV %3u ODD %u  %11.4fHz %+8.2fppm\n",
+					Targets[t].name, FreqTable[f], c->M, c->N, c->R, c->I2SDIV, c->ODD, c->fs, c->ppm);
+				}
+			}
+		}
+	if (errors) {
+		fprintf(stderr, "%d entries failed the check\n", errors);
+		return 1;
+		}
+
+	fprintf(fp, "// Generated by tools/i2s_pll, do not edit. Included by bsp_audio.c only.\r\n");
+	fprintf(fp, "// PLLI2S and I2S prescaler settings with the smallest sampling frequency error,\r\n");
+	fprintf(fp, "// nominal_fdbk is the actual Fs in kHz, 10.14 format shifted left by 8 bits.\r\n\r\n");
+	fprintf(fp, "#ifndef __BSP_AUDIO_CLK_H\r\n#define __BSP_AUDIO_CLK_H\r\n\r\n");
+	fprintf(fp, "#if (I2S_FREQ_NUM != %u) || (I2S_FREQ_INDEX_DEFAULT != %u)\r\n", (unsigned)FREQ_NUM, FREQ_INDEX_DEFAULT);
+	fprintf(fp, "#error \"I2S frequency table does not match bsp_audio.h\"\r\n#endif\r\n\r\n");
+	fprintf(fp, "const uint32_t I2SFreq[I2S_FREQ_NUM] = {");
+	for (unsigned f = 0; f < FREQ_NUM; f++) {
+		fprintf(fp, "%s%u", f ? ", " : "", FreqTable[f]);
+		}
+	fprintf(fp, "};\r\n\r\n");
+	for (unsigned t = 0; t < TARGET_NUM; t++) {
+		if (Targets[t].condition) {
+			fprintf(fp, "%s %s // %s\r\n\r\n", t ? "#elif" : "#if", Targets[t].condition, Targets[t].name);
+			}
+		else {
+			fprintf(fp, "#else // %s\r\n\r\n", Targets[t].name);
+			}
+		fprintf(fp, "const I2S_CLK_CONFIG I2S_Clk_Config24[I2S_FREQ_NUM]  = {\r\n");
+		for (unsigned f = 0; f < FREQ_NUM; f++) {
+			const CLK_CONFIG* c = &cfg[t][f];
+			char entry[64];
+			snprintf(entry, sizeof(entry), "{%u, %u, %u, %u, %u, 0x%08X}%s", c->M, c->N, c->R, c->I2SDIV, c->ODD, c->fdbk, f + 1 < FREQ_NUM ? "," : "");
+			fprintf(fp, "%-36s // %9.4f  %+8.2fppm\r\n", entry, c->fs / 1000.0, c->ppm);
+			}
+		fprintf(fp, "};\r\n\r\n");
+		}
+	fprintf(fp, "#endif\r\n\r\n#endif /* __BSP_AUDIO_CLK_H */\r\n");
+	if (fp != stdout) {
+		fclose(fp);
+		}
+	return 0;
+	}
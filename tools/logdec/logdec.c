@@ -0,0 +1,264 @@
+/**
+  ******************************************************************************
+  * @file    logdec.c
+  * @brief   Host tool : decode the binary log records sent on USART2 (src/log.h)
+  ******************************************************************************
+  *
+  * Build and run on the host, see tools/logdec/Makefile :
+  *   make                                            build the tool and run the self test
+  *   stty -F /dev/ttyUSB0 115200 raw
+  *   ./logdec ../../build/usb_audio_i2s.elf < /dev/ttyUSB0
+  *   ./logdec ../../build/usb_audio_i2s.elf capture.bin
+  *
+  * A record is a header word and its arguments, little-endian :
+  *   header = LOG_SYNC | nargs << 24 | (format address - FLASH_BASE)
+  * The format strings, and the strings passed with LOG_S, are read from the allocated sections
+  * of the firmware elf file, so it must be the one flashed. A header without the sync nibble or
+  * with an address that is not a string in the elf is skipped a byte at a time, so decoding
+  * resynchronises when the capture starts in the middle of a record.
+  *
+  * The arguments are printed with the conversions of the format : d i as int32, u o x X c as
+  * uint32, f e g a as float bits (LOG_F), s as a string address (LOG_S), p as an address.
+  * Carriage returns are removed from the output.
+  */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <elf.h>
+
+// see src/log.h
+#define LOG_ARGS_MAX    15U
+#define LOG_SYNC        0xA0000000U
+#define LOG_SYNC_MASK   0xF0000000U
+#define FLASH_BASE      0x08000000U
+
+#define SECTIONS_MAX    64
+
+typedef struct {
+	uint32_t addr;
+	uint32_t size;
+	const uint8_t* data;
+} SECTION;
+
+static SECTION sections[SECTIONS_MAX];
+static int section_num = 0;
+
+static uint32_t resync_bytes = 0;
+
+static void add_section(uint32_t addr, uint32_t size, const uint8_t* data) {
+	if (section_num < SECTIONS_MAX) {
+		sections[section_num].addr = addr;
+		sections[section_num].size = size;
+		sections[section_num].data = data;
+		section_num++;
+		}
+	}
+
+// NUL terminated string at a target address, NULL if there is none
+static const char* lookup(uint32_t addr) {
+	for (int i = 0; i < section_num; i++) {
+		SECTION* s = &sections[i];
+		if (addr >= s->addr && addr - s->addr < s->size) {
+			uint32_t off = addr - s->addr;
+			if (memchr(&s->data[off], 0, s->size - off) == NULL) return NULL;
+			return (const char*)&s->data[off];
+			}
+		}
+	return NULL;
+	}
+
+static int load_elf(const char* path) {
+	FILE* f = fopen(path, "rb");
+	if (f == NULL) {
+		fprintf(stderr, "cannot open %s\n", path);
+		return -1;
+		}
+	fseek(f, 0, SEEK_END);
+	long size = ftell(f);
+	fseek(f, 0, SEEK_SET);
+	uint8_t* image = malloc((size_t)size);
+	if (image == NULL || fread(image, 1, (size_t)size, f) != (size_t)size) {
+		fprintf(stderr, "cannot read %s\n", path);
+		fclose(f);
+		return -1;
+		}
+	fclose(f);
+
+	const Elf32_Ehdr* eh = (const Elf32_Ehdr*)image;
+	if (size < (long)sizeof(Elf32_Ehdr) || memcmp(eh->e_ident, ELFMAG, SELFMAG) != 0 ||
+	    eh->e_ident[EI_CLASS] != ELFCLASS32 || eh->e_ident[EI_DATA] != ELFDATA2LSB ||
+	    eh->e_shoff + (uint64_t)eh->e_shnum * sizeof(Elf32_Shdr) > (uint64_t)size) {
+		fprintf(stderr, "%s is not a 32bit little-endian elf file\n", path);
+		return -1;
+		}
+	const Elf32_Shdr* sh = (const Elf32_Shdr*)&image[eh->e_shoff];
+	for (int i = 0; i < eh->e_shnum; i++) {
+		if (sh[i].sh_type == SHT_PROGBITS && (sh[i].sh_flags & SHF_ALLOC) && sh[i].sh_size &&
+		    sh[i].sh_offset + (uint64_t)sh[i].sh_size <= (uint64_t)size) {
+			add_section(sh[i].sh_addr, sh[i].sh_size, &image[sh[i].sh_offset]);
+			}
+		}
+	return 0;
+	}
+
+static void put_text(FILE* out, const char* s) {
+	for (; *s; s++) {
+		if (*s != '\r') fputc(*s, out);
+		}
+	}
+
+static void print_record(FILE* out, const char* fmt, const uint32_t* args, uint32_t nargs) {
+	char spec[32];
+	char text[256];
+	uint32_t n = 0;
+	while (*fmt) {
+		if (*fmt != '%') {
+			if (*fmt != '\r') fputc(*fmt, out);
+			fmt++;
+			continue;
+			}
+		// flags, width and precision are kept, length modifiers are dropped
+		int len = 0;
+		spec[len++] = *fmt++;
+		while (*fmt && strchr("-+ #0123456789.hlzjtLq", *fmt)) {
+			if (!strchr("hlzjtLq", *fmt) && len < (int)sizeof(spec) - 2) spec[len++] = *fmt;
+			fmt++;
+			}
+		char conv = *fmt;
+		if (conv == 0) break;
+		fmt++;
+		if (conv == '%') {
+			fputc('%', out);
+			continue;
+			}
+		spec[len++] = conv;
+		spec[len] = 0;
+		if (n >= nargs) {
+			fputs("<?>", out);
+			continue;
+			}
+		uint32_t arg = args[n++];
+		switch (conv) {
+			case 'd': case 'i':
+				snprintf(text, sizeof(text), spec, (int32_t)arg);
+				break;
+			case 'u': case 'o': case 'x': case 'X': case 'c':
+				snprintf(text, sizeof(text), spec, arg);
+				break;
+			case 'f': case 'F': case 'e': case 'E': case 'g': case 'G': case 'a': case 'A': {
+				float v;
+				memcpy(&v, &arg, sizeof(v));
+				snprintf(text, sizeof(text), spec, (double)v);
+				}
+				break;
+			case 's': {
+				const char* s = lookup(arg);
+				if (s) snprintf(text, sizeof(text), spec, s);
+				else snprintf(text, sizeof(text), "<?0x%08x>", arg);
+				}
+				break;
+			default:
+				snprintf(text, sizeof(text), "0x%08x", arg);
+				break;
+			}
+		put_text(out, text);
+		}
+	}
+
+static void decode(FILE* in, FILE* out) {
+	uint8_t buf[4U * (1U + LOG_ARGS_MAX)];
+	uint32_t len = 0;
+	int c;
+	while ((c = fgetc(in)) != EOF) {
+		buf[len++] = (uint8_t)c;
+		while (len >= 4U) {
+			uint32_t hdr = buf[0] | buf[1] << 8 | buf[2] << 16 | (uint32_t)buf[3] << 24;
+			uint32_t nargs = (hdr >> 24) & 0x0FU;
+			const char* fmt = NULL;
+			if ((hdr & LOG_SYNC_MASK) == LOG_SYNC) {
+				fmt = lookup(FLASH_BASE + (hdr & 0x00FFFFFFU));
+				}
+			if (fmt == NULL) {
+				memmove(buf, &buf[1], --len);
+				resync_bytes++;
+				continue;
+				}
+			if (len < 4U * (1U + nargs)) break;
+
+			uint32_t args[LOG_ARGS_MAX];
+			for (uint32_t n = 0; n < nargs; n++) {
+				const uint8_t* p = &buf[4U * (1U + n)];
+				args[n] = p[0] | p[1] << 8 | p[2] << 16 | (uint32_t)p[3] << 24;
+				}
+			print_record(out, fmt, args, nargs);
+			fflush(out);
+			len = 0;
+			}
+		}
+	}
+
+
+// Records of a made up image, with a partial record in front
+static int self_test(void) {
+	static const char image[] =
+		"x = %d, %u%%\r\n\0"      // 0x100
+		"%s : %5.2f %x\r\n\0"     // 0x10F
+		"name";                   // 0x11F
+	static const uint32_t words[] = {
+		0x00000005U,                                   // argument of a lost header
+		LOG_SYNC | 2U << 24 | 0x100U, (uint32_t)-5, 80U,
+		LOG_SYNC | 3U << 24 | 0x10FU, FLASH_BASE + 0x11FU, 0x3FC00000U /* 1.5f */, 0xABU,
+		LOG_SYNC | 0U << 24 | 0x100U,                  // missing argument
+		};
+	static const char expect[] = "x = -5, 80%\nname :  1.50 ab\nx = <?>, <?>%\n";
+
+	add_section(FLASH_BASE + 0x100U, sizeof(image), (const uint8_t*)image);
+	uint8_t stream[sizeof(words) + 2];
+	stream[0] = 0xA0; // garbage byte
+	for (uint32_t i = 0; i < sizeof(words) / 4U; i++) {
+		for (uint32_t b = 0; b < 4U; b++) {
+			stream[1U + 4U*i + b] = (uint8_t)(words[i] >> (8U*b));
+			}
+		}
+	stream[sizeof(stream) - 1] = 0xFF;
+
+	char text[256] = {0};
+	FILE* in = fmemopen(stream, sizeof(stream), "rb");
+	FILE* out = fmemopen(text, sizeof(text) - 1, "w");
+	decode(in, out);
+	fclose(in);
+	fclose(out);
+	section_num = 0;
+	if (strcmp(text, expect) != 0) {
+		fprintf(stderr, "self test failed :\n%s", text);
+		return 1;
+		}
+	printf("self test ok, %u bytes skipped\n", resync_bytes);
+	resync_bytes = 0;
+	return 0;
+	}
+
+int main(int argc, char* argv[]) {
+	if (argc == 2 && strcmp(argv[1], "-t") == 0) {
+		return self_test();
+		}
+	if (argc < 2 || argc > 3) {
+		fprintf(stderr, "usage : logdec firmware.elf [capture]\n        logdec -t\n");
+		return 1;
+		}
+	if (load_elf(argv[1]) != 0) {
+		return 1;
+		}
+	FILE* in = stdin;
+	if (argc == 3 && (in = fopen(argv[2], "rb")) == NULL) {
+		fprintf(stderr, "cannot open %s\n", argv[2]);
+		return 1;
+		}
+	decode(in, stdout);
+	if (resync_bytes) {
+		fprintf(stderr, "%u bytes skipped\n", resync_bytes);
+		}
+	return 0;
+	}
@@ -0,0 +1,695 @@
+/**
+  ******************************************************************************
+  * @file    sim.c
+  * @brief   Host simulation : USB host model and stream scenarios
+  ******************************************************************************
+  *
+  * Build and run on a Linux host, see tools/sim/Makefile :
+  *   make            build the sim variants and run all the scenarios
+  *   ./sim -s 3      run scenario 3 only
+  *   ./sim -b        also print the simulation speed
+  *
+  * usbd_audio.c, usbd_audio_if.c and the BSP run unchanged against the fake HAL of sim_hal.c.
+  * The host model enumerates the device with the control requests of the Linux audio driver and
+  * streams isochronous packets once per 1ms frame :
+  *   +0.00ms  SOF
+  *   +0.05ms  control transfers
+  *   +0.05ms  OUT packet, with up to 0.3ms of deterministic jitter
+  *   +0.20ms  feedback endpoint poll, every 2^SOF_RATE frames
+  *   +0.50ms  telemetry read (USE_TELEMETRY)
+  *   +0.90ms  end of frame, incomplete isochronous transfer interrupts
+  * The packet sizes follow the feedback read from the device, as the Linux driver does, with a
+  * configurable delay. USE_ADAPTIVE_EP builds get packets at the nominal rate.
+  *
+  * The output is checked sample by sample. Without resampling the host sends a ramp (left n,
+  * right ~n) and the output must be the same ramp, bit exact at 0dB. With USE_ADAPTIVE_EP or
+  * USE_FIXED_CLOCK the host sends a sine on the left and a cosine on the right channel and the
+  * second difference of the output is checked for discontinuities. Silence (both channels 0)
+  * between streams is allowed, the number of stream starts is part of the scenario. Shorter
+  * silent runs, as the resampler start transient has, are skipped without ending the stream.
+  *
+  * The event of a scenario (frequency switch, stop, bus reset) is a control transfer in its frame,
+  * or with preempt set, the OTG interrupt preempting PendSV in the middle of a packet conversion :
+  * the conversion kernel is replaced for one call by PreemptKernel, which raises the event halfway,
+  * for the first packet from SIM_EVENT_MS on written at the start of the ring buffer. When PendSV
+  * is done the ring buffer must be silent, no frame of the old stream may be played.
+  *
+  * Each scenario runs in a child process so the firmware starts from its power up state.
+  * The exit status is the number of failed scenarios, a scenario taking longer than
+  * SIM_TIMEOUT_S is aborted.
+  */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <malloc.h>
+#include <unistd.h>
+#include <sys/wait.h>
+
+#include "sim_hal.h"
+#include "usbd_audio_if.h"
+
+#define SIM_MS              20000U  // scenario length, ms, the feedback and fill level are checked in the last quarter
+#define SIM_EVENT_MS        5000U   // frequency switch, stop or pause
+#define SIM_STREAM_FRAME    8U      // first frame the host streams in, after the enumeration
+#define SIM_PLL_LOCK_US     100.0
+#define SIM_SINE_HZ         250.0
+#define SIM_SINE_SKIP       64U     // frames not checked after a stream start, resampler settling
+#define SIM_GAP_FRAMES      48U     // silent frames ending a stream, shorter runs are part of it
+#define SIM_TIMEOUT_S       60U
+
+extern volatile uint32_t fb_value;
+
+typedef struct {
+	const char* name;
+	uint32_t freq;
+	uint8_t  alt;
+	double   ppm;           // crystal error
+	uint8_t  profile;       // latency profile, 0xFF = default
+	uint32_t fb_delay;      // ms from the feedback read to its use by the host
+	uint32_t fb_phase;      // poll frame modulo 2^SOF_RATE
+	uint32_t switch_freq;   // frequency change of the playing stream at SIM_EVENT_MS, 0 = none
+	uint32_t pause_ms;      // host sends no packet for pause_ms at SIM_EVENT_MS
+	uint32_t stop_ms;       // alternate setting 0 for stop_ms at SIM_EVENT_MS
+	uint8_t  reset;         // bus reset and enumeration at SIM_EVENT_MS, the stream restarts
+	uint8_t  preempt;       // the SIM_EVENT_MS event preempts PendSV converting a packet
+	uint8_t  xrun;          // underruns expected, the stream must recover
+	uint8_t  starts;        // expected stream starts
+	} SCENARIO;
+
+static const SCENARIO scenarios[] = {
+	// name                  freq    alt                    ppm     prof   dly ph  switch  pause stop rst pre xrun starts
+	{ "48k 24bit",           48000U, AUDIO_ALT_SETTING_24B,    0.0, 0xFFU, 1U, 0U, 0U,     0U,   0U, 0U, 0U, 0U,  1U },
+	{ "96k 24bit +100ppm",   96000U, AUDIO_ALT_SETTING_24B,  100.0, 0xFFU, 1U, 1U, 0U,     0U,   0U, 0U, 0U, 0U,  1U },
+	{ "44.1k 24bit -100ppm", 44100U, AUDIO_ALT_SETTING_24B, -100.0, 0xFFU, 1U, 2U, 0U,     0U,   0U, 0U, 0U, 0U,  1U },
+	{ "192k 16bit",         192000U, AUDIO_ALT_SETTING_16B,   20.0, 0xFFU, 1U, 0U, 0U,     0U,   0U, 0U, 0U, 0U,  1U },
+	{ "96k 32bit -30ppm",    96000U, AUDIO_ALT_SETTING_32B,  -30.0, 0xFFU, 1U, 3U, 0U,     0U,   0U, 0U, 0U, 0U,  1U },
+	{ "48k low latency",     48000U, AUDIO_ALT_SETTING_24B,   50.0,    0U, 1U, 0U, 0U,     0U,   0U, 0U, 0U, 0U,  1U },
+	{ "slow host feedback",  96000U, AUDIO_ALT_SETTING_24B,  -50.0, 0xFFU, 8U, 3U, 0U,     0U,   0U, 0U, 0U, 0U,  1U },
+	{ "48k to 96k switch",   48000U, AUDIO_ALT_SETTING_24B,   30.0, 0xFFU, 1U, 0U, 96000U, 0U,   0U, 0U, 0U, 0U,  2U },
+	{ "stop and restart",    96000U, AUDIO_ALT_SETTING_24B,    0.0, 0xFFU, 1U, 1U, 0U,     0U,  50U, 0U, 0U, 0U,  2U },
+	{ "host pause 20ms",     48000U, AUDIO_ALT_SETTING_24B,    0.0, 0xFFU, 1U, 0U, 0U,    20U,   0U, 0U, 0U, 1U,  0U },
+	{ "switch in PendSV",    48000U, AUDIO_ALT_SETTING_24B,   30.0, 0xFFU, 1U, 0U, 96000U, 0U,   0U, 0U, 1U, 0U,  2U },
+	{ "bus reset in PendSV", 96000U, AUDIO_ALT_SETTING_24B,    0.0, 0xFFU, 1U, 1U, 0U,     0U,   0U, 1U, 1U, 0U,  2U },
+	};
+#define SCENARIO_NUM    (sizeof(scenarios)/sizeof(scenarios[0]))
+
+// Output checker, see SIM_Output
+typedef struct {
+	uint32_t bits;          // resolution of the host signal
+	double   w;             // sine output step, rad per frame
+	int32_t  d2_max;        // sine second difference limit
+	uint32_t frames;
+	uint32_t starts;
+	uint32_t gaps;          // stream to silence
+	uint32_t glitches;
+	uint32_t clean;         // consecutive correct frames
+	uint32_t skip;
+	uint32_t silent;        // consecutive silent frames
+	uint8_t  in_data;
+	uint32_t prev;
+	int32_t  y[2], z[2];    // previous left and right samples
+	double   t_start;       // first stream output
+	double   t_glitch;      // first glitch
+	} CHECK;
+
+// Host side of the stream
+typedef struct {
+	uint32_t freq;
+	uint8_t  alt;
+	uint8_t  streaming;
+	uint32_t acc;           // packet size accumulator, frames Q16
+	uint32_t fb;            // frames per frame Q16, from the feedback endpoint
+	uint32_t fb_pending[16];
+	uint32_t fb_pending_frame[16];
+	uint32_t fb_reads;
+	uint64_t n;             // frames sent
+	double   phase;
+	double   t_first;       // first packet
+	uint32_t lcg;
+	uint32_t telem_records;
+	uint32_t telem_bad;
+	} HOST;
+
+static CHECK chk;
+static HOST host;
+static uint8_t out_received;
+
+static uint32_t Lcg(void) {
+	host.lcg = host.lcg * 1103515245U + 12345U;
+	return (host.lcg >> 16) & 0x7FFFU;
+	}
+
+static uint32_t AltBits(uint8_t alt) {
+	return (alt == AUDIO_ALT_SETTING_16B) ? 16U : 24U;
+	}
+
+static uint32_t AltBytes(uint8_t alt) {
+	return (alt == AUDIO_ALT_SETTING_16B) ? 2U : ((alt == AUDIO_ALT_SETTING_32B) ? 4U : 3U);
+	}
+
+static uint32_t AltFreqMax(uint8_t alt) {
+	return (alt == AUDIO_ALT_SETTING_16B) ? AUDIO_OUT_FREQ_MAX_16B :
+	       ((alt == AUDIO_ALT_SETTING_32B) ? AUDIO_OUT_FREQ_MAX_32B : AUDIO_OUT_FREQ_MAX_24B);
+	}
+
+
+/* Output check --------------------------------------------------------------*/
+
+static void Glitch(void) {
+	if (chk.glitches++ == 0U) {
+		chk.t_glitch = SIM_Now();
+		}
+	chk.clean = 0U;
+	}
+
+void SIM_Output(uint32_t left, uint32_t right) {
+	chk.frames++;
+	if (left == 0U && right == 0U) {
+		if (chk.in_data) {
+			if (++chk.silent < SIM_GAP_FRAMES) {
+				return;
+				}
+			chk.gaps++;
+			}
+		chk.in_data = 0U;
+		chk.clean = 0U;
+		return;
+		}
+	chk.silent = 0U;
+	if (!chk.in_data) {
+		if (chk.starts++ == 0U) {
+			chk.t_start = SIM_Now();
+			}
+		chk.skip = SIM_SINE_SKIP;
+		}
+#ifndef AUDIO_OUT_RESAMPLE
+	// ramp, left n and right ~n
+	uint32_t shift = 32U - chk.bits;
+	uint32_t mask = (1U << chk.bits) - 1U;
+	uint32_t n = left >> shift;
+	uint8_t ok = ((left & ((1U << shift) - 1U)) == 0U) && (right == (~n & mask) << shift);
+	if (chk.in_data && n != ((chk.prev + 1U) & mask)) {
+		ok = 0U;
+		}
+	chk.prev = n;
+#else
+	// sine and cosine, the second difference is bounded by the amplitude and the step
+	int32_t y = (int32_t)left >> 8;
+	int32_t z = (int32_t)right >> 8;
+	uint8_t ok = 1U;
+	if (chk.skip) {
+		chk.skip--;
+		}
+	else {
+		int32_t d2y = y - 2 * chk.y[0] + chk.y[1];
+		int32_t d2z = z - 2 * chk.z[0] + chk.z[1];
+		ok = (abs(d2y) <= chk.d2_max) && (abs(d2z) <= chk.d2_max);
+		}
+	chk.y[1] = chk.y[0];
+	chk.y[0] = y;
+	chk.z[1] = chk.z[0];
+	chk.z[0] = z;
+#endif
+	chk.in_data = 1U;
+	if (ok) {
+		chk.clean++;
+		}
+	else {
+		Glitch();
+		}
+	}
+
+
+/* Control transfers ---------------------------------------------------------*/
+
+// Setup, data and status stages, each stage must have been armed by the device
+static int Control(uint8_t bmRequest, uint8_t bRequest, uint16_t wValue, uint16_t wIndex, uint16_t wLength, uint8_t* data) {
+	USBD_HandleTypeDef* pdev = &USBD_Device;
+	uint8_t setup[8] = {
+		bmRequest, bRequest, (uint8_t)wValue, (uint8_t)(wValue >> 8),
+		(uint8_t)wIndex, (uint8_t)(wIndex >> 8), (uint8_t)wLength, (uint8_t)(wLength >> 8),
+		};
+	SIM_EpIn[0].tx_armed = 0U;
+	SIM_EpOut[0].rx_armed = 0U;
+	USBD_LL_SetupStage(pdev, setup);
+	SIM_IsrExit();
+
+	if (wLength && !(bmRequest & 0x80U)) {
+		if (!SIM_EpOut[0].rx_armed || SIM_EpOut[0].rx_size < wLength) {
+			return -1;
+			}
+		memcpy(SIM_EpOut[0].rx_buf, data, wLength);
+		SIM_EpOut[0].rx_count = wLength;
+		SIM_EpOut[0].rx_armed = 0U;
+		USBD_LL_DataOutStage(pdev, 0U, SIM_EpOut[0].rx_buf);
+		SIM_IsrExit();
+		}
+	else if (wLength) {
+		if (!SIM_EpIn[0].tx_armed) {
+			return -1;
+			}
+		memcpy(data, SIM_EpIn[0].tx_data, (SIM_EpIn[0].tx_len < wLength) ? SIM_EpIn[0].tx_len : wLength);
+		SIM_EpIn[0].tx_armed = 0U;
+		USBD_LL_DataInStage(pdev, 0U, SIM_EpIn[0].tx_data);
+		SIM_IsrExit();
+		// status OUT
+		if (!SIM_EpOut[0].rx_armed) {
+			return -1;
+			}
+		SIM_EpOut[0].rx_armed = 0U;
+		SIM_EpOut[0].rx_count = 0U;
+		USBD_LL_DataOutStage(pdev, 0U, NULL);
+		SIM_IsrExit();
+		return 0;
+		}
+
+	// status IN
+	if (!SIM_EpIn[0].tx_armed || SIM_EpIn[0].tx_len != 0U) {
+		return -1;
+		}
+	SIM_EpIn[0].tx_armed = 0U;
+	USBD_LL_DataInStage(pdev, 0U, NULL);
+	SIM_IsrExit();
+	return 0;
+	}
+
+static int SetInterface(uint8_t alt) {
+	return Control(0x01U, USB_REQ_SET_INTERFACE, alt, 1U, 0U, NULL);
+	}
+
+static int SetFreq(uint32_t freq) {
+	uint8_t data[3] = { (uint8_t)freq, (uint8_t)(freq >> 8), (uint8_t)(freq >> 16) };
+	return Control(0x22U, AUDIO_REQ_SET_CUR, AUDIO_STREAMING_REQ_FREQ_CTRL << 8, AUDIO_OUT_EP, 3U, data);
+	}
+
+static int SetVolume(int16_t vol) {
+	uint8_t data[2] = { (uint8_t)vol, (uint8_t)((uint16_t)vol >> 8) };
+	return Control(0x21U, AUDIO_REQ_SET_CUR, AUDIO_CONTROL_REQ_FU_VOL << 8, AUDIO_OUT_STREAMING_CTRL << 8, 2U, data);
+	}
+
+static int SetLatency(uint8_t profile) {
+	return Control(0x41U, AUDIO_VENDOR_REQ_SET_LATENCY, profile, AUDIO_AS_ITF, 0U, NULL);
+	}
+
+
+/* Stream --------------------------------------------------------------------*/
+
+static void StreamStart(uint32_t freq, uint8_t alt) {
+	host.freq = freq;
+	host.alt = alt;
+	host.acc = 0U;
+	host.fb = (uint32_t)(((uint64_t)freq << 16) / 1000U);
+	host.fb_reads = 0U;
+	host.streaming = 1U;
+	}
+
+static void PutSample(uint8_t* p, int32_t s, uint32_t bytes) {
+	if (bytes == 4U) {
+		s <<= 8;   // 24bit in 32bit subframe
+		}
+	for (uint32_t b = 0; b < bytes; b++) {
+		p[b] = (uint8_t)(s >> (8U * b));
+		}
+	}
+
+static void SendPacket(uint32_t frame) {
+	static uint8_t pkt[AUDIO_OUT_PACKET_MAX + 16U];
+	// packet size, frames per frame from the feedback
+	for (uint32_t i = 0; i < 16U; i++) {
+		if (host.fb_pending_frame[i] == frame && host.fb_pending[i]) {
+			host.fb = host.fb_pending[i];
+			host.fb_pending[i] = 0U;
+			}
+		}
+	host.acc += host.fb;
+	uint32_t frames = host.acc >> 16;
+	host.acc &= 0xFFFFU;
+	uint32_t bytes = AltBytes(host.alt);
+	uint32_t len = frames * 2U * bytes;
+	if (len > sizeof(pkt)) {
+		fprintf(stderr, "sim : packet of %u frames\n", frames);
+		exit(2);
+		}
+
+	uint32_t bits = AltBits(host.alt);
+	for (uint32_t i = 0; i < frames; i++) {
+		int32_t l, r;
+#ifndef AUDIO_OUT_RESAMPLE
+		uint32_t mask = (1U << bits) - 1U;
+		uint32_t sign = 32U - bits;
+		l = (int32_t)(((uint32_t)host.n & mask) << sign) >> sign;
+		r = (int32_t)((~(uint32_t)host.n & mask) << sign) >> sign;
+#else
+		double a = (double)(1U << (bits - 2U));
+		l = (int32_t)lrint(a * sin(host.phase));
+		r = (int32_t)lrint(a * cos(host.phase));
+		host.phase += 2.0 * M_PI * SIM_SINE_HZ / host.freq;
+		if (host.phase > 2.0 * M_PI) {
+			host.phase -= 2.0 * M_PI;
+			}
+#endif
+		PutSample(&pkt[(2U * i) * bytes], l, bytes);
+		PutSample(&pkt[(2U * i + 1U) * bytes], r, bytes);
+		host.n++;
+		}
+	if (host.t_first == 0.0) {
+		host.t_first = SIM_Now();
+		}
+
+	// lost if the endpoint is not armed
+	SIM_EpTypeDef* ep = &SIM_EpOut[AUDIO_OUT_EP];
+	if (!ep->open || !ep->rx_armed) {
+		return;
+		}
+	if (len > ep->rx_size) {
+		fprintf(stderr, "sim : packet of %u bytes, endpoint armed for %u\n", len, ep->rx_size);
+		exit(2);
+		}
+	memcpy(ep->rx_buf, pkt, len);
+	ep->rx_count = len;
+	ep->rx_armed = 0U;
+	out_received = 1U;
+	USBD_LL_DataOutStage(&USBD_Device, AUDIO_OUT_EP, ep->rx_buf);
+	SIM_IsrExit();
+	}
+
+// The host reads the feedback endpoint in the frame it was armed for
+static void PollFeedback(uint32_t frame, uint32_t delay) {
+	SIM_EpTypeDef* ep = &SIM_EpIn[AUDIO_IN_EP & 0x0FU];
+	if (!ep->open || !ep->tx_armed || ep->tx_frame != frame) {
+		return;
+		}
+	ep->tx_armed = 0U;
+	if (ep->tx_len == AUDIO_IN_PACKET) {
+		uint32_t fb = (uint32_t)ep->tx_data[0] | (uint32_t)ep->tx_data[1] << 8 | (uint32_t)ep->tx_data[2] << 16;
+		uint32_t i = host.fb_reads++ & 15U;
+		host.fb_pending[i] = fb << 2;   // 10.14 to 16.16
+		host.fb_pending_frame[i] = frame + delay;
+		}
+	USBD_LL_DataInStage(&USBD_Device, AUDIO_IN_EP & 0x0FU, NULL);
+	SIM_IsrExit();
+	}
+
+#ifdef USE_TELEMETRY
+static void ReadTelemetry(void) {
+	SIM_EpTypeDef* ep = &SIM_EpIn[AUDIO_TELEM_EP & 0x0FU];
+	if (!ep->open || !ep->tx_armed) {
+		return;
+		}
+	ep->tx_armed = 0U;
+	for (uint32_t pos = 0; pos + sizeof(AUDIO_TelemRecordTypeDef) <= ep->tx_len; pos += sizeof(AUDIO_TelemRecordTypeDef)) {
+		host.telem_records++;
+		if ((ep->tx_data[pos] | ep->tx_data[pos + 1U] << 8) != AUDIO_TELEM_MAGIC) {
+			host.telem_bad++;
+			}
+		}
+	USBD_LL_DataInStage(&USBD_Device, AUDIO_TELEM_EP & 0x0FU, NULL);
+	SIM_IsrExit();
+	}
+#endif
+
+// End of frame : a feedback packet not read in its frame, no OUT packet on an open endpoint
+static void EndOfFrame(uint32_t frame) {
+	SIM_EpTypeDef* in = &SIM_EpIn[AUDIO_IN_EP & 0x0FU];
+	if (in->open && in->tx_armed && in->tx_frame == frame) {
+		USBD_LL_IsoINIncomplete(&USBD_Device, 0U);
+		SIM_IsrExit();
+		// not flushed : sent in the next frame of the same parity
+		in->tx_frame += 2U;
+		}
+	if (SIM_EpOut[AUDIO_OUT_EP].open && !out_received) {
+		USBD_LL_IsoOUTIncomplete(&USBD_Device, 0U);
+		SIM_IsrExit();
+		}
+	}
+
+
+/* Scenario ------------------------------------------------------------------*/
+
+// Bus reset and the control requests of the driver up to the stream at freq
+static int BusReset(const SCENARIO* sc, uint32_t freq) {
+	USBD_LL_SetSpeed(&USBD_Device, USBD_SPEED_FULL);
+	USBD_LL_Reset(&USBD_Device);
+	SIM_IsrExit();
+	if (Control(0x00U, USB_REQ_SET_ADDRESS, 5U, 0U, 0U, NULL) ||
+	    Control(0x00U, USB_REQ_SET_CONFIGURATION, 1U, 0U, 0U, NULL) ||
+	    ((sc->profile != 0xFFU) && SetLatency(sc->profile)) ||
+	    SetVolume(0) ||
+	    SetInterface(sc->alt) ||
+	    SetFreq(freq)) {
+		return -1;
+		}
+	if (USBD_Device.pClassData == NULL || (uintptr_t)USBD_Device.pClassData > 0xFFFFFFFFU) {
+		fprintf(stderr, "sim : class data not allocated below 4GB\n");
+		return -1;
+		}
+	return 0;
+	}
+
+static int Enumerate(const SCENARIO* sc) {
+	USBD_Init(&USBD_Device, NULL, 0);
+	USBD_RegisterClass(&USBD_Device, USBD_AUDIO_CLASS);
+	USBD_AUDIO_RegisterInterface(&USBD_Device, &USBD_AUDIO_fops);
+	USBD_Start(&USBD_Device);
+	return BusReset(sc, sc->freq);
+	}
+
+// Event of the scenario at SIM_EVENT_MS
+static struct {
+	const SCENARIO* sc;
+	uint32_t freq;          // stream frequency
+	int      err;
+	// preempt : the kernel PreemptKernel replaces for one call
+	AUDIO_ConvTypeDef* conv;
+	AUDIO_ConvFunc func;
+	uint8_t  armed;
+	uint8_t  pending;
+	uint8_t  checked;
+	uint8_t  stale;         // frames of the old stream in the ring buffer after the restart
+	} event;
+
+static void Event(void) {
+	const SCENARIO* sc = event.sc;
+	if (sc->switch_freq) {
+		// the host stops the stream and sets the new frequency, the alternate setting is kept
+		event.freq = sc->switch_freq;
+		event.err |= SetFreq(event.freq);
+		StreamStart(event.freq, sc->alt);
+		}
+	if (sc->stop_ms) {
+		host.streaming = 0U;
+		event.err |= SetInterface(0U);
+		}
+	if (sc->reset) {
+		event.err |= BusReset(sc, event.freq);
+		StreamStart(event.freq, sc->alt);
+		}
+	}
+
+// The OTG interrupt preempts PendSV halfway through the packet, the kernel then converts the rest
+static void PreemptKernel(uint32_t* pDst, const uint8_t* pSrc, uint32_t samples, int32_t gain, int32_t gain_step) {
+	uint32_t first = (samples / 2U) & ~1U;
+	const uint8_t* pRest = pSrc + first * event.conv->in_bytes;
+	AUDIO_ConvFunc func = event.func;
+	event.pending = 0U;
+	func(pDst, pSrc, first, gain, gain_step);
+	Event();
+	func(pDst + first, pRest, samples - first, gain, gain_step);
+	}
+
+// Ring buffer silent, from the restart to the first packet of the new stream
+static uint8_t RingSilent(void) {
+	USBD_AUDIO_HandleTypeDef* haudio = (USBD_AUDIO_HandleTypeDef*)USBD_Device.pClassData;
+	for (uint32_t i = 0; i < haudio->buf_size; i++) {
+		if (haudio->buffer[i] != 0U) {
+			return 0U;
+			}
+		}
+	return 1U;
+	}
+
+// The packet must be written at the start of the ring buffer, which the restarted DMA plays first
+static uint8_t PreemptNextPacket(void) {
+	USBD_AUDIO_HandleTypeDef* haudio = (USBD_AUDIO_HandleTypeDef*)USBD_Device.pClassData;
+	if (haudio->wr_ptr >= 2U * haudio->safezone) {
+		return 0U;
+		}
+	event.conv = &haudio->conv;
+	event.func = haudio->conv.func;
+	event.pending = 1U;
+	haudio->conv.func = PreemptKernel;
+	return 1U;
+	}
+
+static double Seconds(void) {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec * 1e-9;
+	}
+
+static int Run(const SCENARIO* sc, int bench) {
+	SIM_Init(sc->ppm, SIM_PLL_LOCK_US);
+	memset(&chk, 0, sizeof(chk));
+	memset(&host, 0, sizeof(host));
+	host.lcg = 1U;
+	chk.bits = AltBits(sc->alt);
+	double host_t0 = Seconds();
+
+	memset(&event, 0, sizeof(event));
+	event.sc = sc;
+	event.freq = sc->freq;
+
+	int err = Enumerate(sc);
+	uint32_t mid = SIM_EVENT_MS;
+	double fb_sum = 0.0, fs_sum = 0.0, fill_sum = 0.0;
+	uint32_t fb_count = 0U;
+	for (uint32_t f = 0; f < SIM_MS && !err; f++) {
+		double t = f * 1e-3;
+		SIM_RunUntil(t);
+		SIM_Sof(f);
+		out_received = 0U;
+
+		SIM_RunUntil(t + 0.05e-3);
+		if (f == SIM_STREAM_FRAME) {
+			StreamStart(event.freq, sc->alt);
+			}
+		if (f == mid && !sc->preempt) {
+			Event();
+			}
+		if (f >= mid && sc->preempt && !event.armed) {
+			event.armed = PreemptNextPacket();
+			}
+		if (sc->stop_ms && f == mid + sc->stop_ms) {
+			err = SetInterface(sc->alt) || SetFreq(event.freq);
+			StreamStart(event.freq, sc->alt);
+			}
+		uint8_t paused = sc->pause_ms && f >= mid && f < mid + sc->pause_ms;
+		if (host.streaming && !paused) {
+			SIM_RunUntil(t + (0.05 + 0.3 * Lcg() / 32768.0) * 1e-3);
+			SendPacket(f);
+			}
+		// the packet of the frame was converted with PreemptKernel
+		if (event.armed && !event.pending && !event.checked) {
+			event.checked = 1U;
+			event.stale = !RingSilent();
+			}
+		err |= event.err || event.pending;
+
+		SIM_RunUntil(t + 0.2e-3);
+		if ((f & AUDIO_FB_PERIOD_MASK) == sc->fb_phase) {
+			PollFeedback(f, sc->fb_delay);
+			}
+#ifdef USE_TELEMETRY
+		SIM_RunUntil(t + 0.5e-3);
+		ReadTelemetry();
+#endif
+		SIM_RunUntil(t + 0.9e-3);
+		EndOfFrame(f);
+
+		// controller output and fill level in the last quarter
+		if (f >= SIM_MS - SIM_MS/4U && USBD_Device.pClassData != NULL) {
+			USBD_AUDIO_HandleTypeDef* haudio = (USBD_AUDIO_HandleTypeDef*)USBD_Device.pClassData;
+			fb_sum += fb_value * 1000.0 / (1U << 22);
+			fs_sum += SIM_I2SFs();
+			fill_sum += (haudio->fb.fill - haudio->fb.setpoint) / 256.0;
+			fb_count++;
+			}
+		if (f == SIM_STREAM_FRAME && SIM_I2SFs() > 0.0) {
+			double w = 2.0 * M_PI * SIM_SINE_HZ / SIM_I2SFs();
+			chk.d2_max = (int32_t)(2.0 * (1U << 22) * w * w) + 1024;
+			}
+		}
+	SIM_RunUntil(SIM_MS * 1e-3);
+	double host_time = Seconds() - host_t0;
+
+	double fb_ppm = fb_count ? (fb_sum / fs_sum - 1.0) * 1e6 : 0.0;
+	double fill = fb_count ? fill_sum / fb_count : 0.0;
+	double latency = (chk.t_start - host.t_first) * 1e3;
+	uint32_t xruns = USBD_AUDIO_Xrun.underruns + USBD_AUDIO_Xrun.overruns;
+
+	// a clean stream has no xrun and no glitch, the pause scenario must end in a clean stream
+	int fail = err || event.stale;
+	if (sc->xrun) {
+		fail |= (xruns == 0U) || (chk.clean < SIM_MS/8U * sc->freq / 1000U);
+		}
+	else {
+		fail |= (xruns != 0U) || (chk.glitches != 0U) || (chk.starts != sc->starts) ||
+		        (chk.gaps != sc->starts - 1U) || (fabs(fb_ppm) > 50.0) || (fabs(fill) > 4.0);
+		}
+#ifdef USE_TELEMETRY
+	fail |= (host.telem_records < SIM_MS/2U) || (host.telem_bad != 0U);
+#endif
+
+	printf("%-20s under %u over %u  starts %u gaps %u glitches %u  fb %+7.1fppm  fill %+6.2f  start %5.2fms",
+	       sc->name, USBD_AUDIO_Xrun.underruns, USBD_AUDIO_Xrun.overruns, chk.starts, chk.gaps, chk.glitches,
+	       fb_ppm, fill, latency);
+#ifdef DEBUG_FEEDBACK_ENDPOINT
+	printf(" (fw %5.2fms)", DbgStartCycles * 1e3 / SystemCoreClock);
+#endif
+#ifdef USE_TELEMETRY
+	printf("  telem %u", host.telem_records);
+#endif
+	if (bench) {
+		printf("  x%.0f", SIM_MS * 1e-3 / host_time);
+		}
+	if (err) {
+		printf("  control transfer failed");
+		}
+	if (event.stale) {
+		printf("  old frames after the restart");
+		}
+	if (chk.glitches) {
+		printf("  first glitch %.4fs", chk.t_glitch);
+		}
+	printf("  %s\n", fail ? "FAIL" : "ok");
+	return fail ? 1 : 0;
+	}
+
+int main(int argc, char* argv[]) {
+	int only = -1;
+	int bench = 0;
+	for (int i = 1; i < argc; i++) {
+		if (strcmp(argv[i], "-s") == 0 && i + 1 < argc) {
+			only = atoi(argv[++i]);
+			}
+		else if (strcmp(argv[i], "-b") == 0) {
+			bench = 1;
+			}
+		else {
+			fprintf(stderr, "usage : sim [-s scenario] [-b]\n");
+			return 1;
+			}
+		}
+	// the DMA and OTG registers hold 32bit addresses, keep the class data in the brk heap
+	mallopt(M_MMAP_THRESHOLD, 64 * 1024 * 1024);
+
+	int failed = 0;
+	for (int i = 0; i < (int)SCENARIO_NUM; i++) {
+		const SCENARIO* sc = &scenarios[i];
+		if (only >= 0 && i != only) {
+			continue;
+			}
+		uint32_t max = AltFreqMax(sc->alt);
+		if (sc->freq > max || sc->switch_freq > max) {
+			printf("%-20s not supported by this build\n", sc->name);
+			continue;
+			}
+		fflush(stdout);
+		pid_t pid = fork();
+		if (pid == 0) {
+			alarm(SIM_TIMEOUT_S);
+			exit(Run(sc, bench));
+			}
+		int status = 1;
+		if (pid < 0 || waitpid(pid, &status, 0) < 0 || !WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+			if (pid > 0 && !(WIFEXITED(status) && WEXITSTATUS(status) == 1)) {
+				printf("%-20s aborted\n", sc->name);
+				}
+			failed++;
+			}
+		}
+	return failed;
+	}
@@ -0,0 +1,552 @@
+/**
+  ******************************************************************************
+  * @file    sim_hal.c
+  * @brief   Host simulation : fake HAL, PCD and peripheral models
+  ******************************************************************************
+  *
+  * Replaces src/usbd_conf.c (PCD glue), the HAL drivers and the startup code for the sources built
+  * by tools/sim/Makefile. The firmware runs unchanged on registers in host memory, see
+  * stm32f4xx_hal_conf.h in this directory.
+  *
+  * Time is in seconds of the host (USB) clock. The firmware takes no time : a handler sees the
+  * registers as they are at its start, and the busy waits on HAL_GetTick advance the time by 1us
+  * per call. The handlers never preempt each other, as on the target where the OTG and DMA
+  * interrupts have the same priority. PendSV runs after the handler that pended it. A handler
+  * called while PendSV runs preempts it and returns to it, PendSV is not re-entered.
+  *
+  * Models, updated by Sync on every entry into the firmware :
+  *   - HSE is 25MHz with a crystal error (ppm) relative to the host clock. The core clock,
+  *     the DWT cycle counter and TIM2 run from it.
+  *   - PLLI2S locks pll_lock_us after PLLI2SON is set. The I2S frame rate follows from
+  *     RCC PLLI2SCFGR (PLLCFGR PLLM on the F401), SPI2 I2SPR and the I2SCFGR channel length.
+  *   - The DMA stream runs while EN, TXDMAEN, I2SE and PLLI2SRDY are set. NDTR counts down
+  *     in halfwords at 4 halfwords per 24 or 32bit frame (2 for 16bit data), circular with the
+  *     value it was enabled with. The half and full transfer events call the I2S callbacks of
+  *     bsp_audio.c at the time NDTR crosses the half and the end of the buffer.
+  *   - The samples the DMA reads are passed to SIM_Output, left aligned in 32 bits.
+  *   - The fake PCD keeps the endpoint state in SIM_EpIn / SIM_EpOut for the host model.
+  */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "sim_hal.h"
+#include "bsp_audio.h"
+#include "usbd_audio_if.h"
+
+uint32_t        SIM_OtgFs[0x1000U/4U];
+uint32_t        SIM_Dma1[0x100U/4U];
+SPI_TypeDef     SIM_Spi2;
+RCC_TypeDef     SIM_Rcc;
+TIM_TypeDef     SIM_Tim2;
+GPIO_TypeDef    SIM_GpioA, SIM_GpioB, SIM_GpioC;
+SCB_Type        SIM_Scb;
+DWT_Type        SIM_Dwt;
+CoreDebug_Type  SIM_CoreDebug;
+
+// defined by main.c and system_stm32f4xx.c on the target
+USBD_HandleTypeDef USBD_Device;
+AUDIO_STATUS_TypeDef audio_status;
+uint32_t SystemCoreClock;
+
+SIM_EpTypeDef SIM_EpIn[SIM_EP_NUM];
+SIM_EpTypeDef SIM_EpOut[SIM_EP_NUM];
+
+extern I2S_HandleTypeDef haudio_i2s;
+
+#ifdef STM32F411xE
+#define SIM_CORE_HZ     96000000U
+#else
+#define SIM_CORE_HZ     84000000U
+#endif
+#define SIM_PLLM        25U      // main PLL input divider, 1MHz PLL input
+
+typedef struct {
+	double   now;
+	double   hse_ppm;
+	double   pll_lock;       // s
+	double   pll_on_time;
+	uint8_t  pll_on;
+	uint32_t frame;
+	uint8_t  pendsv;         // PendSV running
+	// DMA stream 4 and I2S
+	uint8_t  dma_en;
+	uint8_t  dma_run;
+	uint32_t dma_size;       // halfwords, NDTR when the stream was enabled
+	uint32_t dma_pos0;       // halfwords played before the start of this run
+	double   dma_t0;         // start of this run
+	double   dma_rate;       // halfwords per s
+	uint32_t dma_hpf;        // halfwords per frame
+	uint64_t dma_pos;        // halfwords played since the start of this run, from dma_pos0
+	uint64_t dma_out;        // halfwords passed to SIM_Output
+	uint64_t dma_evt;        // next half / full transfer event, halfwords since the start of this run
+	} SIM_StateTypeDef;
+
+static SIM_StateTypeDef sim;
+
+static void Fatal(const char* msg) {
+	fprintf(stderr, "sim : %s at %.6fs\n", msg, sim.now);
+	exit(2);
+	}
+
+void assert_failed(uint8_t* file, uint32_t line) {
+	fprintf(stderr, "sim : assert failed %s:%u at %.6fs\n", (const char*)file, (unsigned)line, sim.now);
+	exit(2);
+	}
+
+// DMA addresses are 32bit registers, the sim is linked without PIE to keep them valid
+static uint32_t Addr32(const volatile void* p) {
+	if ((uintptr_t)p > 0xFFFFFFFFU) {
+		Fatal("buffer address above 4GB, build without PIE");
+		}
+	return (uint32_t)(uintptr_t)p;
+	}
+
+
+/* Peripheral models ---------------------------------------------------------*/
+
+static double HseHz(void) {
+	return HSE_VALUE * (1.0 + sim.hse_ppm * 1e-6);
+	}
+
+// Frame rate of the I2S master clock, from the PLLI2S and prescaler registers
+double SIM_I2SFs(void) {
+	uint32_t cfg = RCC->PLLI2SCFGR;
+#ifdef STM32F411xE
+	uint32_t m = (cfg & RCC_PLLI2SCFGR_PLLI2SM) >> RCC_PLLI2SCFGR_PLLI2SM_Pos;
+#else
+	uint32_t m = (RCC->PLLCFGR & RCC_PLLCFGR_PLLM) >> RCC_PLLCFGR_PLLM_Pos;
+#endif
+	uint32_t n = (cfg & RCC_PLLI2SCFGR_PLLI2SN) >> RCC_PLLI2SCFGR_PLLI2SN_Pos;
+	uint32_t r = (cfg & RCC_PLLI2SCFGR_PLLI2SR) >> RCC_PLLI2SCFGR_PLLI2SR_Pos;
+	uint32_t pr = SPI2->I2SPR;
+	uint32_t div = 2U * (pr & SPI_I2SPR_I2SDIV) + ((pr & SPI_I2SPR_ODD) ? 1U : 0U);
+	uint32_t bits = (pr & SPI_I2SPR_MCKOE) ? 256U : ((SPI2->I2SCFGR & SPI_I2SCFGR_CHLEN) ? 64U : 32U);
+	if (m == 0U || r == 0U || div < 4U) {
+		return 0.0;
+		}
+	return HseHz() / m * n / r / (bits * div);
+	}
+
+uint32_t SIM_I2SRunning(void) {
+	return sim.dma_run;
+	}
+
+static void DMA_Start(DMA_Stream_TypeDef* s) {
+	sim.dma_run = 1U;
+	sim.dma_t0 = sim.now;
+	sim.dma_hpf = ((SPI2->I2SCFGR & SPI_I2SCFGR_DATLEN) == 0U) ? 2U : 4U;
+	sim.dma_rate = SIM_I2SFs() * sim.dma_hpf;
+	sim.dma_pos0 = sim.dma_size - (s->NDTR & 0xFFFFU);
+	sim.dma_pos = 0U;
+	sim.dma_out = 0U;
+	uint32_t half = sim.dma_size/2U;
+	sim.dma_evt = (uint64_t)(sim.dma_pos0/half + 1U) * half - sim.dma_pos0;
+	if (sim.dma_rate <= 0.0 || half == 0U || (sim.dma_size % sim.dma_hpf) != 0U) {
+		Fatal("DMA started with an invalid I2S or DMA configuration");
+		}
+	}
+
+// Pass the frames played since the last call to SIM_Output
+static void DMA_Output(DMA_Stream_TypeDef* s) {
+	const uint16_t* buf = (const uint16_t*)(uintptr_t)s->M0AR;
+	while (sim.dma_out + sim.dma_hpf <= sim.dma_pos) {
+		uint32_t hw = (uint32_t)((sim.dma_pos0 + sim.dma_out) % sim.dma_size);
+		if (sim.dma_hpf == 4U) {
+			// the first halfword of a 24 or 32bit channel is the most significant
+			SIM_Output((uint32_t)buf[hw] << 16 | buf[hw + 1U], (uint32_t)buf[hw + 2U] << 16 | buf[hw + 3U]);
+			}
+		else {
+			SIM_Output((uint32_t)buf[hw] << 16, (uint32_t)buf[hw + 1U] << 16);
+			}
+		sim.dma_out += sim.dma_hpf;
+		}
+	}
+
+// Bring the registers up to the current time
+static void Sync(void) {
+	uint64_t cyc = (uint64_t)(sim.now * SystemCoreClock * (1.0 + sim.hse_ppm * 1e-6));
+	DWT->CYCCNT = (uint32_t)cyc;
+	if (TIM2->CR1 & TIM_CR1_CEN) {
+		TIM2->CNT = (uint32_t)cyc;  // APB1 timer clock = core clock
+		}
+
+	// PLLI2S lock
+	uint8_t on = (RCC->CR & RCC_CR_PLLI2SON) != 0U;
+	if (on && !sim.pll_on) {
+		sim.pll_on_time = sim.now;
+		}
+	sim.pll_on = on;
+	if (on && sim.now >= sim.pll_on_time + sim.pll_lock) {
+		RCC->CR |= RCC_CR_PLLI2SRDY;
+		}
+	else {
+		RCC->CR &= ~RCC_CR_PLLI2SRDY;
+		}
+
+	// DMA stream 4, the circular reload value is NDTR when the stream is enabled
+	DMA_Stream_TypeDef* s = DMA1_Stream4;
+	uint8_t en = (s->CR & DMA_SxCR_EN) != 0U;
+	if (en && !sim.dma_en) {
+		sim.dma_size = s->NDTR & 0xFFFFU;
+		}
+	sim.dma_en = en;
+	uint8_t run = en && (SPI2->CR2 & SPI_CR2_TXDMAEN) && (SPI2->I2SCFGR & SPI_I2SCFGR_I2SE) &&
+	              (RCC->CR & RCC_CR_PLLI2SRDY);
+	if (run && !sim.dma_run) {
+		DMA_Start(s);
+		}
+	sim.dma_run = run;
+	if (run) {
+		sim.dma_pos = (uint64_t)((sim.now - sim.dma_t0) * sim.dma_rate);
+		s->NDTR = sim.dma_size - (uint32_t)((sim.dma_pos0 + sim.dma_pos) % sim.dma_size);
+		DMA_Output(s);
+		}
+	}
+
+double SIM_Now(void) {
+	return sim.now;
+	}
+
+uint32_t SIM_Frame(void) {
+	return sim.frame;
+	}
+
+// After a handler : the register changes take effect, then PendSV runs if it was pended
+void SIM_IsrExit(void) {
+	Sync();
+	if (sim.pendsv) {
+		return;
+		}
+	while (SCB->ICSR & SCB_ICSR_PENDSVSET_Msk) {
+		SCB->ICSR &= ~SCB_ICSR_PENDSVSET_Msk;
+		sim.pendsv = 1U;
+		USBD_AUDIO_ProcessPackets(&USBD_Device);
+		sim.pendsv = 0U;
+		Sync();
+		}
+	}
+
+// Advance to t, the DMA half and full transfer interrupts are handled on the way
+void SIM_RunUntil(double t) {
+	while (sim.dma_run) {
+		double t_evt = sim.dma_t0 + ((double)sim.dma_evt + 1e-6) / sim.dma_rate;
+		if (t_evt > t) {
+			break;
+			}
+		if (t_evt > sim.now) {
+			sim.now = t_evt;
+			}
+		Sync();
+		if (!sim.dma_run) {
+			break;
+			}
+		uint32_t half = sim.dma_size/2U;
+		uint8_t tc = (((sim.dma_pos0 + sim.dma_evt) % sim.dma_size) == 0U);
+		sim.dma_evt += half;
+		uint32_t cr = DMA1_Stream4->CR;
+		if (tc && (cr & DMA_SxCR_TCIE)) {
+			HAL_I2S_TxCpltCallback(&haudio_i2s);
+			}
+		else if (!tc && (cr & DMA_SxCR_HTIE)) {
+			HAL_I2S_TxHalfCpltCallback(&haudio_i2s);
+			}
+		SIM_IsrExit();
+		}
+	if (t > sim.now) {
+		sim.now = t;
+		}
+	Sync();
+	}
+
+// Start of frame : the frame number in DSTS, the TIM2 capture, then the OTG SOF interrupt
+void SIM_Sof(uint32_t frame) {
+	sim.frame = frame;
+	USB_OTG_DeviceTypeDef* dev = (USB_OTG_DeviceTypeDef*)((uint8_t*)SIM_OtgFs + USB_OTG_DEVICE_BASE);
+	dev->DSTS = (frame << USB_OTG_DSTS_FNSOF_Pos) & USB_OTG_DSTS_FNSOF;
+	if (TIM2->CR1 & TIM_CR1_CEN) {
+		TIM2->CCR1 = TIM2->CNT;
+		}
+	USBD_LL_SOF(&USBD_Device);
+	SIM_IsrExit();
+	}
+
+void SIM_Init(double hse_ppm, double pll_lock_us) {
+	memset(&sim, 0, sizeof(sim));
+	sim.hse_ppm = hse_ppm;
+	sim.pll_lock = pll_lock_us * 1e-6;
+	SystemCoreClock = SIM_CORE_HZ;
+	// SystemClock_Config : HSE / 25 into the main PLL, APB1 at half the core clock
+	RCC->PLLCFGR = SIM_PLLM << RCC_PLLCFGR_PLLM_Pos;
+	RCC->CFGR = RCC_CFGR_PPRE1_DIV2;
+	SPI2->SR = SPI_SR_TXE;
+	}
+
+
+/* HAL -----------------------------------------------------------------------*/
+
+// Only the busy waits in bsp_audio.c call it, each call takes 1us
+uint32_t HAL_GetTick(void) {
+	sim.now += 1e-6;
+	Sync();
+	return (uint32_t)(sim.now * 1000.0);
+	}
+
+uint32_t HAL_RCC_GetPCLK1Freq(void) {
+	return SystemCoreClock / 2U;
+	}
+
+void HAL_RCCEx_GetPeriphCLKConfig(RCC_PeriphCLKInitTypeDef* PeriphClkInit) {
+	memset(PeriphClkInit, 0, sizeof(*PeriphClkInit));
+	PeriphClkInit->PeriphClockSelection = RCC_PERIPHCLK_I2S;
+	}
+
+// As the HAL : stop PLLI2S, configure it and wait for the lock
+HAL_StatusTypeDef HAL_RCCEx_PeriphCLKConfig(RCC_PeriphCLKInitTypeDef* PeriphClkInit) {
+	__HAL_RCC_PLLI2S_DISABLE();
+	while (RCC->CR & RCC_CR_PLLI2SRDY) {
+		HAL_GetTick();
+		}
+	uint32_t cfg = (PeriphClkInit->PLLI2S.PLLI2SN << RCC_PLLI2SCFGR_PLLI2SN_Pos) |
+	               (PeriphClkInit->PLLI2S.PLLI2SR << RCC_PLLI2SCFGR_PLLI2SR_Pos);
+#ifdef STM32F411xE
+	cfg |= PeriphClkInit->PLLI2S.PLLI2SM << RCC_PLLI2SCFGR_PLLI2SM_Pos;
+#endif
+	RCC->PLLI2SCFGR = cfg;
+	__HAL_RCC_PLLI2S_ENABLE();
+	while (!(RCC->CR & RCC_CR_PLLI2SRDY)) {
+		HAL_GetTick();
+		}
+	return HAL_OK;
+	}
+
+// The prescaler is left as BSP_AUDIO_OUT_ClockConfig set it from the clock table
+HAL_StatusTypeDef HAL_I2S_Init(I2S_HandleTypeDef* hi2s) {
+	hi2s->Instance->I2SCFGR = SPI_I2SCFGR_I2SMOD | hi2s->Init.Mode | hi2s->Init.Standard |
+	                          hi2s->Init.DataFormat | hi2s->Init.CPOL;
+	hi2s->State = HAL_I2S_STATE_READY;
+	return HAL_OK;
+	}
+
+HAL_StatusTypeDef HAL_I2S_DeInit(I2S_HandleTypeDef* hi2s) {
+	CLEAR_BIT(hi2s->Instance->I2SCFGR, SPI_I2SCFGR_I2SE);
+	hi2s->State = HAL_I2S_STATE_RESET;
+	return HAL_OK;
+	}
+
+HAL_I2S_StateTypeDef HAL_I2S_GetState(I2S_HandleTypeDef* hi2s) {
+	return hi2s->State;
+	}
+
+// As the HAL : Size is in data units, 2 halfwords each for 24 and 32bit data
+HAL_StatusTypeDef HAL_I2S_Transmit_DMA(I2S_HandleTypeDef* hi2s, uint16_t* pData, uint16_t Size) {
+	if (pData == NULL || Size == 0U) {
+		return HAL_ERROR;
+		}
+	if (hi2s->State != HAL_I2S_STATE_READY) {
+		return HAL_BUSY;
+		}
+	hi2s->State = HAL_I2S_STATE_BUSY_TX;
+	uint32_t fmt = hi2s->Instance->I2SCFGR & (SPI_I2SCFGR_DATLEN | SPI_I2SCFGR_CHLEN);
+	uint32_t ndtr = (fmt == I2S_DATAFORMAT_24B || fmt == I2S_DATAFORMAT_32B) ? 2U * Size : Size;
+	DMA_Stream_TypeDef* s = hi2s->hdmatx->Instance;
+	s->CR &= ~DMA_SxCR_EN;
+	s->NDTR = ndtr;
+	s->PAR = Addr32(&hi2s->Instance->DR);
+	s->M0AR = Addr32(pData);
+	s->CR = hi2s->hdmatx->Init.Channel | hi2s->hdmatx->Init.Direction | hi2s->hdmatx->Init.MemInc |
+	        hi2s->hdmatx->Init.PeriphDataAlignment | hi2s->hdmatx->Init.MemDataAlignment | hi2s->hdmatx->Init.Mode |
+	        DMA_IT_TC | DMA_IT_HT | DMA_IT_TE | DMA_IT_DME | DMA_SxCR_EN;
+	SET_BIT(hi2s->Instance->I2SCFGR, SPI_I2SCFGR_I2SE);
+	SET_BIT(hi2s->Instance->CR2, SPI_CR2_TXDMAEN);
+	return HAL_OK;
+	}
+
+HAL_StatusTypeDef HAL_I2S_DMAStop(I2S_HandleTypeDef* hi2s) {
+	CLEAR_BIT(hi2s->Instance->CR2, SPI_CR2_TXDMAEN);
+	CLEAR_BIT(hi2s->hdmatx->Instance->CR, DMA_SxCR_EN);
+	CLEAR_BIT(hi2s->Instance->I2SCFGR, SPI_I2SCFGR_I2SE);
+	hi2s->State = HAL_I2S_STATE_READY;
+	return HAL_OK;
+	}
+
+HAL_StatusTypeDef HAL_I2S_DMAPause(I2S_HandleTypeDef* hi2s) {
+	CLEAR_BIT(hi2s->Instance->CR2, SPI_CR2_TXDMAEN);
+	return HAL_OK;
+	}
+
+HAL_StatusTypeDef HAL_I2S_DMAResume(I2S_HandleTypeDef* hi2s) {
+	SET_BIT(hi2s->Instance->CR2, SPI_CR2_TXDMAEN);
+	SET_BIT(hi2s->Instance->I2SCFGR, SPI_I2SCFGR_I2SE);
+	return HAL_OK;
+	}
+
+HAL_StatusTypeDef HAL_DMA_Init(DMA_HandleTypeDef* hdma) {
+	hdma->State = HAL_DMA_STATE_READY;
+	return HAL_OK;
+	}
+
+HAL_StatusTypeDef HAL_DMA_DeInit(DMA_HandleTypeDef* hdma) {
+	hdma->State = HAL_DMA_STATE_RESET;
+	return HAL_OK;
+	}
+
+void HAL_GPIO_Init(GPIO_TypeDef* GPIOx, GPIO_InitTypeDef* GPIO_Init) {
+	(void)GPIOx;
+	(void)GPIO_Init;
+	}
+
+void HAL_GPIO_DeInit(GPIO_TypeDef* GPIOx, uint32_t GPIO_Pin) {
+	(void)GPIOx;
+	(void)GPIO_Pin;
+	}
+
+GPIO_PinState HAL_GPIO_ReadPin(GPIO_TypeDef* GPIOx, uint16_t GPIO_Pin) {
+	return (GPIOx->IDR & GPIO_Pin) ? GPIO_PIN_SET : GPIO_PIN_RESET;
+	}
+
+void HAL_GPIO_WritePin(GPIO_TypeDef* GPIOx, uint16_t GPIO_Pin, GPIO_PinState PinState) {
+	if (PinState == GPIO_PIN_SET) {
+		GPIOx->ODR |= GPIO_Pin;
+		}
+	else {
+		GPIOx->ODR &= ~(uint32_t)GPIO_Pin;
+		}
+	}
+
+void HAL_GPIO_TogglePin(GPIO_TypeDef* GPIOx, uint16_t GPIO_Pin) {
+	GPIOx->ODR ^= GPIO_Pin;
+	}
+
+void HAL_NVIC_SetPriority(IRQn_Type IRQn, uint32_t PreemptPriority, uint32_t SubPriority) {
+	(void)IRQn;
+	(void)PreemptPriority;
+	(void)SubPriority;
+	}
+
+void HAL_NVIC_EnableIRQ(IRQn_Type IRQn) {
+	(void)IRQn;
+	}
+
+
+/* PCD -----------------------------------------------------------------------*/
+
+USBD_StatusTypeDef USBD_LL_Init(USBD_HandleTypeDef* pdev) {
+	(void)pdev;
+	memset(SIM_EpIn, 0, sizeof(SIM_EpIn));
+	memset(SIM_EpOut, 0, sizeof(SIM_EpOut));
+	return USBD_OK;
+	}
+
+USBD_StatusTypeDef USBD_LL_DeInit(USBD_HandleTypeDef* pdev) {
+	(void)pdev;
+	return USBD_OK;
+	}
+
+USBD_StatusTypeDef USBD_LL_Start(USBD_HandleTypeDef* pdev) {
+	(void)pdev;
+	return USBD_OK;
+	}
+
+USBD_StatusTypeDef USBD_LL_Stop(USBD_HandleTypeDef* pdev) {
+	(void)pdev;
+	return USBD_OK;
+	}
+
+static SIM_EpTypeDef* Ep(uint8_t ep_addr) {
+	if ((ep_addr & 0x0FU) >= SIM_EP_NUM) {
+		Fatal("endpoint number out of range");
+		}
+	return (ep_addr & 0x80U) ? &SIM_EpIn[ep_addr & 0x0FU] : &SIM_EpOut[ep_addr & 0x0FU];
+	}
+
+USBD_StatusTypeDef USBD_LL_OpenEP(USBD_HandleTypeDef* pdev, uint8_t ep_addr, uint8_t ep_type, uint16_t ep_mps) {
+	(void)pdev;
+	(void)ep_mps;
+	SIM_EpTypeDef* ep = Ep(ep_addr);
+	ep->open = 1U;
+	ep->type = ep_type;
+	ep->rx_armed = 0U;
+	ep->tx_armed = 0U;
+	return USBD_OK;
+	}
+
+USBD_StatusTypeDef USBD_LL_CloseEP(USBD_HandleTypeDef* pdev, uint8_t ep_addr) {
+	(void)pdev;
+	SIM_EpTypeDef* ep = Ep(ep_addr);
+	ep->open = 0U;
+	ep->rx_armed = 0U;
+	ep->tx_armed = 0U;
+	return USBD_OK;
+	}
+
+// Flushing an IN endpoint drops the armed packet, the RX FIFO flush does not disarm OUT endpoints
+USBD_StatusTypeDef USBD_LL_FlushEP(USBD_HandleTypeDef* pdev, uint8_t ep_addr) {
+	(void)pdev;
+	if (ep_addr & 0x80U) {
+		Ep(ep_addr)->tx_armed = 0U;
+		}
+	return USBD_OK;
+	}
+
+// The control transfers of the host model only look at the armed endpoints
+USBD_StatusTypeDef USBD_LL_StallEP(USBD_HandleTypeDef* pdev, uint8_t ep_addr) {
+	(void)pdev;
+	(void)ep_addr;
+	return USBD_OK;
+	}
+
+USBD_StatusTypeDef USBD_LL_ClearStallEP(USBD_HandleTypeDef* pdev, uint8_t ep_addr) {
+	(void)pdev;
+	(void)ep_addr;
+	return USBD_OK;
+	}
+
+uint8_t USBD_LL_IsStallEP(USBD_HandleTypeDef* pdev, uint8_t ep_addr) {
+	(void)pdev;
+	(void)ep_addr;
+	return 0U;
+	}
+
+USBD_StatusTypeDef USBD_LL_SetUSBAddress(USBD_HandleTypeDef* pdev, uint8_t dev_addr) {
+	(void)pdev;
+	(void)dev_addr;
+	return USBD_OK;
+	}
+
+// An isochronous IN packet armed in frame F is sent in frame F+1, as the HAL sets the odd / even frame
+USBD_StatusTypeDef USBD_LL_Transmit(USBD_HandleTypeDef* pdev, uint8_t ep_addr, uint8_t* pbuf, uint16_t size) {
+	(void)pdev;
+	SIM_EpTypeDef* ep = Ep(ep_addr | 0x80U);
+	if (size > SIM_EP_BUF) {
+		Fatal("IN transfer too long");
+		}
+	if (size) {
+		memcpy(ep->tx_data, pbuf, size);
+		}
+	ep->tx_len = size;
+	ep->tx_frame = sim.frame + 1U;
+	ep->tx_armed = 1U;
+	return USBD_OK;
+	}
+
+USBD_StatusTypeDef USBD_LL_PrepareReceive(USBD_HandleTypeDef* pdev, uint8_t ep_addr, uint8_t* pbuf, uint16_t size) {
+	(void)pdev;
+	SIM_EpTypeDef* ep = Ep(ep_addr & 0x7FU);
+	ep->rx_buf = pbuf;
+	ep->rx_size = size;
+	ep->rx_count = 0U;
+	ep->rx_armed = 1U;
+	return USBD_OK;
+	}
+
+uint32_t USBD_LL_GetRxDataSize(USBD_HandleTypeDef* pdev, uint8_t ep_addr) {
+	(void)pdev;
+	return Ep(ep_addr & 0x7FU)->rx_count;
+	}
+
+void USBD_LL_Delay(uint32_t Delay) {
+	(void)Delay;
+	}
@@ -0,0 +1,48 @@
+/**
+  ******************************************************************************
+  * @file    sim_hal.h
+  * @brief   Host simulation : fake HAL, PCD and peripheral models, see sim_hal.c
+  ******************************************************************************
+  */
+
+#ifndef __SIM_HAL_H
+#define __SIM_HAL_H
+
+#include "usbd_audio.h"
+
+#define SIM_EP_NUM          4U
+#define SIM_EP_BUF          512U
+
+// Endpoint state of the fake PCD, written by the USBD_LL_xxx functions and read by the host model
+typedef struct {
+  uint8_t   open;
+  uint8_t   type;            // USBD_EP_TYPE_xxx
+  // OUT : armed by USBD_LL_PrepareReceive
+  uint8_t   rx_armed;
+  uint8_t*  rx_buf;
+  uint32_t  rx_size;
+  uint32_t  rx_count;        // USBD_LL_GetRxDataSize
+  // IN : armed by USBD_LL_Transmit
+  uint8_t   tx_armed;
+  uint32_t  tx_frame;        // isochronous : frame the packet is sent in
+  uint32_t  tx_len;
+  uint8_t   tx_data[SIM_EP_BUF];
+} SIM_EpTypeDef;
+
+extern SIM_EpTypeDef SIM_EpIn[SIM_EP_NUM];
+extern SIM_EpTypeDef SIM_EpOut[SIM_EP_NUM];
+extern USBD_HandleTypeDef USBD_Device;
+
+// Output of the I2S model, one call per stereo frame played, the samples left aligned in 32 bits
+extern void SIM_Output(uint32_t left, uint32_t right);
+
+void     SIM_Init(double hse_ppm, double pll_lock_us);
+void     SIM_RunUntil(double t);
+double   SIM_Now(void);
+void     SIM_Sof(uint32_t frame);
+void     SIM_IsrExit(void);
+uint32_t SIM_Frame(void);
+double   SIM_I2SFs(void);
+uint32_t SIM_I2SRunning(void);
+
+#endif /* __SIM_HAL_H */
@@ -0,0 +1,79 @@
+/**
+  ******************************************************************************
+  * @file    stm32f4xx_hal_conf.h
+  * @brief   Host simulation : the HAL configuration with the peripherals in host memory
+  ******************************************************************************
+  *
+  * tools/sim is first in the include path, so stm32f4xx_hal.h includes this file instead of
+  * src/stm32f4xx_hal_conf.h. It includes the real configuration, and with it the device header and
+  * all the HAL module headers, then points the peripherals used by the simulated sources at the
+  * register blocks in sim_hal.c, and replaces the Cortex-M intrinsics and bit-band macros that have
+  * no host equivalent.
+  * The firmware reads and writes the registers as on the target, sim_hal.c updates them from the
+  * simulated time.
+  */
+
+#ifndef __SIM_STM32F4XX_HAL_CONF_H
+#define __SIM_STM32F4XX_HAL_CONF_H
+
+#include "../../src/stm32f4xx_hal_conf.h"
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+// register blocks, see sim_hal.c
+extern uint32_t        SIM_OtgFs[0x1000U/4U];  // USB_OTG_FS global and device registers
+extern uint32_t        SIM_Dma1[0x100U/4U];    // DMA1 interrupt flags and streams 0..7
+extern SPI_TypeDef     SIM_Spi2;
+extern RCC_TypeDef     SIM_Rcc;
+extern TIM_TypeDef     SIM_Tim2;
+extern GPIO_TypeDef    SIM_GpioA, SIM_GpioB, SIM_GpioC;
+extern SCB_Type        SIM_Scb;
+extern DWT_Type        SIM_Dwt;
+extern CoreDebug_Type  SIM_CoreDebug;
+
+#undef  USB_OTG_FS
+#define USB_OTG_FS      ((USB_OTG_GlobalTypeDef*)SIM_OtgFs)
+#undef  DMA1
+#define DMA1            ((DMA_TypeDef*)SIM_Dma1)
+#undef  DMA1_Stream4
+#define DMA1_Stream4    ((DMA_Stream_TypeDef*)((uint8_t*)SIM_Dma1 + 0x70U))
+#undef  SPI2
+#define SPI2            (&SIM_Spi2)
+#undef  RCC
+#define RCC             (&SIM_Rcc)
+#undef  TIM2
+#define TIM2            (&SIM_Tim2)
+#undef  GPIOA
+#define GPIOA           (&SIM_GpioA)
+#undef  GPIOB
+#define GPIOB           (&SIM_GpioB)
+#undef  GPIOC
+#define GPIOC           (&SIM_GpioC)
+#undef  SCB
+#define SCB             (&SIM_Scb)
+#undef  DWT
+#define DWT             (&SIM_Dwt)
+#undef  CoreDebug
+#define CoreDebug       (&SIM_CoreDebug)
+
+// A simulated handler only preempts PendSV in the conversion kernel, outside the critical sections
+#define __DMB()         __sync_synchronize()
+#define __disable_irq() ((void)0)
+#define __enable_irq()  ((void)0)
+#define __LDREXW(p)     (*(p))
+#define __STREXW(v, p)  (*(p) = (v), 0U)
+#define __CLREX()       ((void)0)
+
+// PLLI2SON is written through the bit-band alias on the target
+#undef  __HAL_RCC_PLLI2S_ENABLE
+#define __HAL_RCC_PLLI2S_ENABLE()   SET_BIT(RCC->CR, RCC_CR_PLLI2SON)
+#undef  __HAL_RCC_PLLI2S_DISABLE
+#define __HAL_RCC_PLLI2S_DISABLE()  CLEAR_BIT(RCC->CR, RCC_CR_PLLI2SON)
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __SIM_STM32F4XX_HAL_CONF_H */
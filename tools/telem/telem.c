@@ -0,0 +1,279 @@
+/**
+  ******************************************************************************
+  * @file    telem.c
+  * @brief   Host tool : read the telemetry interface (usbd_audio_telem.h) to a CSV file
+  ******************************************************************************
+  *
+  * Build and run on a Linux host, see tools/telem/Makefile :
+  *   make                        build the tool and run the self test
+  *   ./telem capture.csv         read until Ctrl-C
+  *   ./telem -n 10000 capture.csv
+  *
+  * The firmware must be built with USE_TELEMETRY. The device is found in /sys/bus/usb/devices by
+  * its vendor and product id and read with the usbfs ioctls, no libusb needed. The telemetry
+  * interface is claimed by the tool, the audio interfaces stay with the kernel audio driver so the
+  * stream can play at the same time. /dev/bus/usb needs write permission, run as root or add a
+  * udev rule for the device.
+  *
+  * One CSV line per record. The fill level and read position are in ring buffer words, the
+  * feedback value in Hz, the cycle counts in DWT cycles. Records lost because the ring on the
+  * device was full are reported from the gaps in seq.
+  */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <signal.h>
+#include <dirent.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <linux/usbdevice_fs.h>
+
+#define AUDIO_TELEM_HOST
+#include "usbd_audio_telem.h"
+
+// see src/usbd_desc.c
+#define USBD_VID        0x6666
+#define USBD_PID        0x1234
+
+#define RECORD_SIZE     32U
+#define READ_SIZE       (AUDIO_TELEM_BURST * RECORD_SIZE)
+#define READ_TIMEOUT    1000U // ms
+
+_Static_assert(sizeof(AUDIO_TelemRecordTypeDef) == RECORD_SIZE, "record layout");
+
+typedef struct {
+	uint32_t records;
+	uint32_t lost;
+	uint32_t resync_bytes;
+	int      have_seq;
+	uint16_t last_seq;
+	uint8_t  buf[2U * READ_SIZE];
+	uint32_t len;
+	} DECODER;
+
+static volatile sig_atomic_t stop = 0;
+
+static void on_signal(int sig) {
+	(void)sig;
+	stop = 1;
+	}
+
+static uint16_t get16(const uint8_t* p) {
+	return (uint16_t)(p[0] | p[1] << 8);
+	}
+
+static uint32_t get32(const uint8_t* p) {
+	return p[0] | p[1] << 8 | p[2] << 16 | (uint32_t)p[3] << 24;
+	}
+
+static void print_header(FILE* out) {
+	fprintf(out, "seq,frame,playing,rd,xrun,fb,alt,freq,writable,rd_pos,feedback_hz,isr_cycles,conv_cycles,iso_incomplete,xruns\n");
+	}
+
+// fields are read byte by byte, the host need not be little-endian
+static void print_record(DECODER* d, FILE* out, const uint8_t* p) {
+	AUDIO_TelemRecordTypeDef r;
+	r.seq            = get16(&p[offsetof(AUDIO_TelemRecordTypeDef, seq)]);
+	r.frame          = get16(&p[offsetof(AUDIO_TelemRecordTypeDef, frame)]);
+	r.flags          = p[offsetof(AUDIO_TelemRecordTypeDef, flags)];
+	r.alt            = p[offsetof(AUDIO_TelemRecordTypeDef, alt)];
+	r.freq           = get32(&p[offsetof(AUDIO_TelemRecordTypeDef, freq)]);
+	r.writable_q8    = get32(&p[offsetof(AUDIO_TelemRecordTypeDef, writable_q8)]);
+	r.rd_q8          = get32(&p[offsetof(AUDIO_TelemRecordTypeDef, rd_q8)]);
+	r.feedback       = get32(&p[offsetof(AUDIO_TelemRecordTypeDef, feedback)]);
+	r.isr_cycles     = get32(&p[offsetof(AUDIO_TelemRecordTypeDef, isr_cycles)]);
+	r.conv_cycles    = get16(&p[offsetof(AUDIO_TelemRecordTypeDef, conv_cycles)]);
+	r.iso_incomplete = p[offsetof(AUDIO_TelemRecordTypeDef, iso_incomplete)];
+	r.xruns          = p[offsetof(AUDIO_TelemRecordTypeDef, xruns)];
+
+	if (d->have_seq) {
+		d->lost += (uint16_t)(r.seq - d->last_seq - 1U);
+		}
+	d->have_seq = 1;
+	d->last_seq = r.seq;
+	d->records++;
+
+	fprintf(out, "%u,%u,%u,%u,%u,%u,%u,%u,%.3f,%.3f,%.3f,%u,%u,%u,%u\n",
+		r.seq, r.frame,
+		!!(r.flags & AUDIO_TELEM_FLAG_PLAYING), !!(r.flags & AUDIO_TELEM_FLAG_RD),
+		!!(r.flags & AUDIO_TELEM_FLAG_XRUN), !!(r.flags & AUDIO_TELEM_FLAG_FB),
+		r.alt, r.freq, r.writable_q8 / 256.0, r.rd_q8 / 256.0,
+		r.feedback * 1000.0 / (1U << 22), r.isr_cycles, r.conv_cycles * 16U,
+		r.iso_incomplete, r.xruns);
+	}
+
+// Transfers hold whole records, the magic check only matters for a corrupted stream
+static void decode(DECODER* d, FILE* out, const uint8_t* data, uint32_t n) {
+	while (n) {
+		uint32_t copy = sizeof(d->buf) - d->len;
+		if (copy > n) copy = n;
+		memcpy(&d->buf[d->len], data, copy);
+		d->len += copy;
+		data += copy;
+		n -= copy;
+
+		uint32_t pos = 0;
+		while (d->len - pos >= RECORD_SIZE) {
+			if (get16(&d->buf[pos]) != AUDIO_TELEM_MAGIC) {
+				pos++;
+				d->resync_bytes++;
+				continue;
+				}
+			print_record(d, out, &d->buf[pos]);
+			pos += RECORD_SIZE;
+			}
+		memmove(d->buf, &d->buf[pos], d->len - pos);
+		d->len -= pos;
+		}
+	}
+
+// /dev/bus/usb path of the first device with our ids
+static int find_device(char* path, size_t size) {
+	DIR* dir = opendir("/sys/bus/usb/devices");
+	if (dir == NULL) return -1;
+	struct dirent* e;
+	int found = -1;
+	while (found != 0 && (e = readdir(dir)) != NULL) {
+		char name[512];
+		unsigned vid = 0, pid = 0, bus = 0, dev = 0;
+		const char* attr[4] = { "idVendor", "idProduct", "busnum", "devnum" };
+		unsigned* val[4] = { &vid, &pid, &bus, &dev };
+		const char* fmt[4] = { "%x", "%x", "%u", "%u" };
+		int ok = 1;
+		for (int i = 0; i < 4 && ok; i++) {
+			snprintf(name, sizeof(name), "/sys/bus/usb/devices/%s/%s", e->d_name, attr[i]);
+			FILE* f = fopen(name, "r");
+			ok = (f != NULL && fscanf(f, fmt[i], val[i]) == 1);
+			if (f) fclose(f);
+			}
+		if (ok && vid == USBD_VID && pid == USBD_PID) {
+			snprintf(path, size, "/dev/bus/usb/%03u/%03u", bus, dev);
+			found = 0;
+			}
+		}
+	closedir(dir);
+	return found;
+	}
+
+static int capture(FILE* out, uint32_t max_records) {
+	char path[64];
+	if (find_device(path, sizeof(path)) != 0) {
+		fprintf(stderr, "device %04x:%04x not found\n", USBD_VID, USBD_PID);
+		return 1;
+		}
+	int fd = open(path, O_RDWR);
+	if (fd < 0) {
+		fprintf(stderr, "cannot open %s : %s\n", path, strerror(errno));
+		return 1;
+		}
+	unsigned int itf = AUDIO_TELEM_ITF;
+	if (ioctl(fd, USBDEVFS_CLAIMINTERFACE, &itf) < 0) {
+		fprintf(stderr, "cannot claim interface %u : %s, firmware built without USE_TELEMETRY ?\n",
+			itf, strerror(errno));
+		close(fd);
+		return 1;
+		}
+
+	signal(SIGINT, on_signal);
+	signal(SIGTERM, on_signal);
+
+	static DECODER d;
+	uint8_t data[READ_SIZE];
+	int ret = 0;
+	print_header(out);
+	while (!stop && (max_records == 0U || d.records < max_records)) {
+		struct usbdevfs_bulktransfer bt = {
+			.ep = AUDIO_TELEM_EP,
+			.len = sizeof(data),
+			.timeout = READ_TIMEOUT,
+			.data = data,
+			};
+		int n = ioctl(fd, USBDEVFS_BULK, &bt);
+		if (n < 0) {
+			if (errno == ETIMEDOUT || errno == EINTR) continue;
+			fprintf(stderr, "read failed : %s\n", strerror(errno));
+			ret = 1;
+			break;
+			}
+		decode(&d, out, data, (uint32_t)n);
+		}
+
+	ioctl(fd, USBDEVFS_RELEASEINTERFACE, &itf);
+	close(fd);
+	fprintf(stderr, "%u records, %u lost, %u bytes skipped\n", d.records, d.lost, d.resync_bytes);
+	return ret;
+	}
+
+
+static void put_record(uint8_t* p, uint16_t seq, uint8_t flags, uint32_t writable_q8, uint32_t feedback) {
+	memset(p, 0, RECORD_SIZE);
+	p[0] = AUDIO_TELEM_MAGIC & 0xFF;
+	p[1] = AUDIO_TELEM_MAGIC >> 8;
+	p[2] = (uint8_t)seq;
+	p[3] = (uint8_t)(seq >> 8);
+	p[6] = flags;
+	p[7] = 1;                                     // alt
+	p[8] = 0x80; p[9] = 0xBB;                     // 48000
+	for (int b = 0; b < 4; b++) {
+		p[12 + b] = (uint8_t)(writable_q8 >> (8 * b));
+		p[20 + b] = (uint8_t)(feedback >> (8 * b));
+		}
+	p[28] = 10;                                   // conv_cycles / 16
+	}
+
+// Three records with a gap in seq and a wrap, split over two reads, with garbage in front
+static int self_test(void) {
+	static const char expect[] =
+		"65534,0,1,1,0,1,1,48000,96.500,0.000,48000.000,0,160,0,0\n"
+		"65535,0,1,1,0,1,1,48000,96.500,0.000,48000.000,0,160,0,0\n"
+		"2,0,1,1,0,1,1,48000,96.500,0.000,48000.000,0,160,0,0\n";
+	uint8_t stream[3 + 3 * RECORD_SIZE];
+	stream[0] = 0x41; stream[1] = 0x00; stream[2] = 0x41;
+	for (uint16_t i = 0; i < 3; i++) {
+		put_record(&stream[3 + i * RECORD_SIZE], (uint16_t)(i < 2 ? 65534U + i : 2U),
+			AUDIO_TELEM_FLAG_PLAYING | AUDIO_TELEM_FLAG_RD | AUDIO_TELEM_FLAG_FB,
+			96U * 256U + 128U, 48U << 22);
+		}
+
+	static DECODER d;
+	char text[512] = {0};
+	FILE* out = fmemopen(text, sizeof(text) - 1, "w");
+	decode(&d, out, stream, 40);
+	decode(&d, out, &stream[40], sizeof(stream) - 40);
+	fclose(out);
+	if (strcmp(text, expect) != 0 || d.records != 3U || d.lost != 2U || d.resync_bytes != 3U) {
+		fprintf(stderr, "self test failed, %u records %u lost :\n%s", d.records, d.lost, text);
+		return 1;
+		}
+	printf("self test ok\n");
+	return 0;
+	}
+
+int main(int argc, char* argv[]) {
+	if (argc == 2 && strcmp(argv[1], "-t") == 0) {
+		return self_test();
+		}
+	uint32_t max_records = 0;
+	int arg = 1;
+	if (argc == 4 && strcmp(argv[1], "-n") == 0) {
+		max_records = (uint32_t)strtoul(argv[2], NULL, 0);
+		arg = 3;
+		}
+	if (arg != argc - 1) {
+		fprintf(stderr, "usage : telem [-n records] capture.csv\n        telem -t\n");
+		return 1;
+		}
+	FILE* out = fopen(argv[arg], "w");
+	if (out == NULL) {
+		fprintf(stderr, "cannot open %s\n", argv[arg]);
+		return 1;
+		}
+	int ret = capture(out, max_records);
+	fclose(out);
+	return ret;
+	}